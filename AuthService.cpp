@@ -0,0 +1,213 @@
+#include "AuthService.h"
+#include "SQLiteDatabase.h"
+#include "picosha2.h"
+#include <cstdio>
+#include <exception>
+#include <random>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t MicrosBetween(Clock::time_point from, Clock::time_point to) {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+    }
+
+    std::string GenerateSalt(int length = 16) {
+        const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!@#$%^&*";
+
+        // One generator per worker thread, seeded once
+        thread_local std::default_random_engine rng(std::random_device{}());
+        std::uniform_int_distribution<> dist(0, sizeof(charset) - 2);
+
+        std::string salt;
+        for (int i = 0; i < length; ++i) {
+            salt += charset[dist(rng)];
+        }
+        return salt;
+    }
+}
+
+AuthService::AuthService(std::string databasePath) : databasePath(std::move(databasePath)) {
+}
+
+AuthService::~AuthService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void AuthService::Start(int workerCount) {
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back([this]() { WorkerLoop(); });
+    }
+    printf("[Auth] %d worker(s) on %s\n", workerCount, databasePath.c_str());
+}
+
+uint64_t AuthService::Submit(AuthRequestKind kind, SessionID session, std::string name, std::string password) {
+    AuthRequest request;
+    request.kind = kind;
+    request.session = session;
+    request.name = std::move(name);
+    request.password = std::move(password);
+    request.submitted = Clock::now();
+
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ticket = nextTicket++;
+        request.ticket = ticket;
+        pending.push_back(std::move(request));
+    }
+    wakeWorkers.notify_one();
+    return ticket;
+}
+
+void AuthService::TakeResults(std::vector<AuthResult>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (completed.empty()) return;
+    for (AuthResult& result : completed) {
+        out.push_back(std::move(result));
+    }
+    completed.clear();
+}
+
+void AuthService::RecordApplied(const AuthResult& result, bool delivered) {
+    uint64_t micros = MicrosBetween(result.submitted, Clock::now());
+    std::lock_guard<std::mutex> lock(mutex);
+    KindStats& kind = stats[static_cast<size_t>(result.kind)];
+    kind.total.Record(micros);
+    if (!delivered) kind.dropped++;
+}
+
+void AuthService::WorkerLoop() {
+    // SQLite connections must not be shared between threads that run
+    // statements at the same time, so each worker opens its own.
+    SQLiteDatabase db;
+    if (!db.Connect(databasePath)) {
+        printf("[Auth] worker could not open %s\n", databasePath.c_str());
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorkers.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (stopping) return;
+
+        AuthRequest request = std::move(pending.front());
+        pending.pop_front();
+        running++;
+        lock.unlock();
+
+        Clock::time_point started = Clock::now();
+        AuthResult result;
+        result.kind = request.kind;
+        result.session = request.session;
+        result.ticket = request.ticket;
+        result.submitted = request.submitted;
+        try {
+            Execute(db, request, result);
+        }
+        catch (const std::exception& e) {
+            // e.g. a stats blob that no longer parses; don't take the worker down
+            printf("[Auth] %s for '%s' failed: %s\n", KindName(request.kind), request.name.c_str(), e.what());
+            result.status = AuthStatus::Failed;
+        }
+        Clock::time_point finished = Clock::now();
+
+        lock.lock();
+        KindStats& kind = stats[static_cast<size_t>(request.kind)];
+        kind.queueWait.Record(MicrosBetween(request.submitted, started));
+        kind.work.Record(MicrosBetween(started, finished));
+        completed.push_back(std::move(result));
+        running--;
+        if (running == 0 && pending.empty()) workersIdle.notify_all();
+    }
+}
+
+void AuthService::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Without workers nothing would ever finish
+    if (workers.empty()) return;
+    workersIdle.wait(lock, [this]() { return running == 0 && pending.empty(); });
+}
+
+void AuthService::Execute(SQLiteDatabase& db, const AuthRequest& request, AuthResult& result) {
+    switch (request.kind) {
+    case AuthRequestKind::NameExists:
+        result.status = db.PlayerExists(request.name) ? AuthStatus::Ok : AuthStatus::NotFound;
+        break;
+
+    case AuthRequestKind::Login:
+    case AuthRequestKind::VerifyPassword:
+        if (!db.PlayerExists(request.name)) {
+            result.status = AuthStatus::NotFound;
+        }
+        else if (!db.VerifyPassword(request.name, request.password)) {
+            result.status = AuthStatus::BadPassword;
+        }
+        else if (request.kind == AuthRequestKind::Login && !db.LoadPlayer(request.name, result.player)) {
+            result.status = AuthStatus::Failed;
+        }
+        else {
+            result.status = AuthStatus::Ok;
+        }
+        break;
+
+    case AuthRequestKind::CreateAccount: {
+        std::string salt = GenerateSalt();
+        std::string hash = picosha2::hash256_hex_string(request.password + salt);
+        result.status = db.CreatePlayerRow(request.name, hash, salt) != -1 ? AuthStatus::Ok : AuthStatus::Failed;
+        break;
+    }
+
+    case AuthRequestKind::ChangePassword: {
+        std::string salt = GenerateSalt();
+        std::string hash = picosha2::hash256_hex_string(request.password + salt);
+        result.status = db.UpdatePassword(request.name, hash, salt) ? AuthStatus::Ok : AuthStatus::Failed;
+        break;
+    }
+
+    default:
+        result.status = AuthStatus::Failed;
+        break;
+    }
+}
+
+void AuthService::LogStatsIfDue() {
+    Clock::time_point now = Clock::now();
+    if (now < nextStatsLog) return;
+    nextStatsLog = now + std::chrono::seconds(60);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < static_cast<size_t>(AuthRequestKind::Count); i++) {
+        KindStats& kind = stats[i];
+        if (kind.total.Count() == 0) continue;
+
+        // Percentiles for the last minute, in milliseconds
+        printf("[Auth] %s: %llu done, total p50 %.1f p99 %.1f max %.1f ms, queue p99 %.1f ms, work p50 %.1f p99 %.1f ms, %llu for closed sessions\n",
+            KindName(static_cast<AuthRequestKind>(i)), (unsigned long long)kind.total.Count(),
+            kind.total.Percentile(50) / 1000.0, kind.total.Percentile(99) / 1000.0, kind.total.MaxMicros() / 1000.0,
+            kind.queueWait.Percentile(99) / 1000.0,
+            kind.work.Percentile(50) / 1000.0, kind.work.Percentile(99) / 1000.0,
+            (unsigned long long)kind.dropped);
+        kind = KindStats();
+    }
+    if (!pending.empty()) {
+        printf("[Auth] %zu request(s) still queued\n", pending.size());
+    }
+}
+
+const char* AuthService::KindName(AuthRequestKind kind) {
+    switch (kind) {
+    case AuthRequestKind::NameExists: return "name check";
+    case AuthRequestKind::Login: return "login";
+    case AuthRequestKind::VerifyPassword: return "verify";
+    case AuthRequestKind::CreateAccount: return "create";
+    case AuthRequestKind::ChangePassword: return "password change";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "LatencyHistogram.h"
+#include "PlayerData.h"
+#include "SessionTable.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SQLiteDatabase;
+
+enum class AuthRequestKind {
+    NameExists,       // Is this account name taken?
+    Login,            // Verify the password, then read the player row and items
+    VerifyPassword,   // Verify only (password reset)
+    CreateAccount,    // Salt, hash and insert a new player row
+    ChangePassword,   // Salt, hash and update an existing row
+    Count
+};
+
+enum class AuthStatus {
+    Ok,
+    NotFound,         // No such account (NameExists: the name is free)
+    BadPassword,
+    Failed            // Database error
+};
+
+struct AuthRequest {
+    AuthRequestKind kind = AuthRequestKind::NameExists;
+    SessionID session = INVALID_SESSION;
+    uint64_t ticket = 0;
+    std::string name;
+    std::string password;
+    std::chrono::steady_clock::time_point submitted;
+};
+
+struct AuthResult {
+    AuthRequestKind kind = AuthRequestKind::NameExists;
+    SessionID session = INVALID_SESSION;
+    uint64_t ticket = 0;             // Matches the value Submit returned
+    AuthStatus status = AuthStatus::Failed;
+    PlayerData player;               // Login only
+    std::chrono::steady_clock::time_point submitted;
+};
+
+/**
+ * @class AuthService
+ * @brief Runs account lookups, password hashing and player-row loads off the game thread.
+ *
+ * Game states Submit a request and wait in a pending step. Each worker has its
+ * own SQLite connection, so a burst of logins after a restart queues here, not
+ * in the tick. Finished requests are collected by GameEngine at the start of
+ * a tick and handed to the session's current GameState (OnAuthResult). A result
+ * whose session has closed since is dropped.
+ *
+ * Latency is kept per request kind: queue wait and work on the worker, and
+ * total time from Submit until the tick applied the result. A summary is
+ * logged once a minute.
+ */
+class AuthService {
+public:
+    explicit AuthService(std::string databasePath);
+    ~AuthService();
+
+    AuthService(const AuthService&) = delete;
+    AuthService& operator=(const AuthService&) = delete;
+
+    // Starts the worker threads; requests submitted before this wait for them.
+    void Start(int workerCount);
+
+    // Game thread. Returns the ticket the result will carry.
+    uint64_t Submit(AuthRequestKind kind, SessionID session, std::string name, std::string password = "");
+
+    // Game thread: moves every finished result into 'out'.
+    void TakeResults(std::vector<AuthResult>& out);
+    // Game thread: the result was handed to its session (or dropped because the
+    // session had closed). Records the end-to-end latency.
+    void RecordApplied(const AuthResult& result, bool delivered);
+    void LogStatsIfDue();
+    // Game thread: blocks until every submitted request has finished. Replays
+    // use it so a login always completes by the next tick.
+    void WaitIdle();
+
+    static const char* KindName(AuthRequestKind kind);
+
+private:
+    struct KindStats {
+        LatencyHistogram queueWait;
+        LatencyHistogram work;
+        LatencyHistogram total;
+        uint64_t dropped = 0;
+    };
+
+    void WorkerLoop();
+    static void Execute(SQLiteDatabase& db, const AuthRequest& request, AuthResult& result);
+
+    std::string databasePath;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;                         // Guards everything below
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersIdle;
+    std::deque<AuthRequest> pending;
+    int running = 0;                          // Requests taken by a worker and not yet completed
+    std::vector<AuthResult> completed;
+    bool stopping = false;
+    uint64_t nextTicket = 1;
+    KindStats stats[static_cast<size_t>(AuthRequestKind::Count)];
+
+    std::chrono::steady_clock::time_point nextStatsLog = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+};
@@ -1,4 +1,8 @@
 #pragma once
+#include "TimerWheel.h"
+
+// Present while the entity recovers from an action; removed by its timer.
 struct BusyComponent {
-    float timeLeft;
-};
\ No newline at end of file
+    float timeLeft;         // Recovery time it was added with
+    TimerHandle timer;
+};
@@ -7,13 +7,16 @@
 #include "LoginState.h"
 #include "SQLiteDatabase.h"
 #include "GameEngine.h"
+#include "GameContext.h"
+#include "AuthService.h"
 
 class CharCreationState : public GameState {
 public:
     enum class CreationStep {
         USERNAME,
         PASSWORD,
-        CONFIRM_PASSWORD
+        CONFIRM_PASSWORD,
+        WAITING         // An AuthService request is running; input is held off
     };
 
     CharCreationState() : step(CreationStep::USERNAME) {}
@@ -25,7 +28,7 @@ public:
         client->QueueMessage("Enter your desired username:\r\n");
     }
 
-    void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+    void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
         if (p.empty()) return;
         
         GameEngine* engine = client->GetEngine();
@@ -33,13 +36,6 @@ public:
 
         switch (step) {
         case CreationStep::USERNAME:
-            // Check if username already exists
-            if (engine->gameContext.db->PlayerExists(input)) {
-                client->QueueMessage("That username is already taken.\r\n");
-                client->QueueMessage("Enter your desired username:\r\n");
-                return;
-            }
-            
             // Check username length
             if (input.length() < 3 || input.length() > 20) {
                 client->QueueMessage("Username must be between 3 and 20 characters.\r\n");
@@ -47,9 +43,10 @@ public:
                 return;
             }
             
+            // Check if username already exists; the answer comes back in OnAuthResult
             tempPlayer = input;
-            step = CreationStep::PASSWORD;
-            client->QueueMessage("Choose a password (min 4 characters):\r\n");
+            step = CreationStep::WAITING;
+            ticket = engine->gameContext.auth->Submit(AuthRequestKind::NameExists, client->clientID, tempPlayer);
             break;
 
         case CreationStep::PASSWORD:
@@ -73,29 +70,43 @@ public:
                 return;
             }
             
-            // Create the player
-            {
-                PlayerData playerData;
-                playerData.name = tempPlayer;
-                // Set default starting position
-                playerData.room_id = 1;  // Default starting room
-                playerData.x = 5;
-                playerData.y = 5;
-                playerData.region = "default";
-                
-                EntityID playerEntity = engine->CreatePlayer(client, tempPlayer, password, playerData);
-                
-                if (playerEntity != -1) {
-                    client->QueueMessage("\r\nCharacter created successfully!\r\n");
-                    client->QueueMessage("Please login with your new credentials.\r\n");
-                    client->PushState(new LoginState());
-                } else {
-                    client->QueueMessage("Error creating character. Please try again.\r\n");
-                    step = CreationStep::USERNAME;
-                    client->QueueMessage("Enter your desired username:\r\n");
-                }
-            }
+            // Create the player row (salted hash + insert) on an auth worker
+            step = CreationStep::WAITING;
+            ticket = engine->gameContext.auth->Submit(AuthRequestKind::CreateAccount, client->clientID, tempPlayer, password);
+            password.clear();
             break;
+
+        case CreationStep::WAITING:
+            client->QueueMessage("Please wait...\r\n");
+            break;
+        }
+    }
+
+    void OnAuthResult(ClientConnection* client, const AuthResult& result) override {
+        if (step != CreationStep::WAITING || result.ticket != ticket) return;
+
+        if (result.kind == AuthRequestKind::NameExists) {
+            if (result.status == AuthStatus::NotFound) {
+                step = CreationStep::PASSWORD;
+                client->QueueMessage("Choose a password (min 4 characters):\r\n");
+                return;
+            }
+            client->QueueMessage(result.status == AuthStatus::Ok
+                ? "That username is already taken.\r\n"
+                : "Error checking that username. Please try again.\r\n");
+            step = CreationStep::USERNAME;
+            client->QueueMessage("Enter your desired username:\r\n");
+            return;
+        }
+
+        if (result.status == AuthStatus::Ok) {
+            client->QueueMessage("\r\nCharacter created successfully!\r\n");
+            client->QueueMessage("Please login with your new credentials.\r\n");
+            client->PushState(new LoginState());
+        } else {
+            client->QueueMessage("Error creating character. Please try again.\r\n");
+            step = CreationStep::USERNAME;
+            client->QueueMessage("Enter your desired username:\r\n");
         }
     }
 
@@ -103,4 +114,5 @@ private:
     CreationStep step;
     std::string tempPlayer;
     std::string password;
+    uint64_t ticket = 0;
 };
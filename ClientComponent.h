@@ -1,5 +1,7 @@
 #pragma once
 #include "ClientConnection.h"
+#include "WireFormat.h"
+#include <nlohmann/json.hpp>
 #include <vector>
 #include <string>
 
@@ -7,11 +9,14 @@
 struct GameMessage {
     std::string type;           // e.g., "combat_hit", "room_enter", "heal"
     std::string consoleText;    // Human-readable text with ANSI color codes (e.g., "You take &R5&X damage!")
-    std::string jsonData;       // Raw JSON string for UI clients (e.g., "{\"damage\": 5, \"current_hp\": 45}")
+    nlohmann::json uiData;      // Structured data for UI clients (e.g., {"damage": 5, "current_hp": 45}).
+                                // Kept as a tree so each wire format encodes it directly.
     
     GameMessage() = default;
-    GameMessage(const std::string& msgType, const std::string& text, const std::string& data = "{}")
-        : type(msgType), consoleText(text), jsonData(data) {}
+    GameMessage(const std::string& msgType, const std::string& text, nlohmann::json data = nlohmann::json::object())
+        : type(msgType), consoleText(text), uiData(std::move(data)) {}
+
+    bool HasUiData() const { return !uiData.empty(); }
 };
 
 struct ClientComponent {
@@ -24,14 +29,19 @@ struct ClientComponent {
     bool isWebClient = false;      // True if client is a modern web client (expects JSON)
     bool hasSideBar = false;       // True if client supports sidebar UI (e.g., Mudlet GMCP)
     bool hasMiniMap = false;       // True if client supports minimap display
+    WireFormat wireFormat = WireFormat::Json;  // Envelope encoding for web clients, set by hello
     
     // Helper methods for message queue management
     void QueueGameMessage(const GameMessage& msg) {
         messageQueue.push_back(msg);
     }
     
-    void QueueGameMessage(const std::string& type, const std::string& consoleText, const std::string& jsonData = "{}") {
-        messageQueue.emplace_back(type, consoleText, jsonData);
+    void QueueGameMessage(GameMessage&& msg) {
+        messageQueue.push_back(std::move(msg));
+    }
+    
+    void QueueGameMessage(const std::string& type, const std::string& consoleText, nlohmann::json uiData = nlohmann::json::object()) {
+        messageQueue.emplace_back(type, consoleText, std::move(uiData));
     }
     
     bool HasPendingMessages() const {
@@ -42,6 +52,12 @@ struct ClientComponent {
         messageQueue.clear();
     }
     
+    // Sidebar clients said so in their hello; plain telnet clients agree to GMCP
+    // during option negotiation.
+    bool WantsGmcp() const {
+        return hasSideBar || (client && client->GmcpEnabled());
+    }
+
     // Helper to update capability flags from hello packet
     void SetCapabilities(bool web, bool sidebar, bool minimap) {
         isWebClient = web;
@@ -4,113 +4,440 @@
 #include "GameState.h"   
 #include <cstring>       
 #include <cstdio>   
+#include <mutex>
+#include <new>
 
-int ClientConnection::RecieveData() {
-    char recvbuf[DEFAULT_BUFLEN];
-    // Clear buffer not strictly necessary if we use the return value correctly, 
-    // but good for safety.
-    memset(recvbuf, 0, DEFAULT_BUFLEN);
+namespace {
+    // Free list of ClientConnection-sized blocks. Blocks are handed out in
+    // chunks and never returned to the heap, so the pool's size is the peak
+    // number of connections.
+    struct ConnectionPool {
+        static const size_t ALIGN = alignof(ClientConnection);
+        static const size_t BLOCK = (sizeof(ClientConnection) + ALIGN - 1) / ALIGN * ALIGN;
+        static const size_t CHUNK = 64;
 
-    int bytesReceived = recv(this->tcpSocket, recvbuf, DEFAULT_BUFLEN - 1, 0);
+        struct FreeBlock { FreeBlock* next; };
 
-    if (bytesReceived > 0) {
-        // 1. Append raw bytes to our persistent buffer
-        inputBuffer.append(recvbuf, bytesReceived);
+        std::mutex mutex;
+        FreeBlock* freeList = nullptr;
+        size_t blocks = 0;
 
-        // 2. Process ALL complete messages in the buffer
-        size_t pos = 0;
+        void Grow(size_t count) {
+            char* chunk = static_cast<char*>(::operator new(count * BLOCK, std::align_val_t(ALIGN)));
+            for (size_t i = 0; i < count; i++) {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * BLOCK);
+                block->next = freeList;
+                freeList = block;
+            }
+            blocks += count;
+        }
+    };
 
-        return bytesReceived;
+    ConnectionPool& Pool() {
+        static ConnectionPool* pool = new ConnectionPool();  // Outlives any static teardown order
+        return *pool;
     }
-    else {
-        return 0; // Disconnected or error
+}
+
+void* ClientConnection::operator new(size_t size) {
+    if (size != sizeof(ClientConnection)) {
+        return ::operator new(size, std::align_val_t(ConnectionPool::ALIGN));
     }
+    ConnectionPool& pool = Pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (!pool.freeList) pool.Grow(ConnectionPool::CHUNK);
+    ConnectionPool::FreeBlock* block = pool.freeList;
+    pool.freeList = block->next;
+    return block;
 }
 
+void ClientConnection::operator delete(void* block, size_t size) {
+    if (!block) return;
+    if (size != sizeof(ClientConnection)) {
+        ::operator delete(block, std::align_val_t(ConnectionPool::ALIGN));
+        return;
+    }
+    ConnectionPool& pool = Pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    ConnectionPool::FreeBlock* freed = static_cast<ConnectionPool::FreeBlock*>(block);
+    freed->next = pool.freeList;
+    pool.freeList = freed;
+}
 
-void ClientConnection::ProcessInput() {
-    size_t pos = 0;
+void ClientConnection::ReservePool(size_t count) {
+    ConnectionPool& pool = Pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (count > pool.blocks) pool.Grow(count - pool.blocks);
+}
 
-    // Find position of the next newline character
-    while ((pos = inputBuffer.find('\n')) != std::string::npos) {
+int ClientConnection::RecieveData(const LineHandler& onLine) {
+    int totalReceived = 0;
 
-        // 1. Extract the command line (up to the \n)
-        std::string line = inputBuffer.substr(0, pos);
+    // The socket is non-blocking and the reactor may be edge-triggered, so keep
+    // reading until the kernel buffer is empty or we would miss the rest of it.
+    char frameBuffer[DEFAULT_BUFLEN * 4];
+    while (true) {
+        // Read straight into the framer; if it is full, hand lines out first.
+        // WebSocket frames are decoded from a stack buffer instead.
+        size_t space;
+        char* dest;
+        if (websocket) {
+            dest = frameBuffer;
+            space = sizeof(frameBuffer);
+        }
+        else {
+            dest = input.WritableSpan(space);
+            if (space == 0) {
+                if (!DrainLines(onLine)) return -1;
+                dest = input.WritableSpan(space);
+            }
+        }
 
-        // 2. Remove the processed part from the buffer (including the \n at pos)
-        inputBuffer.erase(0, pos + 1);
+        int bytesReceived = recv(this->tcpSocket, dest, static_cast<int>(space), 0);
+        ioCalls++;
 
-        // 3. Handle Telnet \r (Carriage Return) if present at the end
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+        if (bytesReceived > 0) {
+            if (websocket) {
+                if (!FeedWebSocket(dest, static_cast<size_t>(bytesReceived), onLine)) return -1;
+            }
+            else {
+                input.Commit(FilterTelnet(dest, static_cast<size_t>(bytesReceived)));
+            }
+            totalReceived += bytesReceived;
+            continue;
         }
 
-        // 4. Skip processing if the line is empty (user just hit enter)
-        if (line.empty()) continue;
+        if (bytesReceived == SOCKET_ERROR) {
+            int err = SocketPlatform::LastError();
+            if (SocketPlatform::Interrupted(err)) continue;
+            if (SocketPlatform::WouldBlock(err)) {
+                // Drained; 0 just means a spurious wakeup
+                return DrainLines(onLine) ? totalReceived : -1;
+            }
+        }
+
+        // Orderly shutdown (0) or a real error. Still hand out the complete lines
+        // read this round so the final commands are processed.
+        DrainLines(onLine);
+        needsCleanup = true;
+        return -1;
+    }
+}
+
+bool ClientConnection::FeedInput(const char* data, size_t length, const LineHandler& onLine) {
+    if (websocket) {
+        return FeedWebSocket(data, length, onLine);
+    }
 
-        // 5. Tokenize (Split string by spaces into vector)
-        std::vector<std::string> parameters;
-        std::stringstream ss(line);
-        std::string token;
-        while (ss >> token) {
-            parameters.push_back(token);
+    while (length > 0) {
+        // Copy into the framer, then strip telnet commands in place there.
+        size_t space;
+        char* dest = input.WritableSpan(space);
+        if (space == 0) {
+            if (!DrainLines(onLine)) return false;
+            continue;
         }
+        size_t taken = length < space ? length : space;
+        memcpy(dest, data, taken);
+        input.Commit(FilterTelnet(dest, taken));
+        data += taken;
+        length -= taken;
+    }
+    return DrainLines(onLine);
+}
+
+bool ClientConnection::FeedWebSocket(const char* data, size_t length, const LineHandler& onLine) {
+    std::string text;
+    std::string replies;
+    if (!websocket->Decode(data, length, text, replies)) {
+        // Close frame or protocol error: flush the reply, then drop the connection.
+        needsCleanup = true;
+    }
+    if (!replies.empty()) {
+        // Handshake response, pongs and close frames may go between any two messages.
+        PushOutput(std::move(replies));
+    }
+    return AppendText(text.data(), text.size(), onLine);
+}
+
+bool ClientConnection::AppendText(const char* data, size_t length, const LineHandler& onLine) {
+    while (length > 0) {
+        size_t taken = input.Append(data, length);
+        data += taken;
+        length -= taken;
+        if (!DrainLines(onLine)) return false;
+    }
+    return DrainLines(onLine);
+}
+
+void ClientConnection::EnableWebSocket(const WebSocketConfig& config) {
+    websocket = std::make_unique<WebSocketSession>(config);
+}
 
-        // 6. Safety Check: Ensure we actually have words before processing
-        if (parameters.empty()) continue;
+void ClientConnection::EnableTelnet(const TelnetConfig& config) {
+    telnet = std::make_unique<TelnetSession>(config);
+    QueueProtocolBytes(telnet->InitialNegotiation());
+}
+
+void ClientConnection::CollectCompressionStats(uint64_t& rawBytes, uint64_t& wireBytes) {
+    if (!telnet && !websocket) return;
+    DeflateStream& compressor = telnet ? telnet->Compressor() : websocket->Compressor();
+    rawBytes += compressor.rawBytes;
+    wireBytes += compressor.compressedBytes;
+    compressor.rawBytes = 0;
+    compressor.compressedBytes = 0;
+}
 
-        // 8. Pass to the active Game State (Menu or Playing)
-        if (!stateStack.empty()) {
-            stateStack.top()->HandleInput(this, parameters);
+size_t ClientConnection::FilterTelnet(char* data, size_t length) {
+    if (!telnet) return length;
+
+    std::string replies;
+    size_t kept = telnet->FilterInput(data, length, replies);
+    if (!replies.empty()) {
+        QueueProtocolBytes(std::move(replies));
+    }
+
+    // The tail and the start marker are pushed directly: QueueProtocolBytes
+    // pulls again first, which could slip game output in on the wrong side of
+    // the stream boundary and corrupt the client's inflater.
+    if (telnet->TakeCompressionStop()) {
+        PullQueuedOutput();                 // Compress and flush what the game queued so far
+        std::string tail;
+        telnet->StopCompression(tail);
+        PushOutput(std::move(tail));
+    }
+    if (telnet->TakeCompressionStart()) {
+        // Output already pulled stays plain; everything after the marker is compressed.
+        PullQueuedOutput();
+        if (telnet->StartCompression()) {
+            PushOutput({ (char)Telnet::IAC, (char)Telnet::SB, (char)Telnet::OPT_MCCP2, (char)Telnet::IAC, (char)Telnet::SE });
+        }
+        else {
+            QueueProtocolBytes({ (char)Telnet::IAC, (char)Telnet::WONT, (char)Telnet::OPT_MCCP2 });
         }
     }
+    return kept;
+}
+
+void ClientConnection::QueueProtocolBytes(std::string bytes) {
+    PullQueuedOutput();
+    if (telnet && telnet->IsCompressing()) {
+        std::string packed;
+        telnet->Compress(bytes.data(), bytes.size(), true, packed);
+        bytes.swap(packed);
+    }
+    PushOutput(std::move(bytes));
 }
-int ClientConnection::SendData() {
 
-    int iSendResult = 0;
-    char recvbuf[DEFAULT_BUFLEN] = { 0 };
-    int recvbuflen = DEFAULT_BUFLEN;
-    int iResult = 0;
-    std::string hugePacket = "";
+void ClientConnection::PushOutput(std::string bytes) {
+    if (bytes.empty()) return;
+    pendingBytes.fetch_add(bytes.size(), std::memory_order_relaxed);
+    outbound.Push(MakeSegment(std::move(bytes)));
+}
 
-    while (!OutboundMessages.empty()) {
-        hugePacket += OutboundMessages.front();
-        OutboundMessages.pop();
+bool ClientConnection::DrainLines(const LineHandler& onLine) {
+    std::string_view line;
+    while (input.NextLine(line)) {
+        if (!onLine(line)) return false;
     }
+    return true;
+}
 
-    // 3. Send ONLY ONCE
-    if (!hugePacket.empty()) {
-        iSendResult = send(this->tcpSocket, hugePacket.c_str(), static_cast<int>(hugePacket.size()), 0);
+int ClientConnection::SendData() {
+    SocketPlatform::IoSlice slices[SocketPlatform::MAX_SEND_SLICES];
+
+    // One gathered send normally carries the whole tick. A bigger backlog needs
+    // several; cork around them so the kernel doesn't emit a short segment at
+    // every call boundary.
+    PullQueuedOutput();
+    bool corked = outbound.SegmentCount() > static_cast<size_t>(SocketPlatform::MAX_SEND_SLICES)
+        && SocketPlatform::SetCork(this->tcpSocket, true);
+    if (corked) ioCalls++;
+
+    int totalSent = 0;
+    int result = 0;
+    while (true) {
+        // Point the kernel straight at the queued segments; nothing is concatenated.
+        int count = 0;
+        GatherOutput(SocketPlatform::MAX_SEND_SLICES, [&](const char* data, size_t length) {
+            SocketPlatform::SetSlice(slices[count++], data, length);
+        });
+        if (count == 0) break;
+
+        int iSendResult = SocketPlatform::SendSlices(this->tcpSocket, slices, count);
+        ioCalls++;
+        sendCalls++;
 
         if (iSendResult == SOCKET_ERROR) {
-            printf("send failed with error: %d\n", WSAGetLastError());
-            closesocket(this->tcpSocket);
-            WSACleanup();
-            return iResult;
+            int err = SocketPlatform::LastError();
+            if (SocketPlatform::Interrupted(err)) continue;
+            if (SocketPlatform::WouldBlock(err)) break; // Kernel buffer full, retry when writable
+            printf("send failed with error: %d\n", err);
+            result = -1;
+            break;
         }
-        printf("Bytes sent: %d\n", iSendResult);
+
+        // A partial send leaves the chain's offset at the first unsent byte.
+        ConsumeOutput(static_cast<size_t>(iSendResult));
+        totalSent += iSendResult;
     }
 
-    return iSendResult;
+    if (corked) {
+        SocketPlatform::SetCork(this->tcpSocket, false);
+        ioCalls++;
+    }
+    return result < 0 ? result : totalSent;
 }
 
 void ClientConnection::QueueMessage(const std::string& msg) {
-    OutboundMessages.push(msg);
+    QueueSegment(MakeSegment(msg));
 }
 
-void ClientConnection::SendPacket(std::string packet) {
-    // Send the packet immediately (for GMCP and other protocol packets)
-    int iSendResult = send(this->tcpSocket, packet.c_str(), static_cast<int>(packet.size()), 0);
-    
-    if (iSendResult == SOCKET_ERROR) {
-        printf("SendPacket failed with error: %d\n", WSAGetLastError());
-        // Don't close socket here - let the main loop handle disconnection
+void ClientConnection::QueueMessage(std::string&& msg) {
+    QueueSegment(MakeSegment(std::move(msg)));
+}
+
+void ClientConnection::QueueSegment(OutboundSegment segment) {
+    if (!segment || segment->empty() || evicted.load(std::memory_order_relaxed)) return;
+    pendingBytes.fetch_add(segment->size(), std::memory_order_relaxed);
+    outboundQueue.Push(std::move(segment));
+    segmentsQueued++;
+}
+
+void ClientConnection::ReleaseOutput() {
+    segmentsReleased.store(segmentsQueued, std::memory_order_release);
+}
+
+bool ClientConnection::PopReleased(OutboundSegment& segment) {
+    if (segmentsPulled == releasedLimit) {
+        releasedLimit = segmentsReleased.load(std::memory_order_acquire);
+        if (segmentsPulled == releasedLimit) return false;
     }
+    if (!outboundQueue.TryPop(segment)) return false;
+    segmentsPulled++;
+    return true;
 }
-void ClientConnection::DisconnectGracefully() {
-    // 1. Send the TCP shutdown signal (SD_SEND)
-    shutdown(this->tcpSocket, SD_SEND);
 
+void ClientConnection::QueueLatest(SupersededOutput kind, std::string msg) {
+    if (!congested) {
+        QueueMessage(std::move(msg));
+        return;
+    }
+
+    int slot = static_cast<int>(kind);
+    if (hasHeldFrame[slot]) {
+        backpressure.coalescedFrames++;
+    }
+    heldFrames[slot] = std::move(msg);
+    hasHeldFrame[slot] = true;
+}
+
+bool ClientConnection::UpdateBackpressure(const BackpressureLimits& limits) {
+    if (evicted) return false;
+
+    size_t pending = PendingOutputBytes();
+
+    // Two thresholds, so a client hovering around one doesn't flap.
+    if (!congested && pending > limits.highWater) {
+        congested = true;
+        backpressure.congestionEpisodes++;
+        printf("Client %d congested: %zu bytes unsent\n", clientID, pending);
+    }
+    else if (congested && pending < limits.lowWater) {
+        congested = false;
+        // Caught up: send the newest of each held frame, in a fixed order.
+        for (int slot = 0; slot < static_cast<int>(SupersededOutput::Count); slot++) {
+            if (hasHeldFrame[slot]) {
+                hasHeldFrame[slot] = false;
+                QueueMessage(std::move(heldFrames[slot]));
+                heldFrames[slot].clear();
+            }
+        }
+    }
+
+    if (congested) {
+        backpressure.congestedTicks++;
+    }
+
+    ticksOverCap = pending > limits.hardCap ? ticksOverCap + 1 : 0;
+    if (ticksOverCap >= limits.evictAfterTicks) {
+        printf("Evicting client %d: %zu bytes unsent for %d ticks\n", clientID, pending, ticksOverCap);
+        evicted = true;
+        needsCleanup = true;
+        return false;
+    }
+    return true;
+}
+
+void ClientConnection::PullQueuedOutput() {
+    OutboundSegment segment;
+    if (!OutputOpen()) return;
+
+    if (websocket) {
+        // One message per segment, text or binary by its first byte. Uncompressed,
+        // the shared payload is sent as-is behind its own small header.
+        while (PopReleased(segment)) {
+            size_t rawBytes = segment->size();
+            if (websocket->ShouldCompress(rawBytes)) {
+                std::string frame;
+                websocket->Deflate(segment->data(), rawBytes, frame);
+                pendingBytes.fetch_add(frame.size(), std::memory_order_relaxed);
+                pendingBytes.fetch_sub(rawBytes, std::memory_order_relaxed);
+                outbound.Push(MakeSegment(std::move(frame)));
+                continue;
+            }
+            char header[WebSocketSession::MAX_HEADER];
+            size_t headerLength = WebSocketSession::WriteHeader(header, rawBytes, false,
+                WebSocketSession::IsBinaryPayload(segment->data(), rawBytes));
+            pendingBytes.fetch_add(headerLength, std::memory_order_relaxed);
+            outbound.Push(MakeSegment(std::string(header, headerLength)));
+            outbound.Push(std::move(segment));
+        }
+        return;
+    }
+
+    if (!telnet || !telnet->IsCompressing()) {
+        while (PopReleased(segment)) {
+            outbound.Push(std::move(segment));
+        }
+        return;
+    }
+
+    // MCCP2: the whole batch becomes one compressed segment, flushed once at the
+    // end so the client can render it. Shared room segments are read, not copied.
+    std::string packed;
+    size_t rawBytes = 0;
+    while (PopReleased(segment)) {
+        telnet->Compress(segment->data(), segment->size(), false, packed);
+        rawBytes += segment->size();
+    }
+    if (rawBytes == 0) return;
+    telnet->Compress(nullptr, 0, true, packed);
+
+    // pendingBytes counted the plain text; from here on it tracks what goes on the wire.
+    pendingBytes.fetch_add(packed.size(), std::memory_order_relaxed);
+    pendingBytes.fetch_sub(rawBytes, std::memory_order_relaxed);
+    outbound.Push(MakeSegment(std::move(packed)));
+}
+
+bool ClientConnection::HasPendingOutput() {
+    return !outbound.Empty()
+        || (OutputOpen() && segmentsPulled != segmentsReleased.load(std::memory_order_acquire));
+}
+
+void ClientConnection::ConsumeOutput(size_t bytes) {
+    outbound.Consume(bytes);
+    pendingBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void ClientConnection::SendPacket(std::string packet) {
+    // GMCP and other protocol packets join the same stream as text. Writing them
+    // straight to the socket could land in the middle of a partially sent message.
+    QueueMessage(std::move(packet));
+}
+void ClientConnection::DisconnectGracefully() {
+    // The network thread flushes whatever is still queued (the goodbye text)
+    // and then closes the socket. Shutting it down here raced that flush.
     this->needsCleanup = true;
 }
 
@@ -1,10 +1,18 @@
 #pragma once
 
-#include <WinSock2.h>
+#include "SocketPlatform.h"
+#include "OutboundBuffer.h"
+#include "SpscQueue.h"
+#include "LineFramer.h"
+#include "TelnetProtocol.h"
+#include "WebSocketProtocol.h"
 #include "Command.h"
 #include <string>
-#include <queue>
+#include <string_view>
+#include <functional>
+#include <atomic>
 #include <stack>
+#include <memory>
 //#include "CommandInterpreter.h"
 
 
@@ -12,14 +20,28 @@
 
 class GameState;
 class GameEngine;
+
+// Send/receive bookkeeping for connections served by the io_uring backend.
+// Segments handed to the kernel stay at the front of the outbound chain until
+// their SEND completes, so no separate copy is kept here.
+struct UringConnectionState {
+	int sendsInFlight = 0;
+	int opsInFlight = 0;         // Recv + sends still owned by the kernel
+	bool closing = false;
+};
 class CommandInterpreter;  // Add forward declaration
 
+// Which listener accepted the connection, and so which protocol it speaks.
+enum class ConnectionKind {
+	Telnet,
+	WebSocket
+};
+
 class ClientConnection
 {
 public:
 	SOCKET tcpSocket;
-	int clientID;
-	std::string recvBuffer;
+	int clientID = -1;
 	ClientConnection(SOCKET newSocket) : tcpSocket(newSocket) {
 	
 	}
@@ -28,23 +50,124 @@ public:
 			closesocket(tcpSocket);
 		}
 	}
-	int playerId;
-	int RecieveData();
-	void ProcessInput();
+	// Connections are carved from a pooled free list instead of the general heap,
+	// so an accept burst doesn't hammer the allocator. ReservePool preallocates.
+	static void* operator new(size_t size);
+	static void operator delete(void* block, size_t size);
+	static void ReservePool(size_t count);
+	int playerId = -1;
+
+	// Called on the network thread for each complete input line. Returning
+	// false drops the connection (flood protection).
+	using LineHandler = std::function<bool(std::string_view)>;
+	// Reads until the socket would block. Returns bytes read, or -1 once the
+	// connection is closed, failed, or was refused by onLine.
+	int RecieveData(const LineHandler& onLine);
+	// Completion-based backends deliver bytes already read from the socket.
+	bool FeedInput(const char* data, size_t length, const LineHandler& onLine);
+	uint64_t OverlongLines() const { return input.OverlongLines(); }
+	// Network thread: puts the connection in telnet mode and sends the server's
+	// option offers. Until this is called, input and output pass through untouched.
+	void EnableTelnet(const TelnetConfig& config);
+	// Any thread: the negotiated telnet options.
+	bool GmcpEnabled() const { return telnet && telnet->GmcpEnabled(); }
+	const TelnetSession* GetTelnet() const { return telnet.get(); }
+	// Network thread: the connection came in on the WebSocket listener. Input is
+	// decoded from frames and each queued segment goes out as one message.
+	void EnableWebSocket(const WebSocketConfig& config);
+	bool IsWebSocket() const { return websocket != nullptr; }
+	// Game thread, from the hello handshake: how the client encodes binary commands.
+	void SetWireFormat(WireFormat format) { if (websocket) websocket->SetBinaryFormat(format); }
+	// Network thread: adds and resets the MCCP2/permessage-deflate byte counts.
+	void CollectCompressionStats(uint64_t& rawBytes, uint64_t& wireBytes);
+	// Flood accounting, network thread only; reset once per tick
+	int linesThisTick = 0;
+	uint64_t linesDropped = 0;
+
 	int SendData();
 	void SendPacket(std::string packet);
+	// Game thread only. Output is held until ReleaseOutput at the end of the
+	// tick, then goes out together on the next Server::Wake.
 	void QueueMessage(const std::string& msg);
-	std::queue<std::string> OutboundMessages;
+	void QueueMessage(std::string&& msg);
+	// Queues an already-built segment without copying it (e.g. one shared by a whole room).
+	void QueueSegment(OutboundSegment segment);
+	// Game thread, end of tick: lets the network thread send everything queued
+	// so far. Nothing queued later can slip into this tick's flush.
+	void ReleaseOutput();
+	// Game thread: queues a frame that a newer one of the same kind replaces.
+	// While congested only the latest is held back and sent once the client drains.
+	void QueueLatest(SupersededOutput kind, std::string msg);
+	// Game thread, once per tick: updates the congestion state from the bytes
+	// still unsent. Returns false if the client has now been evicted.
+	bool UpdateBackpressure(const BackpressureLimits& limits);
+	bool IsCongested() const { return congested; }
+	const BackpressureCounters& GetBackpressure() const { return backpressure; }
+	// Set by the game thread for a client that stayed over the hard cap. The
+	// network thread closes it without waiting for the unsent output.
+	std::atomic<bool> evicted{ false };
+	// Network thread only.
+	bool HasPendingOutput();
+	// Any thread: bytes queued and not yet accepted by the kernel.
+	size_t PendingOutputBytes() const { return pendingBytes.load(std::memory_order_relaxed); }
+	// Network thread only: hand the unsent slices to a completion backend, then
+	// release what it reports as sent. Segments stay alive until consumed.
+	template<typename Fn>
+	size_t GatherOutput(size_t maxSlices, Fn&& emit) {
+		PullQueuedOutput();
+		return outbound.Gather(maxSlices, emit);
+	}
+	void ConsumeOutput(size_t bytes);
 	void DisconnectGracefully();
-	bool needsCleanup;
-	CommandInterpreter* commandInterpretter;
+	// Set by the game thread on quit, read by the network thread.
+	std::atomic<bool> needsCleanup{ false };
+	CommandInterpreter* commandInterpretter = nullptr;
 	std::stack<GameState*> stateStack;
 	void PopState();
 	void PushState(GameState* state);
 	GameEngine* GetEngine() { return engine; }
-	int playerEntityID;
+	int playerEntityID = -1;
 	void SetEngine(GameEngine* _engine) { engine = _engine; }
+	UringConnectionState uring;
+	// recv/send calls made since the Server last collected them (for NetworkStats).
+	unsigned ioCalls = 0;
+	unsigned sendCalls = 0;
+	uint64_t lastSegmentsSent = 0;   // TCP_INFO data segments at the last stats sample
 private:
-	GameEngine* engine;
-	std::string inputBuffer;
+	GameEngine* engine = nullptr;
+	bool DrainLines(const LineHandler& onLine);
+	size_t FilterTelnet(char* data, size_t length);
+	bool FeedWebSocket(const char* data, size_t length, const LineHandler& onLine);
+	bool AppendText(const char* data, size_t length, const LineHandler& onLine);
+	// False while a WebSocket handshake is pending or after it closed: game
+	// output stays queued (and is never sent) so only protocol replies go out.
+	bool OutputOpen() const { return !websocket || websocket->IsOpen(); }
+	void PushOutput(std::string bytes);
+	// Network thread: protocol bytes go straight into the outbound chain, behind
+	// whatever the game has already queued and through MCCP2 if it is on.
+	void QueueProtocolBytes(std::string bytes);
+
+	LineFramer input;
+	std::unique_ptr<TelnetSession> telnet;
+	std::unique_ptr<WebSocketSession> websocket;
+	void PullQueuedOutput();
+	bool PopReleased(OutboundSegment& segment);
+
+	// Game thread -> network thread hand-off; no locks on either side.
+	SpscQueue<OutboundSegment> outboundQueue;
+	// Network thread only: segments being written, with the partial-send offset.
+	OutboundChain outbound;
+	std::atomic<size_t> pendingBytes{ 0 };
+	// Tick boundary: segments pushed (game thread), published, and pulled (network thread).
+	uint64_t segmentsQueued = 0;
+	std::atomic<uint64_t> segmentsReleased{ 0 };
+	uint64_t segmentsPulled = 0;
+	uint64_t releasedLimit = 0;
+
+	// Backpressure, game thread only
+	bool congested = false;
+	int ticksOverCap = 0;
+	BackpressureCounters backpressure;
+	std::string heldFrames[static_cast<int>(SupersededOutput::Count)];
+	bool hasHeldFrame[static_cast<int>(SupersededOutput::Count)] = {};
 };
\ No newline at end of file
@@ -2,6 +2,6 @@
 #include <string>
 
 struct ClientInput {
-    int clientID;
+    int clientID = -1;
     std::string rawText; // This holds "password123", "kill goblin", or "yes"
 };
\ No newline at end of file
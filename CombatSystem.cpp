@@ -5,10 +5,12 @@
 #include "StatComponent.h"
 #include "ClientComponent.h"
 #include "BusyComponent.h"
+#include "TimedComponents.h"
 #include "NameComponent.h"
 #include "EventBus.h"
 #include "MobComponent.h"
 #include "Tags.h"
+#include "DirtyFlagComponents.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <string>
@@ -26,7 +28,7 @@ void CombatSystem::run()
 
         // Check if source is busy
         auto* busy = ctx.registry->GetComponent<BusyComponent>(sourceID);
-        if (busy && busy->timeLeft > 0) {
+        if (busy) {
             continue; 
         }
 
@@ -66,6 +68,9 @@ void CombatSystem::ProcessAttack(int sourceID, int targetID, float damage, const
     
     // Apply damage
     targetStats->Health = (std::max)(0, targetStats->Health - finalDamage);
+    if (ctx.registry->HasComponent<ClientComponent>(targetID)) {
+        ctx.registry->AddComponent<VitalsChangedComponent>(targetID);
+    }
 
     // Send combat messages using new GameMessage pattern
     auto* sourceClient = ctx.registry->GetComponent<ClientComponent>(sourceID);
@@ -85,8 +90,8 @@ void CombatSystem::ProcessAttack(int sourceID, int targetID, float damage, const
         GameMessage msg;
         msg.type = "combat_hit";
         msg.consoleText = "You attack " + targetNameStr + " for &R" + std::to_string(finalDamage) + "&X " + damageType + " damage!";
-        msg.jsonData = jsonData.dump();
-        sourceClient->QueueGameMessage(msg);
+        msg.uiData = std::move(jsonData);
+        sourceClient->QueueGameMessage(std::move(msg));
     }
 
     auto* targetClient = ctx.registry->GetComponent<ClientComponent>(targetID);
@@ -106,8 +111,8 @@ void CombatSystem::ProcessAttack(int sourceID, int targetID, float damage, const
         GameMessage msg;
         msg.type = "combat_hit";
         msg.consoleText = sourceNameStr + " attacks you for &R" + std::to_string(finalDamage) + "&X " + damageType + " damage!";
-        msg.jsonData = jsonData.dump();
-        targetClient->QueueGameMessage(msg);
+        msg.uiData = std::move(jsonData);
+        targetClient->QueueGameMessage(std::move(msg));
         
         if (targetStats->Health <= 0) {
             json defeatData = {
@@ -118,8 +123,8 @@ void CombatSystem::ProcessAttack(int sourceID, int targetID, float damage, const
             GameMessage defeatMsg;
             defeatMsg.type = "player_defeat";
             defeatMsg.consoleText = "&RYou have been defeated!&X";
-            defeatMsg.jsonData = defeatData.dump();
-            targetClient->QueueGameMessage(defeatMsg);
+            defeatMsg.uiData = std::move(defeatData);
+            targetClient->QueueGameMessage(std::move(defeatMsg));
         }
     }
 
@@ -127,7 +132,7 @@ void CombatSystem::ProcessAttack(int sourceID, int targetID, float damage, const
     auto* sourceStatsForRecovery = ctx.registry->GetComponent<StatComponent>(sourceID);
     if (sourceStatsForRecovery) {
         float recovery = 20.0f / (float)sourceStatsForRecovery->attackSpeed;
-        ctx.registry->AddComponent<BusyComponent>(sourceID, BusyComponent{ recovery });
+        AddTimedComponent(*ctx.registry, *ctx.timers, sourceID, recovery, BusyComponent{ recovery });
     }
 
     // Handle mob death (separate from player death handling above)
@@ -153,6 +158,9 @@ void CombatSystem::ProcessHeal(int sourceID, int targetID, float healAmount)
 
     int actualHeal = (std::min)((int)healAmount, targetStats->MaxHealth - targetStats->Health);
     targetStats->Health += actualHeal;
+    if (ctx.registry->HasComponent<ClientComponent>(targetID)) {
+        ctx.registry->AddComponent<VitalsChangedComponent>(targetID);
+    }
 
     // Send heal messages using new GameMessage pattern
     auto* sourceClient = ctx.registry->GetComponent<ClientComponent>(sourceID);
@@ -171,8 +179,8 @@ void CombatSystem::ProcessHeal(int sourceID, int targetID, float healAmount)
         GameMessage msg;
         msg.type = "combat_heal";
         msg.consoleText = "You heal " + targetNameStr + " for &G" + std::to_string(actualHeal) + "&X health!";
-        msg.jsonData = jsonData.dump();
-        sourceClient->QueueGameMessage(msg);
+        msg.uiData = std::move(jsonData);
+        sourceClient->QueueGameMessage(std::move(msg));
     }
 
     auto* targetClient = ctx.registry->GetComponent<ClientComponent>(targetID);
@@ -188,8 +196,8 @@ void CombatSystem::ProcessHeal(int sourceID, int targetID, float healAmount)
             GameMessage msg;
             msg.type = "combat_heal";
             msg.consoleText = "You heal yourself for &G" + std::to_string(actualHeal) + "&X health!";
-            msg.jsonData = jsonData.dump();
-            targetClient->QueueGameMessage(msg);
+            msg.uiData = std::move(jsonData);
+            targetClient->QueueGameMessage(std::move(msg));
         } else {
             auto* sourceName = ctx.registry->GetComponent<NameComponent>(sourceID);
             std::string sourceNameStr = sourceName ? sourceName->displayName : "someone";
@@ -205,8 +213,8 @@ void CombatSystem::ProcessHeal(int sourceID, int targetID, float healAmount)
             GameMessage msg;
             msg.type = "combat_heal";
             msg.consoleText = sourceNameStr + " heals you for &G" + std::to_string(actualHeal) + "&X health!";
-            msg.jsonData = jsonData.dump();
-            targetClient->QueueGameMessage(msg);
+            msg.uiData = std::move(jsonData);
+            targetClient->QueueGameMessage(std::move(msg));
         }
     }
 }
@@ -225,8 +233,8 @@ void CombatSystem::ProcessBuff(int sourceID, int targetID, const std::string& bu
         GameMessage msg;
         msg.type = "combat_buff";
         msg.consoleText = "You cast &C" + buffType + "&X on your target!";
-        msg.jsonData = jsonData.dump();
-        sourceClient->QueueGameMessage(msg);
+        msg.uiData = std::move(jsonData);
+        sourceClient->QueueGameMessage(std::move(msg));
     }
 
     auto* targetClient = ctx.registry->GetComponent<ClientComponent>(targetID);
@@ -240,8 +248,8 @@ void CombatSystem::ProcessBuff(int sourceID, int targetID, const std::string& bu
         GameMessage msg;
         msg.type = "combat_buff";
         msg.consoleText = "You are affected by &C" + buffType + "&X!";
-        msg.jsonData = jsonData.dump();
-        targetClient->QueueGameMessage(msg);
+        msg.uiData = std::move(jsonData);
+        targetClient->QueueGameMessage(std::move(msg));
     }
     
     // TODO: Implement actual buff/debuff system with temporary stat modifiers
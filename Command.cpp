@@ -110,7 +110,7 @@ void Command::ParseInput(const std::string& rawInput) {
     }
 }
 
-void Command::ParseInput(std::vector<std::string> p) {
+void Command::ParseInput(const std::vector<std::string>& p) {
     this->Parameters.clear(); 
 
     if (p.empty()) {
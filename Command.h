@@ -16,7 +16,7 @@ public:
     Command() {}
     ~Command() {}
     void ParseInput(const std::string& rawInput);
-    void ParseInput(std::vector<std::string> p);
+    void ParseInput(const std::vector<std::string>& p);
     void Deserialize(char* buffer);
     char* Serialize(int& totalLength);
     void ParseParameters();
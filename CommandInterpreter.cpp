@@ -16,10 +16,20 @@
 #include "GameEngine.h"
 #include "MenuState.h"
 #include "ClientComponent.h"
+#include "MessageSystem.h"
+#include "PlayerComponent.h"
+#include "TickProfiler.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <system_error>
 
 using json = nlohmann::json;
 
+// Where "profile trace" writes; relative to the server's working directory
+static const char* TRACE_DIRECTORY = "traces";
+
 
 CommandInterpreter::CommandInterpreter(GameContext& g) : ctx(g)
 {
@@ -75,11 +85,85 @@ EntityID FindTarget(GameContext& ctx, EntityID playerID, const std::string& targ
 
 	return -1; // Not found
 }
+// Helper: applies a {"type": "hello", ...} packet to the player's ClientComponent
+// and sends the hello_ack built on top of 'response'. Returns false if the packet
+// is not a hello. "encodings" lists the binary formats the client can read, in
+// order of preference; WebSocket clients get the first one the server speaks.
+bool ApplyHello(GameContext& ctx, ClientConnection* client, const json& packet, json& response) {
+	if (!packet.contains("type") || packet["type"] != "hello") return false;
+
+	// Get the player's ClientComponent
+	ClientComponent* clientComp = ctx.registry->GetComponent<ClientComponent>(client->playerEntityID);
+	if (!clientComp) return false;
+
+	// Parse features array
+	bool hasSideBar = false;
+	bool hasMiniMap = false;
+	if (packet.contains("features") && packet["features"].is_array()) {
+		for (const auto& feature : packet["features"]) {
+			if (!feature.is_string()) continue;
+			std::string featureStr = feature.get<std::string>();
+			if (featureStr == "sidebar") {
+				hasSideBar = true;
+			} else if (featureStr == "minimap") {
+				hasMiniMap = true;
+			}
+		}
+	}
+
+	WireFormat format = WireFormat::Json;
+	if (client->IsWebSocket() && packet.contains("encodings") && packet["encodings"].is_array()) {
+		for (const auto& encoding : packet["encodings"]) {
+			if (!encoding.is_string()) continue;
+			format = ParseWireFormat(encoding.get<std::string>());
+			if (format != WireFormat::Json) break;
+		}
+	}
+
+	// Update client capabilities - this is a web client
+	clientComp->SetCapabilities(true, hasSideBar, hasMiniMap);
+
+	// Send acknowledgment. The ack itself is still JSON text; everything after
+	// it uses the chosen encoding.
+	response["type"] = "hello_ack";
+	response["features_enabled"] = {
+		{"sidebar", hasSideBar},
+		{"minimap", hasMiniMap}
+	};
+	response["encoding"] = WireFormatName(format);
+	client->QueueMessage(response.dump() + "\n");
+
+	clientComp->wireFormat = format;
+	client->SetWireFormat(format);
+	return true;
+}
+
 void CommandInterpreter::Interpret(ClientConnection* client, Command* command) {
 	if (core_command_map_[command->CommandString])
 	{
 		core_command_map_[command->CommandString](client, command->Parameters, {});
+		return;
 	}
+
+	auto admin = admin_command_map_.find(command->CommandString);
+	if (admin != admin_command_map_.end() && IsAdmin(client)) {
+		admin->second(client, command->Parameters, {});
+	}
+}
+
+void CommandInterpreter::SetAdmins(const std::vector<std::string>& names) {
+	admins_ = names;
+}
+
+void CommandInterpreter::EnableLoadTestCommands() {
+	core_command_map_["echo"] = std::bind(&CommandInterpreter::HandleEcho, this,
+		std::placeholders::_1, std::placeholders::_2);
+}
+
+bool CommandInterpreter::IsAdmin(ClientConnection* client) {
+	auto* player = ctx.registry->GetComponent<PlayerComponent>(client->playerEntityID);
+	if (!player) return false;
+	return std::find(admins_.begin(), admins_.end(), player->Name) != admins_.end();
 }
 void CommandInterpreter::RegisterCommands() {
 	core_command_map_["quit"] = std::bind(&CommandInterpreter::HandleQuit, this,
@@ -157,10 +241,20 @@ void CommandInterpreter::RegisterCommands() {
 	core_command_map_["pray"] = std::bind(&CommandInterpreter::HandleInteract, this,
 		std::placeholders::_1, std::placeholders::_2);
 
+	// Communication
+	core_command_map_["say"] = std::bind(&CommandInterpreter::HandleSay, this,
+		std::placeholders::_1, std::placeholders::_2);
+	core_command_map_["channel"] = std::bind(&CommandInterpreter::HandleChannel, this,
+		std::placeholders::_1, std::placeholders::_2);
+
 	// Hello packet handler for client capability detection (WebSocket/JSON clients)
 	core_command_map_["hello"] = std::bind(&CommandInterpreter::HandleHello, this,
 		std::placeholders::_1, std::placeholders::_2);
 
+	// Admin only (--admins)
+	admin_command_map_["profile"] = std::bind(&CommandInterpreter::HandleProfile, this,
+		std::placeholders::_1, std::placeholders::_2);
+
 }
 
 void CommandInterpreter::HandleQuit(ClientConnection* client, std::vector<std::string> input)
@@ -318,6 +412,69 @@ void CommandInterpreter::HandlePickup(ClientConnection* client, std::vector<std:
 }
 
 
+// Helper: Join words back into one line of text
+static std::string JoinWords(const std::vector<std::string>& words, size_t first) {
+	std::string text;
+	for (size_t i = first; i < words.size(); ++i) {
+		text += words[i];
+		if (i < words.size() - 1) text += " ";
+	}
+	return text;
+}
+
+static std::string SpeakerName(GameContext& ctx, EntityID playerID) {
+	auto* name = ctx.registry->GetComponent<NameComponent>(playerID);
+	return name ? name->displayName : "Someone";
+}
+
+void CommandInterpreter::HandleSay(ClientConnection* client, std::vector<std::string> input) {
+	if (input.empty()) {
+		client->QueueMessage("Say what?\r\n");
+		return;
+	}
+
+	EntityID playerID = client->playerEntityID;
+	auto* playerPos = ctx.registry->GetComponent<PositionComponent>(playerID);
+	if (!playerPos || !ctx.messages) return;
+
+	std::string text = JoinWords(input, 0);
+	client->QueueMessage("You say, '" + text + "'\r\n");
+	ctx.messages->ToRoom(playerPos->roomId, "&m" + SpeakerName(ctx, playerID) + " says, '" + text + "'&w\r\n", playerID);
+}
+
+// channel join <name> | channel leave <name> | channel <name> <message>
+void CommandInterpreter::HandleChannel(ClientConnection* client, std::vector<std::string> input) {
+	if (input.size() < 2 || !ctx.messages) {
+		client->QueueMessage("Usage: channel join|leave <name>, or channel <name> <message>\r\n");
+		return;
+	}
+
+	EntityID playerID = client->playerEntityID;
+	if (input[0] == "join") {
+		ctx.messages->JoinChannel(playerID, input[1]);
+		client->QueueMessage("You join the " + input[1] + " channel.\r\n");
+	}
+	else if (input[0] == "leave") {
+		ctx.messages->LeaveChannel(playerID, input[1]);
+		client->QueueMessage("You leave the " + input[1] + " channel.\r\n");
+	}
+	else {
+		ctx.messages->ToChannel(input[0], "&y[" + input[0] + "] " + SpeakerName(ctx, playerID) + ": " + JoinWords(input, 1) + "&w\r\n");
+	}
+}
+
+// echo <marker>: repeats the marker to the sender alone. Only registered with
+// --load-test; the load generator sends one after each command, so the reply
+// marks when that command's output left. Markers are short and alphanumeric
+// (plus ~ _ -), so nothing else is repeated back.
+void CommandInterpreter::HandleEcho(ClientConnection* client, std::vector<std::string> input) {
+	if (input.size() != 1 || input[0].empty() || input[0].size() > 32) return;
+	for (char c : input[0]) {
+		if (!std::isalnum(static_cast<unsigned char>(c)) && c != '~' && c != '_' && c != '-') return;
+	}
+	client->QueueMessage(input[0] + "\r\n");
+}
+
 void CommandInterpreter::HandleEquip(ClientConnection* client, std::vector<std::string> params) {
 	if (params.empty()) return;
 
@@ -353,41 +510,9 @@ void CommandInterpreter::HandleHello(ClientConnection* client, std::vector<std::
     try {
         json helloPacket = json::parse(jsonStr);
         
-        // Check if this is a valid hello packet
-        if (helloPacket.contains("type") && helloPacket["type"] == "hello") {
-            // Get the player's ClientComponent
-            ClientComponent* clientComp = ctx.registry->GetComponent<ClientComponent>(client->playerEntityID);
-            if (clientComp) {
-                // Parse features array
-                bool hasSideBar = false;
-                bool hasMiniMap = false;
-                
-                if (helloPacket.contains("features") && helloPacket["features"].is_array()) {
-                    for (const auto& feature : helloPacket["features"]) {
-                        std::string featureStr = feature.get<std::string>();
-                        if (featureStr == "sidebar") {
-                            hasSideBar = true;
-                        } else if (featureStr == "minimap") {
-                            hasMiniMap = true;
-                        }
-                    }
-                }
-                
-                // Update client capabilities - this is a web client
-                clientComp->SetCapabilities(true, hasSideBar, hasMiniMap);
-                
-                // Send acknowledgment
-                json response;
-                response["type"] = "hello_ack";
-                response["message"] = "Welcome! Your client capabilities have been registered.";
-                response["features_enabled"] = {
-                    {"sidebar", hasSideBar},
-                    {"minimap", hasMiniMap}
-                };
-                
-                client->QueueMessage(response.dump() + "\n");
-            }
-        }
+        json response;
+        response["message"] = "Welcome! Your client capabilities have been registered.";
+        ApplyHello(ctx, client, helloPacket, response);
     } catch (const json::exception& e) {
         // Invalid JSON, ignore or send error
         client->QueueMessage("Invalid hello packet format.\r\n");
@@ -406,47 +531,53 @@ bool CommandInterpreter::TryHandleJSONHandshake(ClientConnection* client, const
     try {
         json packet = json::parse(input);
         
-        // Check if this is a hello packet
-        if (packet.contains("type") && packet["type"] == "hello") {
-            // Get the player's ClientComponent
-            ClientComponent* clientComp = ctx.registry->GetComponent<ClientComponent>(client->playerEntityID);
-            if (clientComp) {
-                // Parse features array
-                bool hasSideBar = false;
-                bool hasMiniMap = false;
-                
-                if (packet.contains("features") && packet["features"].is_array()) {
-                    for (const auto& feature : packet["features"]) {
-                        std::string featureStr = feature.get<std::string>();
-                        if (featureStr == "sidebar") {
-                            hasSideBar = true;
-                        } else if (featureStr == "minimap") {
-                            hasMiniMap = true;
-                        }
-                    }
-                }
-                
-                // Update client capabilities - this is a web client
-                clientComp->SetCapabilities(true, hasSideBar, hasMiniMap);
-                
-                // Send acknowledgment
-                json response;
-                response["type"] = "hello_ack";
-                response["server"] = "ModularMudServer";
-                response["version"] = "1.0";
-                response["features_enabled"] = {
-                    {"sidebar", hasSideBar},
-                    {"minimap", hasMiniMap}
-                };
-                
-                client->QueueMessage(response.dump() + "\n");
-                return true; // Handled
-            }
-        }
+        json response;
+        response["server"] = "ModularMudServer";
+        response["version"] = "1.0";
+        return ApplyHello(ctx, client, packet, response);
     } catch (const json::exception& e) {
         // Not valid JSON or not a hello packet, continue with normal command processing
         return false;
     }
-    
-    return false;
-}
\ No newline at end of file
+}
+
+void CommandInterpreter::HandleProfile(ClientConnection* client, std::vector<std::string> input) {
+	TickProfiler& profiler = *ctx.profiler;
+	if (input.empty()) {
+		client->QueueMessage(profiler.Report());
+		return;
+	}
+
+	if (input[0] == "trace") {
+		// Written on the game thread between ticks, so every sample in the ring is complete
+		std::string name = input.size() > 1 ? input[1] : "profile-" + std::to_string(profiler.CurrentTick());
+		// A plain file name, kept under traces/ and ending in .json, so a trace
+		// can never land on the database, world data or the server binary
+		if (name.empty() || name.find_first_of("/\\:") != std::string::npos || name.find("..") != std::string::npos) {
+			client->QueueMessage("Trace file must be a plain file name.\r\n");
+			return;
+		}
+		if (name.size() < 5 || name.compare(name.size() - 5, 5, ".json") != 0) {
+			name += ".json";
+		}
+		std::error_code dirError;
+		std::filesystem::create_directories(TRACE_DIRECTORY, dirError);
+		std::string path = std::string(TRACE_DIRECTORY) + "/" + name;
+		if (profiler.WriteChromeTrace(path, false)) {
+			client->QueueMessage("Wrote Chrome trace to " + path + " (open in chrome://tracing or Perfetto).\r\n");
+		}
+		else if (std::filesystem::exists(path)) {
+			client->QueueMessage(path + " already exists; pick another name.\r\n");
+		}
+		else {
+			client->QueueMessage("Could not write " + path + ".\r\n");
+		}
+	}
+	else if (input[0] == "on" || input[0] == "off") {
+		profiler.SetEnabled(input[0] == "on");
+		client->QueueMessage(std::string("Profiling ") + (profiler.Enabled() ? "on" : "off") + ".\r\n");
+	}
+	else {
+		client->QueueMessage("Usage: profile [trace [file]|on|off]\r\n");
+	}
+}
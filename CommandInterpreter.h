@@ -22,8 +22,15 @@ public:
 	void Interpret(ClientConnection* client, Command* command);
 	
 	void RegisterCommands();
+	// Characters allowed to use admin commands; to everyone else they don't exist.
+	void SetAdmins(const std::vector<std::string>& names);
+	// --load-test: adds the "echo" command the load generator times responses with.
+	void EnableLoadTestCommands();
 private:
 	std::unordered_map<std::string, CommandFunction> core_command_map_;
+	std::unordered_map<std::string, CommandFunction> admin_command_map_;
+	std::vector<std::string> admins_;
+	bool IsAdmin(ClientConnection* client);
 	void HandleQuit(ClientConnection* client, std::vector<std::string> input);
 	void HandleAttack(ClientConnection* client, std::vector<std::string> input);
 	void HandleCast(ClientConnection* client, std::vector<std::string> input);
@@ -33,6 +40,10 @@ private:
 	void HandleMenu(ClientConnection* client, std::vector<std::string> input);
 	void HandleInteract(ClientConnection* client, std::vector<std::string> input);
 	void HandleHello(ClientConnection* client, std::vector<std::string> input);
+	void HandleSay(ClientConnection* client, std::vector<std::string> input);
+	void HandleChannel(ClientConnection* client, std::vector<std::string> input);
+	void HandleEcho(ClientConnection* client, std::vector<std::string> input);
+	void HandleProfile(ClientConnection* client, std::vector<std::string> input);
 	
 	// JSON Handshake handler for hybrid client detection
 	bool TryHandleJSONHandshake(ClientConnection* client, const std::string& input);
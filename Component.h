@@ -9,7 +9,6 @@
 #include "ClientComponent.h"
 #include "DirtyFlagComponents.h"
 #include "NameComponent.h"
-#include "PulseComponent.h"
 #include "VisualComponent.h"
 #include "RoomComponent.h"
 #include "ScriptComponent.h"
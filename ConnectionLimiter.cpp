@@ -0,0 +1,94 @@
+#include "ConnectionLimiter.h"
+#include <cstring>
+
+ConnectionLimiter::ConnectionLimiter(const ConnectionLimits& limits) : limits(limits) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    global.tokens = limits.globalBurst;
+    global.last = now;
+    nextPrune = now + std::chrono::seconds(60);
+    nextFullPrune = now;
+}
+
+bool ConnectionLimiter::Admit(const sockaddr_storage& peer) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (now >= nextPrune) {
+        PruneIdle(now);
+    }
+
+    // Per address first, so one flooding host can't use up the global budget.
+    if (limits.perIpRate > 0) {
+        uint64_t key = AddressKey(peer);
+        if (perIp.size() >= MAX_TRACKED_ADDRESSES && perIp.find(key) == perIp.end()) {
+            MakeRoom(now);
+        }
+        auto inserted = perIp.try_emplace(key);
+        TokenBucket& bucket = inserted.first->second;
+        if (inserted.second) {
+            bucket.tokens = limits.perIpBurst;
+            bucket.last = now;
+        }
+        if (!bucket.TryTake(now, limits.perIpRate, limits.perIpBurst)) {
+            refusedPerIp.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    if (limits.globalRate > 0 && !global.TryTake(now, limits.globalRate, limits.globalBurst)) {
+        refusedGlobal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+uint64_t ConnectionLimiter::AddressKey(const sockaddr_storage& peer) {
+    if (peer.ss_family == AF_INET) {
+        const sockaddr_in& v4 = reinterpret_cast<const sockaddr_in&>(peer);
+        return (1ull << 32) | ntohl(v4.sin_addr.s_addr);
+    }
+    if (peer.ss_family == AF_INET6) {
+        const sockaddr_in6& v6 = reinterpret_cast<const sockaddr_in6&>(peer);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&v6.sin6_addr);
+        // ::ffff:a.b.c.d is an IPv4 client on a dual-stack socket
+        static const unsigned char mappedPrefix[12] = { 0,0,0,0,0,0,0,0,0,0,0xff,0xff };
+        if (memcmp(bytes, mappedPrefix, sizeof(mappedPrefix)) == 0) {
+            return (1ull << 32) | (uint64_t(bytes[12]) << 24) | (uint64_t(bytes[13]) << 16) | (uint64_t(bytes[14]) << 8) | bytes[15];
+        }
+        uint64_t prefix = 0;
+        for (int i = 0; i < 8; i++) prefix = (prefix << 8) | bytes[i];
+        // A /64 starting with 0x0000'0001 would collide with the IPv4 keys; those are reserved anyway
+        return prefix;
+    }
+    return 0;
+}
+
+void ConnectionLimiter::MakeRoom(std::chrono::steady_clock::time_point now) {
+    // A spray of fresh addresses keeps the table full of buckets that are still
+    // refilling. Scanning for idle ones on every accept would make the limiter
+    // the bottleneck, so scan at most once a second and otherwise evict one
+    // bucket. The evicted address starts over with a full burst; the global
+    // bucket still caps the total.
+    if (now >= nextFullPrune) {
+        nextFullPrune = now + std::chrono::seconds(1);
+        PruneIdle(now);
+        if (perIp.size() < MAX_TRACKED_ADDRESSES) return;
+    }
+    perIp.erase(perIp.begin());
+    evicted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConnectionLimiter::PruneIdle(std::chrono::steady_clock::time_point now) {
+    nextPrune = now + std::chrono::seconds(60);
+
+    // A bucket that would be full again carries no history worth keeping.
+    for (auto it = perIp.begin(); it != perIp.end();) {
+        double idle = std::chrono::duration<double>(now - it->second.last).count();
+        if (it->second.tokens + idle * limits.perIpRate >= limits.perIpBurst) {
+            it = perIp.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
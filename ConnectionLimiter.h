@@ -0,0 +1,73 @@
+#pragma once
+#include "SocketPlatform.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+// Classic token bucket: refills at 'rate' tokens per second up to 'burst'.
+struct TokenBucket {
+    double tokens = 0.0;
+    std::chrono::steady_clock::time_point last;
+
+    bool TryTake(std::chrono::steady_clock::time_point now, double rate, double burst) {
+        double elapsed = std::chrono::duration<double>(now - last).count();
+        last = now;
+        tokens += elapsed * rate;
+        if (tokens > burst) tokens = burst;
+        if (tokens < 1.0) return false;
+        tokens -= 1.0;
+        return true;
+    }
+};
+
+// New connections allowed per second; a rate of 0 turns that limit off.
+struct ConnectionLimits {
+    double perIpRate = 0.5;       // One every two seconds per address...
+    double perIpBurst = 8;        // ...after a burst of 8 (reconnect loops, shared NAT)
+    double globalRate = 100;
+    double globalBurst = 300;     // Reconnect storm after a restart
+};
+
+/**
+ * @class ConnectionLimiter
+ * @brief Rate limits new connections per source address and for the whole server.
+ *
+ * Shared by every I/O shard and consulted right after accept, before anything
+ * is allocated for the connection. IPv4 addresses are limited individually
+ * and IPv6 ones by /64, since one host usually owns a whole /64. Buckets that
+ * have refilled completely are pruned once a minute, so the table only holds
+ * recently active addresses. If it still fills up, a new address evicts an
+ * arbitrary bucket rather than triggering a rescan on every accept.
+ */
+class ConnectionLimiter {
+public:
+    explicit ConnectionLimiter(const ConnectionLimits& limits = ConnectionLimits());
+
+    // Any network thread.
+    bool Admit(const sockaddr_storage& peer);
+
+    uint64_t RefusedPerIp() const { return refusedPerIp.load(std::memory_order_relaxed); }
+    uint64_t RefusedGlobal() const { return refusedGlobal.load(std::memory_order_relaxed); }
+    // Buckets dropped because the table was full of active addresses.
+    uint64_t Evicted() const { return evicted.load(std::memory_order_relaxed); }
+
+private:
+    static uint64_t AddressKey(const sockaddr_storage& peer);
+    void PruneIdle(std::chrono::steady_clock::time_point now);
+    // The table is full and a new address arrived: frees one slot.
+    void MakeRoom(std::chrono::steady_clock::time_point now);
+
+    static const size_t MAX_TRACKED_ADDRESSES = 65536;
+
+    ConnectionLimits limits;
+    std::mutex mutex;                    // Guards the buckets
+    TokenBucket global;
+    std::unordered_map<uint64_t, TokenBucket> perIp;
+    std::chrono::steady_clock::time_point nextPrune;
+    std::chrono::steady_clock::time_point nextFullPrune;
+    std::atomic<uint64_t> refusedPerIp{ 0 };
+    std::atomic<uint64_t> refusedGlobal{ 0 };
+    std::atomic<uint64_t> evicted{ 0 };
+};
@@ -0,0 +1,87 @@
+#include "DeflateStream.h"
+#include <zlib.h>
+#include <cstdio>
+
+DeflateStream::~DeflateStream() {
+    Close();
+}
+
+bool DeflateStream::Init(int level, size_t memoryBudget, bool raw, int maxWindowBits) {
+    if (stream) return true;
+
+    // Shrink whichever half of the state is larger until it fits. zlib treats a
+    // window of 8 as 9, so 9 is the floor.
+    windowBits = maxWindowBits < 15 ? maxWindowBits : 15;
+    if (windowBits < 9) windowBits = 9;
+    int memLevel = 8;
+    auto cost = [&]() { return (size_t(1) << (windowBits + 2)) + (size_t(1) << (memLevel + 9)); };
+    while (cost() > memoryBudget && (windowBits > 9 || memLevel > 1)) {
+        if (windowBits > 9 && (windowBits + 2) >= (memLevel + 9)) windowBits--;
+        else if (memLevel > 1) memLevel--;
+        else windowBits--;
+    }
+
+    stream = new z_stream();
+    if (deflateInit2(stream, level, Z_DEFLATED, raw ? -windowBits : windowBits, memLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+        printf("deflateInit2 failed\n");
+        delete stream;
+        stream = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool DeflateStream::Compress(const char* data, size_t length, bool flush, std::string& out) {
+    if (!stream) return false;
+
+    stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream->avail_in = static_cast<uInt>(length);
+    rawBytes += length;
+
+    int mode = flush ? Z_SYNC_FLUSH : Z_NO_FLUSH;
+    do {
+        size_t before = out.size();
+        size_t room = deflateBound(stream, static_cast<uLong>(stream->avail_in)) + 16;
+        out.resize(before + room);
+        stream->next_out = reinterpret_cast<Bytef*>(&out[before]);
+        stream->avail_out = static_cast<uInt>(room);
+
+        int result = deflate(stream, mode);
+        size_t produced = room - stream->avail_out;
+        out.resize(before + produced);
+        compressedBytes += produced;
+
+        if (result == Z_STREAM_ERROR) return false;
+    } while (stream->avail_in > 0 || stream->avail_out == 0);
+
+    return true;
+}
+
+void DeflateStream::Finish(std::string& out) {
+    if (!stream) return;
+
+    stream->next_in = nullptr;
+    stream->avail_in = 0;
+    int result;
+    do {
+        size_t before = out.size();
+        out.resize(before + 256);
+        stream->next_out = reinterpret_cast<Bytef*>(&out[before]);
+        stream->avail_out = 256;
+        result = deflate(stream, Z_FINISH);
+        out.resize(before + (256 - stream->avail_out));
+    } while (result == Z_OK);
+
+    Close();
+}
+
+void DeflateStream::Reset() {
+    if (stream) deflateReset(stream);
+}
+
+void DeflateStream::Close() {
+    if (!stream) return;
+    deflateEnd(stream);
+    delete stream;
+    stream = nullptr;
+}
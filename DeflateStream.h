@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+typedef struct z_stream_s z_stream;
+
+/**
+ * @class DeflateStream
+ * @brief One long-lived zlib compressor sized to a per-connection memory budget.
+ *
+ * Shared by MCCP2 (zlib framing) and WebSocket permessage-deflate (raw deflate).
+ * deflate needs (1 << (windowBits + 2)) + (1 << (memLevel + 9)) bytes of state,
+ * so Init shrinks the window and hash sizes until that fits the budget.
+ */
+class DeflateStream {
+public:
+    DeflateStream() = default;
+    ~DeflateStream();
+
+    DeflateStream(const DeflateStream&) = delete;
+    DeflateStream& operator=(const DeflateStream&) = delete;
+
+    // raw: no zlib header/trailer (permessage-deflate). maxWindowBits caps the
+    // window below what the budget allows (a peer may demand a smaller one).
+    bool Init(int level, size_t memoryBudget, bool raw = false, int maxWindowBits = 15);
+    bool IsOpen() const { return stream != nullptr; }
+    int WindowBits() const { return windowBits; }
+
+    // Appends the compressed form of 'data' to 'out'. flush ends with a sync
+    // flush, so the peer can decode everything written so far.
+    bool Compress(const char* data, size_t length, bool flush, std::string& out);
+    // Ends the stream (Z_FINISH) into 'out' and frees the zlib state.
+    void Finish(std::string& out);
+    // Forgets the history (no context takeover) without reallocating.
+    void Reset();
+
+    uint64_t rawBytes = 0;          // Before compression
+    uint64_t compressedBytes = 0;   // After compression
+
+private:
+    void Close();
+
+    z_stream* stream = nullptr;
+    int windowBits = 15;
+};
@@ -10,7 +10,7 @@ public:
 	DialogueState();
 	~DialogueState();
 
-	void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+	void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
 	
 		if (input >= KEY_1 && input <= KEY_4) {
 			int choice = input - KEY_1;
@@ -0,0 +1,100 @@
+#include "EpollReactor.h"
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <cstdio>
+#include <cstdint>
+
+EpollReactor::EpollReactor() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        printf("epoll_create1 failed with error: %d\n", errno);
+        return;
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        printf("eventfd failed with error: %d\n", errno);
+        return;
+    }
+
+    // The wake fd is identified by a null data.ptr; it stays level-triggered so a
+    // Wake() that races with Wait() is never lost.
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) == -1) {
+        printf("epoll_ctl ADD (wake) failed with error: %d\n", errno);
+        close(wakeFd);
+        wakeFd = -1;
+    }
+}
+
+EpollReactor::~EpollReactor() {
+    if (wakeFd != -1) close(wakeFd);
+    if (epollFd != -1) close(epollFd);
+}
+
+bool EpollReactor::Add(SOCKET socket, void* userData) {
+    auto reg = std::make_unique<Registration>(Registration{ socket, userData });
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = reg.get();
+
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &ev) == -1) {
+        printf("epoll_ctl ADD failed with error: %d\n", errno);
+        return false;
+    }
+
+    registrations[socket] = std::move(reg);
+    return true;
+}
+
+void EpollReactor::Remove(SOCKET socket) {
+    auto it = registrations.find(socket);
+    if (it == registrations.end()) return;
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+    registrations.erase(it);
+}
+
+int EpollReactor::Wait(std::vector<ReactorEvent>& out, int timeoutMs) {
+    out.clear();
+
+    epoll_event events[MAX_EVENTS];
+    int count = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+    if (count == -1) {
+        return SocketPlatform::Interrupted(errno) ? 0 : -1;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const epoll_event& ev = events[i];
+
+        if (ev.data.ptr == nullptr) {
+            // Drain the eventfd counter; the caller just needs to return from Wait.
+            uint64_t value;
+            while (read(wakeFd, &value, sizeof(value)) > 0) {}
+            continue;
+        }
+
+        const Registration* reg = static_cast<const Registration*>(ev.data.ptr);
+        ReactorEvent result;
+        result.socket = reg->socket;
+        result.userData = reg->userData;
+        result.readable = (ev.events & EPOLLIN) != 0;
+        result.writable = (ev.events & EPOLLOUT) != 0;
+        result.hangup = (ev.events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) != 0;
+        out.push_back(result);
+    }
+
+    return static_cast<int>(out.size());
+}
+
+void EpollReactor::Wake() {
+    uint64_t one = 1;
+    // EAGAIN here means the counter is already non-zero, which is just as good.
+    (void)write(wakeFd, &one, sizeof(one));
+}
+
+#endif
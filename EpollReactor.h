@@ -0,0 +1,40 @@
+#pragma once
+#ifdef __linux__
+#include "IEventReactor.h"
+#include <unordered_map>
+
+/**
+ * @class EpollReactor
+ * @brief Edge-triggered epoll backend for Linux.
+ *
+ * Every socket is registered once for EPOLLIN | EPOLLOUT | EPOLLET, so the
+ * kernel only reports state transitions and the server never re-arms interest.
+ * Cross-thread wakeups go through an eventfd registered alongside the sockets.
+ */
+class EpollReactor : public IEventReactor {
+public:
+    EpollReactor();
+    ~EpollReactor() override;
+
+    bool Add(SOCKET socket, void* userData) override;
+    void Remove(SOCKET socket) override;
+    int Wait(std::vector<ReactorEvent>& out, int timeoutMs) override;
+    void Wake() override;
+    bool IsEdgeTriggered() const override { return true; }
+    // False if the epoll instance or its wake eventfd could not be set up.
+    bool IsOpen() const { return epollFd != -1 && wakeFd != -1; }
+
+private:
+    struct Registration {
+        SOCKET socket;
+        void* userData;
+    };
+
+    static const int MAX_EVENTS = 256;
+
+    int epollFd = -1;
+    int wakeFd = -1;
+    // Stable addresses handed to the kernel as epoll_event.data.ptr.
+    std::unordered_map<SOCKET, std::unique_ptr<Registration>> registrations;
+};
+#endif
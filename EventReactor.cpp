@@ -0,0 +1,20 @@
+#include "IEventReactor.h"
+#include "SelectReactor.h"
+#ifdef __linux__
+#include "EpollReactor.h"
+#endif
+
+std::unique_ptr<IEventReactor> CreateEventReactor(NetworkBackend backend) {
+    if (backend == NetworkBackend::Select) {
+        return std::make_unique<SelectReactor>();
+    }
+#ifdef __linux__
+    auto reactor = std::make_unique<EpollReactor>();
+    if (!reactor->IsOpen()) {
+        return nullptr;
+    }
+    return reactor;
+#else
+    return std::make_unique<SelectReactor>();
+#endif
+}
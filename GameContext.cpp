@@ -7,6 +7,12 @@
 #include "SQLiteDatabase.h"
 #include "TimeData.h"
 #include "FactoryManager.h"
+#include "SessionTable.h"
+#include "AuthService.h"
+#include "JobSystem.h"
+#include "TimerWheel.h"
+#include "RoomActivity.h"
+#include "TickProfiler.h"
 
 // Define destructor in .cpp where all types are complete
 GameContext::~GameContext() = default;
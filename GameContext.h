@@ -10,6 +10,13 @@ class Registry;
 class FactoryManager;
 class CommandInterpreter;
 class RespawnSystem;
+class SessionTable;
+class MessageSystem;
+class AuthService;
+class JobSystem;
+class TimerWheel;
+class RoomActivity;
+class TickProfiler;
 struct TimeData;
 
 struct GameContext {
@@ -21,7 +28,14 @@ struct GameContext {
     std::unique_ptr<TimeData> time;
     std::unique_ptr<FactoryManager> factories;
     std::unique_ptr<CommandInterpreter> interpreter;
+    std::unique_ptr<SessionTable> sessions;  // Live connections by SessionID
+    std::unique_ptr<AuthService> auth;       // Login/account work off the game thread
+    std::unique_ptr<JobSystem> jobs;         // Workers for the tick's parallel systems and loops
+    std::unique_ptr<TimerWheel> timers;      // Every countdown (busy, respawns, windups), in game time
+    std::unique_ptr<RoomActivity> activity;  // Which rooms have players; dormant rooms hold their timers
+    std::unique_ptr<TickProfiler> profiler;  // Timings of systems, Lua and DB calls (admin "profile")
     RespawnSystem* respawnSystem;  // Not owned by GameContext, just a pointer
+    MessageSystem* messages = nullptr;  // Not owned; room/global/channel broadcasts
 
     ~GameContext();
     GameContext();
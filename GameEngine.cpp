@@ -29,26 +29,56 @@
 #include "TimeData.h"
 #include "ClientInput.h"
 #include "GameState.h"
-#include "picosha2.h"
+#include "SessionTable.h"
+#include "LineFramer.h"
+#include "AuthService.h"
+#include "MainMenuState.h"
+#include "SystemScheduler.h"
+#include "JobSystem.h"
+#include "TimerWheel.h"
+#include "RoomActivity.h"
+#include "TickProfiler.h"
+#include "InputRecording.h"
+#include "Component.h"
+#include "InteractableIntentComponent.h"
+#include "RegionComponent.h"
+#include <algorithm>
+
+
+GameEngine::GameEngine(GameContext& ctx, MpscQueue<ClientInput>& input, const std::string& databasePath) : gameContext(ctx), isRunning(true) {
+    inputQueues.push_back(&input);
 
-GameEngine::GameEngine(GameContext& ctx, ThreadSafeQueue<ClientInput>& input) : gameContext(ctx), isRunning(true), inputQueue(input) {
     // 1. Initialize core resources
+    gameContext.profiler = std::make_unique<TickProfiler>();
+    TickProfiler* profiler = gameContext.profiler.get();
+    profileInput = profiler->Intern("input");
+    profileUpdate = profiler->Intern("update");
+    profileOutput = profiler->Intern("output");
     world = new World();
     gameContext.registry = std::make_unique<Registry>();
     gameContext.eventBus = std::make_unique<EventBus>();
-    gameContext.scripts = std::make_unique<ScriptManager>(*gameContext.registry);
+    gameContext.sessions = std::make_unique<SessionTable>();
+    gameContext.scripts = std::make_unique<ScriptManager>(*gameContext.registry, *gameContext.sessions);
+    gameContext.scripts->profiler = profiler;
     gameContext.worldManager = std::make_unique<WorldManager>(world);
     gameContext.scripts->init();
     gameContext.scripts->load_all_scripts("scripts");
     gameContext.scripts->lua.script("print('Hello from Lua')");
     scriptEventBridge = new ScriptEventBridge(gameContext.eventBus.get(), gameContext.scripts.get());
     gameContext.db = std::make_unique<SQLiteDatabase>();
-	gameContext.db->Connect("mud.db");
+    gameContext.db->SetProfiler(profiler);
+	gameContext.db->Connect(databasePath);
+    // Workers are started from main once the command line is parsed
+    gameContext.auth = std::make_unique<AuthService>(databasePath);
+    // Serial until main starts the workers
+    gameContext.jobs = std::make_unique<JobSystem>();
 
 
     // 3. Link the manager back to the context
 
     gameContext.time = std::make_unique<TimeData>();
+    gameContext.timers = std::make_unique<TimerWheel>();
+    gameContext.activity = std::make_unique<RoomActivity>(gameContext);
     gameContext.factories = std::make_unique<FactoryManager>(gameContext);
     gameContext.interpreter = std::make_unique<CommandInterpreter>(gameContext);
     // 3. initialize systems 
@@ -63,8 +93,12 @@ GameEngine::GameEngine(GameContext& ctx, ThreadSafeQueue<ClientInput>& input) :
     gameContext.respawnSystem = respawnSystem;  // Make accessible via GameContext
     interactionSystem = new InteractionSystem(gameContext);
     messageSytem = new MessageSystem(gameContext);
+    gameContext.messages = messageSytem;
     saveSystem = new SaveSystem(gameContext);
     cleanSystem = new CleanUpSystem(gameContext);
+    systemScheduler = new SystemScheduler(*gameContext.registry, *gameContext.jobs);
+    systemScheduler->SetProfiler(profiler);
+    RegisterSystems();
 
     // Add and global entity as 1
     gameContext.registry->CreateEntity();
@@ -81,7 +115,8 @@ GameEngine::GameEngine(GameContext& ctx, ThreadSafeQueue<ClientInput>& input) :
 
 GameEngine::~GameEngine()
 {
-    // Clean up all systems allocated with new
+    // Clean up all systems allocated with new; the job workers are idle between ticks
+    delete systemScheduler;
     delete movementSystem;
     delete networkSystem;
     delete networkSyncSystem;
@@ -96,36 +131,12 @@ GameEngine::~GameEngine()
     delete cleanSystem;
     delete scriptEventBridge;
     delete world;
+    delete recorder;
     
     // Factories are managed by FactoryManager which is in GameContext
     // GameContext's unique_ptrs will be automatically cleaned up
 }
 
-std::string GenerateSalt(int length = 16) {
-    const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!@#$%^&*";
-
-    // Setup random number generator securely
-    std::default_random_engine rng(std::random_device{}());
-    std::uniform_int_distribution<> dist(0, sizeof(charset) - 2);
-
-    std::string salt;
-    for (int i = 0; i < length; ++i) {
-        salt += charset[dist(rng)];
-    }
-    return salt;
-}
-
-int GameEngine::CreatePlayer(ClientConnection* clientID, std::string username, std::string password,PlayerData playerData) {
-    std::string salt = GenerateSalt();
-    std::string combined = password + salt;
-    std::string hash = picosha2::hash256_hex_string(combined);
-
-    int newID = gameContext.db->CreatePlayerRow(username, hash, salt);
-    return newID;
-}
-
-
-
 int GameEngine::LoadPlayer(ClientConnection* socket, std::string username) {
     // The Factory handles checking the DB and attaching all components
     EntityID id = gameContext.factories->player.LoadPlayer(username, socket);
@@ -134,11 +145,24 @@ int GameEngine::LoadPlayer(ClientConnection* socket, std::string username) {
         printf("Failed to load or create player %s\n", username.c_str());
         return -1;
     }
+    return EnterWorld(socket, id, username);
+}
+
+int GameEngine::SpawnPlayer(ClientConnection* socket, const PlayerData& data) {
+    // The row was read by an AuthService worker; only the ECS work is left for the tick
+    EntityID id = gameContext.factories->player.SpawnPlayer(data, socket);
+    return EnterWorld(socket, id, data.name);
+}
+
+int GameEngine::EnterWorld(ClientConnection* socket, int id, const std::string& username) {
+    gameContext.sessions->BindEntity(socket->clientID, id);
 
     ClientComponent* client = gameContext.registry->GetComponent<ClientComponent>(id);
     if (client) {
+        int roomId = gameContext.registry->GetComponent<PositionComponent>(id)->roomId;
+        gameContext.messages->EnterRoom(id, roomId);
         EventContext ectx;
-        ectx.data = RoomEventData{ id, gameContext.registry->GetComponent<PositionComponent>(id)->roomId };
+        ectx.data = RoomEventData{ id, roomId };
         gameContext.eventBus->Publish(EventType::RoomEntered, ectx);
         gameContext.registry->AddComponent<PositionChangedComponent>(id);
     }
@@ -153,53 +177,248 @@ void GameEngine::Update(float deltaTime) {
     gameContext.time->deltaTime = deltaTime;
     gameContext.time->globalTime += (double)deltaTime;
 
-    movementSystem->MovementSystemRun();
-    interactionSystem->run();
-    networkSyncSystem->Run();
-    invSystem->Run(deltaTime);
-    combatSystem->run();
-    updateSystem->Update(deltaTime);
-    respawnSystem->Update(deltaTime);
-    gameContext.eventBus->CallDefferedCalls();
-    cleanSystem->run();
-    saveSystem->Run(deltaTime);
+    {
+        ProfileScope scope(gameContext.profiler.get(), profileUpdate);
+        systemScheduler->Run(deltaTime);
+    }
+
+    ProfileScope scope(gameContext.profiler.get(), profileOutput);
+    FinishTickOutput();
+}
+
+void GameEngine::RegisterSystems() {
+    // Listed in the order they ran before the scheduler, except that network
+    // sync now runs last, so looks and vitals show this tick's moves and hits.
+    // Systems that share any data still run in this order. Most of them publish
+    // events or run Lua, which can reach anything, so they run alone.
+    SystemScheduler& s = *systemScheduler;
+    s.Add("movement", SystemAccess()
+        .Writes<MoveIntentComponent, PositionComponent, PositionChangedComponent>()
+        .Reads<PortalComponent, ScriptComponent, ClientComponent>()
+        .Uses(SystemResource::World).Uses(SystemResource::Events).Uses(SystemResource::Scripts).Uses(SystemResource::Output),
+        [this](float) { movementSystem->MovementSystemRun(); });
+    s.Add("interaction", SystemAccess()
+        .Writes<PickupItemIntentComponent, InteractableIntentComponent, InventoryComponent, PositionComponent>()
+        .Writes<PositionChangedComponent, InventoryChangedComponent, StatComponent, VitalsChangedComponent>()
+        .Reads<ClientComponent, ScriptComponent>()
+        .Uses(SystemResource::World).Uses(SystemResource::Scripts).Uses(SystemResource::Entities).Uses(SystemResource::Output),
+        [this](float) { interactionSystem->run(); });
+    s.Add("inventory", SystemAccess()
+        .Writes<EquipItemIntentComponent, EquipmentComponent, InventoryComponent, SkillHolderComponent, InventoryChangedComponent>()
+        .Writes<StatComponent, StatModifierComponent>()
+        .Reads<ArmourComponent, BaseStatComponent, ItemComponent, WeaponComponent>()
+        .Uses(SystemResource::Events),
+        [this](float dt) { invSystem->Run(dt); });
+    s.Add("combat", SystemAccess()
+        .Writes<CombatIntentComponent, BusyComponent, DeadTag, StatComponent, VitalsChangedComponent>()
+        .Reads<ClientComponent, MobComponent, NameComponent>()
+        .Uses(SystemResource::Events).Uses(SystemResource::Output).Uses(SystemResource::Timers),
+        [this](float) { combatSystem->run(); });
+    // Wakes rooms players walked into (running the work they held) and puts
+    // empty ones to sleep, before this tick's timers fire.
+    s.Add("room activity", SystemAccess()
+        .Reads<PlayerComponent, PositionComponent>()
+        .Uses(SystemResource::Timers).Uses(SystemResource::Entities),
+        [this](float) { gameContext.activity->Update(); });
+    // Busy, scheduled events, windups and respawns: whatever is due on
+    // the wheel. Callbacks can run scripts and spawn mobs, so this runs alone.
+    s.Add("timers", SystemAccess()
+        .Uses(SystemResource::Timers).Uses(SystemResource::Entities).Uses(SystemResource::Scripts),
+        [this](float) { updateSystem->Update(); });
+    s.Add("respawn", SystemAccess()
+        .Writes<RespawnComponent, DeadTag, DestroyTag>()
+        .Uses(SystemResource::Timers).Uses(SystemResource::Entities),
+        [this](float) { respawnSystem->Update(); });
+    s.Add("deferred events", SystemAccess().Uses(SystemResource::Events),
+        [this](float) { gameContext.eventBus->CallDefferedCalls(); });
+    s.Add("cleanup", SystemAccess().Reads<DestroyTag>().Uses(SystemResource::Entities),
+        [this](float) { cleanSystem->run(); });
+    // The last two only read stats and positions, and share nothing else, so
+    // they form the one stage where two systems run at once.
+    s.Add("network sync", SystemAccess()
+        .Writes<PlayerLoginComponent, PositionChangedComponent, VitalsChangedComponent>()
+        .Reads<ClientComponent, PositionComponent, StatComponent, VisualComponent>()
+        .Uses(SystemResource::World).Uses(SystemResource::Output),
+        [this](float) { networkSyncSystem->Run(); });
+    s.Add("save", SystemAccess()
+        .Writes<StatsChangedComponent, InventoryChangedComponent, MutationsChangedComponent>()
+        .Reads<StatComponent, InventoryComponent, EquipmentComponent, ItemComponent, BodyComponent>()
+        .Reads<PlayerComponent, PositionComponent, RegionComponent>()
+        .Uses(SystemResource::Database),
+        [this](float dt) { saveSystem->Run(dt); });
+}
+
+void GameEngine::SetSystemThreads(int count) {
+    gameContext.jobs->Start(count);
+    systemScheduler->LogGraph();
+}
+
+bool GameEngine::StartRecording(const std::string& path, int tickRate) {
+    if (!recorder) recorder = new InputRecorder();
+    if (!recorder->Open(path, tickRate)) {
+        printf("[Record] Could not open %s\n", path.c_str());
+        return false;
+    }
+    printf("[Record] Recording input to %s\n", path.c_str());
+    return true;
+}
+
+void GameEngine::SeedRandom(uint32_t seed) {
+    gameContext.factories->loot.Seed(seed);
+    gameContext.scripts->lua["math"]["randomseed"](seed);
+}
+
+void GameEngine::FinishTickOutput() {
+    // GameMessages queued by the systems this tick, rendered per client type
+    networkSystem->FlushQueues();
+
+    size_t congestedClients = 0;
+    BackpressureCounters totals = departedBackpressure;
+
+    gameContext.sessions->ForEach([&](ClientConnection* client) {
+        if (client->evicted) return;
+        if (!client->UpdateBackpressure(backpressureLimits)) {
+            evictedClients++;
+        }
+        else if (client->IsCongested()) {
+            congestedClients++;
+        }
+        // This tick's output is complete; the network thread flushes it as one unit.
+        client->ReleaseOutput();
+        const BackpressureCounters& counters = client->GetBackpressure();
+        totals.congestionEpisodes += counters.congestionEpisodes;
+        totals.congestedTicks += counters.congestedTicks;
+        totals.coalescedFrames += counters.coalescedFrames;
+    });
+
+    if (time >= nextBackpressureLog) {
+        nextBackpressureLog = time + 60.0f;
+        printf("[Net] backpressure: %zu congested now, %llu episodes, %llu congested ticks, %llu frames coalesced, %llu evicted\n",
+            congestedClients, (unsigned long long)totals.congestionEpisodes, (unsigned long long)totals.congestedTicks,
+            (unsigned long long)totals.coalescedFrames, (unsigned long long)evictedClients);
+    }
 }
 
 const bool GameEngine::IsRunning() { return isRunning; }
 
 ClientConnection* GameEngine::GetClientById(int clientId) {
-	auto view = gameContext.registry->view<ClientComponent>();
-	for (EntityID entity : view) {
-		ClientComponent* client = gameContext.registry->GetComponent<ClientComponent>(entity);
-		if (client && client->client && client->client->clientID == clientId) {
-            return client->client;
-		}
-	}
+    return gameContext.sessions->Get(clientId);
 }
 
-void GameEngine::ProcessInputs() {
-    ClientInput input;
-
-    // "TryPop" returns true if it got data, false if empty.
-    // We loop until the queue is empty so we handle ALL commands 
-    // that arrived since the last frame.
-    while (inputQueue.TryPop(&input)) {
-
-        // 1. Find which Entity belongs to this Client
-        // (You likely have a helper or map for this)
-        ClientConnection* client = GetClientById(input.clientID);
-
-        std::vector<std::string> inputStringVector;
-        std::stringstream ss(input.rawText);
-        std::string token;
-        while (ss >> token) {
-            inputStringVector.push_back(token);
+int GameEngine::GetEntityByClient(int clientId) {
+    return gameContext.sessions->GetEntity(clientId);
+}
+
+void GameEngine::ReapClosedSessions() {
+    retiredClients.clear();
+    gameContext.sessions->TakeRetired(retiredClients);
+
+    // The network thread has already dropped these; finish the teardown here,
+    // on the thread that owns the registry and the game states.
+    for (ClientConnection* client : retiredClients) {
+        if (recorder) recorder->RecordClose(gameContext.profiler->CurrentTick(), client->clientID);
+        if (client->playerEntityID != -1) {
+            gameContext.messages->RemoveClient(client->playerEntityID);
+            gameContext.registry->RemoveComponent<ClientComponent>(client->playerEntityID);
         }
+        const BackpressureCounters& counters = client->GetBackpressure();
+        departedBackpressure.congestionEpisodes += counters.congestionEpisodes;
+        departedBackpressure.congestedTicks += counters.congestedTicks;
+        departedBackpressure.coalescedFrames += counters.coalescedFrames;
+        delete client;
+    }
+}
 
-        if (!inputStringVector.empty() && client && !client->stateStack.empty()) {
-            client->stateStack.top()->HandleInput(client, inputStringVector);
+void GameEngine::StartNewSessions() {
+    openedSessions.clear();
+    gameContext.sessions->TakeOpened(openedSessions);
+
+    // The first game state is pushed here rather than on the network thread, so
+    // the menu is queued by the game thread like all other output.
+    for (SessionID id : openedSessions) {
+        ClientConnection* client = GetClientById(id);
+        if (!client || !client->stateStack.empty()) continue;
+        if (recorder) recorder->RecordOpen(gameContext.profiler->CurrentTick(), id);
+        client->PushState(new MainMenuState());
+        printf("New client connected with ID: %d\n", id);
+    }
+}
+
+void GameEngine::ApplyAuthResults() {
+    AuthService* auth = gameContext.auth.get();
+    authResults.clear();
+    auth->TakeResults(authResults);
+
+    for (const AuthResult& result : authResults) {
+        // The client may have disconnected while the request was running
+        ClientConnection* client = GetClientById(result.session);
+        bool delivered = client && !client->stateStack.empty();
+        if (delivered) {
+            client->stateStack.top()->OnAuthResult(client, result);
         }
+        auth->RecordApplied(result, delivered);
     }
+    auth->LogStatsIfDue();
+}
+
+void GameEngine::ProcessInputs() {
+    // The tick starts here; every scope below is filed under it
+    gameContext.profiler->BeginTick();
+    ProfileScope scope(gameContext.profiler.get(), profileInput);
+
+    ReapClosedSessions();
+    StartNewSessions();
+    // Logins finished since the last tick enter the world before this tick's input
+    ApplyAuthResults();
+
+    size_t shardCount = inputQueues.size();
+    if (shardCount == 0) return;
+    inputBatches.resize(shardCount);
+
+    // Handle every command that arrived since the last frame. Each shard's
+    // backlog is drained in one batch first, so a shard that keeps receiving
+    // can't stretch the tick. The batches are then interleaved one command at a
+    // time so a busy shard can't starve the others. The starting shard rotates
+    // so no shard always goes first.
+    size_t longest = 0;
+    for (size_t i = 0; i < shardCount; i++) {
+        inputBatches[i].clear();
+        inputQueues[i]->PopBatch(inputBatches[i], inputQueues[i]->Capacity());
+        longest = (std::max)(longest, inputBatches[i].size());
+    }
+
+    size_t start = nextInputShard++ % shardCount;
+    for (size_t n = 0; n < longest; n++) {
+        for (size_t k = 0; k < shardCount; k++) {
+            std::vector<ClientInput>& batch = inputBatches[(start + k) % shardCount];
+            if (n < batch.size()) {
+                HandleClientInput(batch[n]);
+            }
+        }
+    }
+    if (recorder) recorder->Flush();
+}
+
+void GameEngine::HandleClientInput(const ClientInput& input) {
+    // Recorded as it arrived, even if the connection has gone; a replay drops it the same way
+    if (recorder) recorder->RecordInput(gameContext.profiler->CurrentTick(), input.clientID, input.rawText);
+
+    // 1. Find the connection (nullptr if it closed since the line was queued)
+    ClientConnection* client = GetClientById(input.clientID);
+    if (!client || client->stateStack.empty()) return;
+
+    // 2. Tokenize into views of the line, then copy into the reused word vector;
+    // its strings keep their capacity, so steady-state input doesn't allocate.
+    TokenizeLine(input.rawText, inputTokens);
+    if (inputTokens.empty()) return;
+
+    inputWords.resize(inputTokens.size());
+    for (size_t i = 0; i < inputTokens.size(); i++) {
+        inputWords[i].assign(inputTokens[i].data(), inputTokens[i].size());
+    }
+
+    // 3. Pass to the active Game State (Menu or Playing)
+    client->stateStack.top()->HandleInput(client, inputWords);
 }
 
 // Allow the game to close itself (e.g., from a "shutdown" command)
@@ -2,10 +2,14 @@
 #include <iostream>
 #include <ctime>
 #include <string>
-#include "ThreadSafeQueue.h"
+#include <vector>
+#include <string_view>
+#include "MpscQueue.h"
+#include "OutboundBuffer.h"
 
 // Minimal includes - only what's absolutely necessary
 struct PlayerData;
+struct AuthResult;
 
 // Forward declarations
 class Registry;
@@ -34,15 +38,19 @@ class CommandInterpreter;
 class MessageSystem;
 class SaveSystem;
 class RespawnSystem;
+class SystemScheduler;
 struct TimeData;
 struct ClientInput;
+class InputRecorder;
 class GameEngine
 {
 public:
-	GameEngine(GameContext& ctx, ThreadSafeQueue<ClientInput>& inputQueue);
+	GameEngine(GameContext& ctx, MpscQueue<ClientInput>& inputQueue, const std::string& databasePath = "mud.db");
 	~GameEngine();
 
-	ThreadSafeQueue<ClientInput>& inputQueue;	
+	// One queue per network I/O shard; ProcessInputs drains them round-robin.
+	std::vector<MpscQueue<ClientInput>*> inputQueues;
+	void AddInputQueue(MpscQueue<ClientInput>* queue) { inputQueues.push_back(queue); }
 	// Pass the address (&db)
 
 	GameContext& gameContext;
@@ -56,13 +64,23 @@ public:
 	float time = 0;
 
 	GameContext& GetContext() { return gameContext; }
-	int CreatePlayer(ClientConnection* clientID, std::string username, std::string password,PlayerData playerData);
 	int LoadPlayer(ClientConnection* socket, std::string username);
+	// Game thread: a Login result from AuthService; no database access left to do.
+	int SpawnPlayer(ClientConnection* socket, const PlayerData& data);
 	void Update(float deltaTime);
+	// Job system workers for parallel systems and loops; 0 runs everything in order on the game thread.
+	void SetSystemThreads(int count);
+	// Reseeds every game RNG (loot rolls, Lua's math.random) so a run can be repeated exactly.
+	void SeedRandom(uint32_t seed);
+	// Logs every handled ClientInput and every session open and close, by tick,
+	// to 'path' for ModularMudSim --replay (InputRecording.h).
+	bool StartRecording(const std::string& path, int tickRate);
 	const bool IsRunning();
 	ClientConnection* GetClientById(int clientId);
 	int GetEntityByClient(int clientId);
 	void ProcessInputs();
+	// Output water marks applied to every connection when the tick's output is released.
+	BackpressureLimits backpressureLimits;
 	void Quit();
 	GameContext& GetGameContext();
 	CommandInterpreter* interpreter;
@@ -86,7 +104,35 @@ public:
 	MessageSystem* messageSytem;
 	SaveSystem* saveSystem;
 	RespawnSystem* respawnSystem;
+	SystemScheduler* systemScheduler;
 
 private:
+	void HandleClientInput(const ClientInput& input);
+	void ReapClosedSessions();
+	void StartNewSessions();
+	void ApplyAuthResults();
+	int EnterWorld(ClientConnection* socket, int entityID, const std::string& username);
+	void FinishTickOutput();
+	void RegisterSystems();
+
 	bool isRunning = true;
+	size_t nextInputShard = 0;
+	// Per-shard batches, reused every tick to avoid reallocating
+	std::vector<std::vector<ClientInput>> inputBatches;
+	std::vector<ClientConnection*> retiredClients;
+	std::vector<int> openedSessions;
+	std::vector<std::string_view> inputTokens;
+	std::vector<std::string> inputWords;
+	std::vector<AuthResult> authResults;
+	InputRecorder* recorder = nullptr;
+
+	// Backpressure totals for the periodic log; departed clients' counters are folded in on reap.
+	BackpressureCounters departedBackpressure;
+	uint64_t evictedClients = 0;
+	float nextBackpressureLog = 60.0f;
+
+	// TickProfiler names for the parts of the tick outside the systems
+	uint16_t profileInput = 0;
+	uint16_t profileUpdate = 0;
+	uint16_t profileOutput = 0;
 };
\ No newline at end of file
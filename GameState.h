@@ -2,6 +2,7 @@
 #include <string>
 #include "Command.h"
 class ClientConnection; // Forward declaration
+struct AuthResult;
 
 class GameState {
 public:
@@ -15,5 +16,9 @@ public:
     }
 
     // handle progress & input in the menu and 
-    virtual void HandleInput(ClientConnection* client, std::vector<std::string> input) = 0;
+    virtual void HandleInput(ClientConnection* client, const std::vector<std::string>& input) = 0;
+
+    // A request this state submitted to AuthService has finished. Called on the
+    // game thread at the start of a tick; compare result.ticket to the one Submit returned.
+    virtual void OnAuthResult(ClientConnection* client, const AuthResult& result) {}
 };
\ No newline at end of file
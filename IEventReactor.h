@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "SocketPlatform.h"
+#include "NetworkBackend.h"
+
+/**
+ * @struct ReactorEvent
+ * @brief One readiness notification handed back by IEventReactor::Wait.
+ *
+ * userData is whatever pointer was registered with the socket (the Server
+ * stores the ClientConnection*, or nullptr for the listen socket).
+ */
+struct ReactorEvent {
+    SOCKET socket = INVALID_SOCKET;
+    void* userData = nullptr;
+    bool readable = false;
+    bool writable = false;
+    bool hangup = false;
+};
+
+/**
+ * @class IEventReactor
+ * @brief Platform-neutral socket readiness demultiplexer used by Server::Run.
+ *
+ * Implementations only report sockets that actually became ready, so a wakeup
+ * costs O(active sockets) rather than O(connections). Wait() blocks until
+ * there is I/O or until another thread calls Wake().
+ */
+class IEventReactor {
+public:
+    virtual ~IEventReactor() = default;
+
+    virtual bool Add(SOCKET socket, void* userData) = 0;
+    virtual void Remove(SOCKET socket) = 0;
+
+    // Blocks up to timeoutMs (-1 = forever). Returns the number of events written
+    // to 'out', 0 on timeout / wakeup, or -1 on a fatal error.
+    virtual int Wait(std::vector<ReactorEvent>& out, int timeoutMs) = 0;
+
+    // Thread-safe: interrupts a blocked Wait() so pending output can be flushed.
+    virtual void Wake() = 0;
+
+    // True if readiness is only reported on transitions, in which case callers
+    // must drain reads/writes until the socket would block.
+    virtual bool IsEdgeTriggered() const = 0;
+};
+
+// Builds the requested readiness backend. Auto (or a backend the platform lacks)
+// picks the best one available: epoll on Linux, select elsewhere.
+// NetworkBackend::IoUring is completion-based and lives in IoUringBackend instead.
+// Returns nullptr if the backend could not be set up.
+std::unique_ptr<IEventReactor> CreateEventReactor(NetworkBackend backend = NetworkBackend::Auto);
@@ -0,0 +1,190 @@
+#include "InputRecording.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char MAGIC[8] = { 'M', 'U', 'D', 'I', 'N', 'P', 'U', 'T' };
+static const uint16_t VERSION = 1;
+// A single command line can't be longer than the input framer allows; anything
+// far beyond that means the file is corrupt.
+static const uint64_t MAX_TEXT = 1 << 20;
+static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+// Opens 'path' for writing from the start, readable by its owner only. An
+// existing file is narrowed to owner-only before it is truncated, so nothing
+// recorded is ever readable through its old permissions. Symlinks and
+// anything other than a regular file are refused.
+static std::FILE* OpenPrivate(const std::string& path) {
+#ifdef _WIN32
+    // No group or world bits here; the file gets its directory's ACL.
+    int fd = -1;
+    if (_sopen_s(&fd, path.c_str(), _O_CREAT | _O_TRUNC | _O_WRONLY | _O_BINARY, _SH_DENYWR, _S_IREAD | _S_IWRITE) != 0) {
+        return nullptr;
+    }
+    std::FILE* out = _fdopen(fd, "wb");
+    if (!out) _close(fd);
+    return out;
+#else
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_uid != geteuid() ||
+        fchmod(fd, 0600) != 0 || ftruncate(fd, 0) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    std::FILE* out = fdopen(fd, "wb");
+    if (!out) close(fd);
+    return out;
+#endif
+}
+
+InputRecorder::~InputRecorder() {
+    Close();
+}
+
+bool InputRecorder::Open(const std::string& path, int tickRate) {
+    Close();
+    file = OpenPrivate(path);
+    if (!file) return false;
+
+    buffer.assign(MAGIC, sizeof(MAGIC));
+    buffer.push_back(static_cast<char>(VERSION & 0xFF));
+    buffer.push_back(static_cast<char>(VERSION >> 8));
+    buffer.push_back(static_cast<char>(tickRate & 0xFF));
+    buffer.push_back(static_cast<char>((tickRate >> 8) & 0xFF));
+    lastTick = 0;
+    records = 0;
+    bytesWritten = 0;
+    Flush();
+    return true;
+}
+
+void InputRecorder::Close() {
+    if (!file) return;
+    Flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void InputRecorder::RecordOpen(uint64_t tick, uint32_t session) {
+    if (!file) return;
+    Append(InputRecord::Type::Open, tick, session);
+}
+
+void InputRecorder::RecordClose(uint64_t tick, uint32_t session) {
+    if (!file) return;
+    Append(InputRecord::Type::Close, tick, session);
+}
+
+void InputRecorder::RecordInput(uint64_t tick, uint32_t session, const std::string& text) {
+    if (!file) return;
+    Append(InputRecord::Type::Input, tick, session);
+    AppendVarint(text.size());
+    buffer.append(text);
+    // A flood of input mid-tick shouldn't grow the buffer without bound
+    if (buffer.size() >= FLUSH_THRESHOLD) Flush();
+}
+
+void InputRecorder::Flush() {
+    if (!file || buffer.empty()) return;
+    std::fwrite(buffer.data(), 1, buffer.size(), file);
+    std::fflush(file);
+    bytesWritten += buffer.size();
+    buffer.clear();
+}
+
+void InputRecorder::Append(InputRecord::Type type, uint64_t tick, uint32_t session) {
+    // Ticks only move forward, so the delta is almost always 0 or 1: one byte
+    uint64_t delta = tick >= lastTick ? tick - lastTick : 0;
+    lastTick += delta;
+    buffer.push_back(static_cast<char>(type));
+    AppendVarint(delta);
+    AppendVarint(session);
+    records++;
+}
+
+void InputRecorder::AppendVarint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+bool InputRecordingReader::Open(const std::string& path) {
+    file.open(path, std::ios::binary);
+    if (!file) return false;
+
+    unsigned char header[sizeof(MAGIC) + 4];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::string(reinterpret_cast<char*>(header), sizeof(MAGIC)) != std::string(MAGIC, sizeof(MAGIC))) {
+        file.close();
+        return false;
+    }
+    uint16_t version = static_cast<uint16_t>(header[8] | (header[9] << 8));
+    if (version != VERSION) {
+        printf("[Replay] %s is version %u; this build reads version %u\n", path.c_str(), version, VERSION);
+        file.close();
+        return false;
+    }
+    tickRate = header[10] | (header[11] << 8);
+    if (tickRate <= 0) tickRate = 30;
+    return true;
+}
+
+bool InputRecordingReader::Next(InputRecord& record) {
+    if (hasLookahead) {
+        record = std::move(lookahead);
+        hasLookahead = false;
+        return true;
+    }
+    return ReadRecord(record);
+}
+
+const InputRecord* InputRecordingReader::Peek() {
+    if (!hasLookahead) {
+        hasLookahead = ReadRecord(lookahead);
+    }
+    return hasLookahead ? &lookahead : nullptr;
+}
+
+bool InputRecordingReader::ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = file.get();
+        if (byte == std::char_traits<char>::eof()) return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool InputRecordingReader::ReadRecord(InputRecord& record) {
+    if (!file.is_open()) return false;
+
+    int type = file.get();
+    if (type == std::char_traits<char>::eof() || type > static_cast<int>(InputRecord::Type::Close)) return false;
+
+    uint64_t delta, session;
+    if (!ReadVarint(delta) || !ReadVarint(session)) return false;
+    lastTick += delta;
+    record.type = static_cast<InputRecord::Type>(type);
+    record.tick = lastTick;
+    record.session = static_cast<uint32_t>(session);
+    record.text.clear();
+
+    if (record.type == InputRecord::Type::Input) {
+        uint64_t length;
+        if (!ReadVarint(length) || length > MAX_TEXT) return false;
+        record.text.resize(static_cast<size_t>(length));
+        if (length > 0 && !file.read(&record.text[0], static_cast<std::streamsize>(length))) return false;
+    }
+    return true;
+}
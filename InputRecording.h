@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// One entry of an input recording. Session ids are the live SessionIDs at the
+// time of recording; a replay maps them to the sessions it opens itself.
+struct InputRecord {
+    enum class Type : uint8_t { Input = 0, Open = 1, Close = 2 };
+
+    Type type = Type::Input;
+    uint64_t tick = 0;
+    uint32_t session = 0;
+    std::string text;   // Input only
+};
+
+/**
+ * @class InputRecorder
+ * @brief Appends every ClientInput the engine handles, with its tick and session, to a file.
+ *
+ * The file starts with an 8-byte magic, a version and the tick rate. After
+ * that come records: a type byte, then varints for the tick delta, the session
+ * and (for input) the text length, then the text. A command costs a few bytes
+ * more than its text, so an hour of a busy server stays small. Session opens
+ * and closes are recorded too, so a replay knows when connections came and went.
+ *
+ * Game thread only. Writes go through a buffer that is flushed once per tick.
+ * The file holds everything players typed, passwords included. Open creates
+ * it readable by its owner only (0600 on POSIX), and narrows an existing file
+ * to that before truncating it.
+ */
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool Open(const std::string& path, int tickRate);
+    void Close();
+    bool IsOpen() const { return file != nullptr; }
+
+    void RecordOpen(uint64_t tick, uint32_t session);
+    void RecordClose(uint64_t tick, uint32_t session);
+    void RecordInput(uint64_t tick, uint32_t session, const std::string& text);
+    // End of tick: hands the buffered records to the OS.
+    void Flush();
+
+    uint64_t Records() const { return records; }
+    uint64_t BytesWritten() const { return bytesWritten; }
+
+private:
+    void Append(InputRecord::Type type, uint64_t tick, uint32_t session);
+    void AppendVarint(uint64_t value);
+
+    std::FILE* file = nullptr;   // Created owner-only by Open
+    std::string buffer;
+    uint64_t lastTick = 0;
+    uint64_t records = 0;
+    uint64_t bytesWritten = 0;
+};
+
+/**
+ * @class InputRecordingReader
+ * @brief Reads an InputRecorder file back one record at a time.
+ */
+class InputRecordingReader {
+public:
+    InputRecordingReader() = default;
+
+    InputRecordingReader(const InputRecordingReader&) = delete;
+    InputRecordingReader& operator=(const InputRecordingReader&) = delete;
+
+    // False if the file is missing or isn't a recording.
+    bool Open(const std::string& path);
+    int TickRate() const { return tickRate; }
+
+    // False at the end of the file. A truncated last record (the recording
+    // server was killed mid-write) also ends the file.
+    bool Next(InputRecord& record);
+    // Looks at the next record without consuming it.
+    const InputRecord* Peek();
+
+private:
+    bool ReadVarint(uint64_t& value);
+    bool ReadRecord(InputRecord& record);
+
+    std::ifstream file;
+    int tickRate = 30;
+    uint64_t lastTick = 0;
+    InputRecord lookahead;
+    bool hasLookahead = false;
+};
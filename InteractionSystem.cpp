@@ -9,6 +9,7 @@
 #include "ScriptManager.h"
 #include "FactoryManager.h"
 #include "WorldManager.h"
+#include "MessageSystem.h"
 
 InteractionSystem::~InteractionSystem() {}
 
@@ -88,9 +89,8 @@ void InteractionSystem::run() {
 			}
 
 			// Send message to room (if different from user message)
-			if (!result.roomMessage.empty()) {
-				// TODO: Send to all players in room except the user
-				// This would require a room messaging system
+			if (!result.roomMessage.empty() && ctx.messages) {
+				ctx.messages->ToRoom(posComp->roomId, result.roomMessage, entity);
 			}
 
 			// Handle specific action types
@@ -111,6 +111,7 @@ void InteractionSystem::HandleInteractableResult(int userEntityID, const Interac
 			auto* pos = ctx.registry->GetComponent<PositionComponent>(userEntityID);
 			if (pos) {
 				ctx.worldManager->AttemptTeleport(pos, result.targetRoomID);
+				ctx.messages->EnterRoom(userEntityID, pos->roomId);
 				ctx.registry->AddComponent<PositionChangedComponent>(userEntityID);
 			}
 		}
@@ -0,0 +1,387 @@
+#include "IoUringBackend.h"
+#ifdef MUD_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    // user_data = pointer | kind. Every tagged pointer is at least 8-byte aligned.
+    const uint64_t KIND_MASK = 0x7;
+
+    // The uapi header declares io_uring_buf_ring::bufs with __DECLARE_FLEX_ARRAY,
+    // which under C++ gains a 1-byte empty struct and lands at offset 8. Address the
+    // ring as a plain io_uring_buf array instead; the tail overlays bufs[0].resv.
+    io_uring_buf* RingSlots(io_uring_buf_ring* ring) {
+        return reinterpret_cast<io_uring_buf*>(ring);
+    }
+
+    void PublishRingTail(io_uring_buf_ring* ring, uint16_t tail) {
+        __atomic_store_n(&RingSlots(ring)[0].resv, tail, __ATOMIC_RELEASE);
+    }
+
+    uint64_t Encode(void* ptr, UringCompletion::Kind kind) {
+        return reinterpret_cast<uint64_t>(ptr) | static_cast<uint64_t>(kind);
+    }
+
+    int SysSetup(unsigned entries, io_uring_params* p) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+    }
+
+    int SysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void* arg, size_t argSize) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+    }
+
+    int SysRegister(int fd, unsigned opcode, void* arg, unsigned nrArgs) {
+        return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+    }
+}
+
+IoUringBackend::~IoUringBackend() {
+    if (bufRing && ringFd != -1) {
+        io_uring_buf_reg reg{};
+        reg.bgid = BUFFER_GROUP;
+        SysRegister(ringFd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    }
+    if (bufRing) munmap(bufRing, bufRingSize);
+    delete[] bufferPool;
+    if (sqes) munmap(sqes, sqesSize);
+    if (cqRingPtr && cqRingPtr != sqRingPtr) munmap(cqRingPtr, cqRingSize);
+    if (sqRingPtr) munmap(sqRingPtr, sqRingSize);
+    if (wakeFd != -1) close(wakeFd);
+    if (ringFd != -1) close(ringFd);
+}
+
+bool IoUringBackend::Init(unsigned entries, unsigned count, unsigned size) {
+    io_uring_params params{};
+    // Only the network thread ever submits, and it is the one reaping completions.
+    // The ring is built on the main thread, so it starts disabled: the kernel
+    // binds the single issuer to whichever thread calls Enable().
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_R_DISABLED;
+    ringFd = SysSetup(entries, &params);
+    if (ringFd < 0) {
+        // Older kernels reject the hint flags; retry without them.
+        params = io_uring_params{};
+        ringFd = SysSetup(entries, &params);
+    }
+    ringDisabled = ringFd >= 0 && (params.flags & IORING_SETUP_R_DISABLED) != 0;
+    if (ringFd < 0) {
+        printf("io_uring_setup failed with error: %d\n", errno);
+        return false;
+    }
+
+    // 1. Map the submission and completion rings
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize = cqRingSize = (sqRingSize > cqRingSize) ? sqRingSize : cqRingSize;
+    }
+
+    sqRingPtr = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRingPtr == MAP_FAILED) {
+        sqRingPtr = nullptr;
+        printf("io_uring sq mmap failed with error: %d\n", errno);
+        return false;
+    }
+
+    if (singleMmap) {
+        cqRingPtr = sqRingPtr;
+    }
+    else {
+        cqRingPtr = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRingPtr == MAP_FAILED) {
+            cqRingPtr = nullptr;
+            printf("io_uring cq mmap failed with error: %d\n", errno);
+            return false;
+        }
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqeMem = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqeMem == MAP_FAILED) {
+        printf("io_uring sqe mmap failed with error: %d\n", errno);
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqeMem);
+
+    char* sq = static_cast<char*>(sqRingPtr);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+    sqLocalTail = sqSubmittedTail = *sqTail;
+
+    // Identity mapping: SQE slot i is always array entry i.
+    for (unsigned i = 0; i < sqEntries; ++i) {
+        sqArray[i] = i;
+    }
+
+    char* cq = static_cast<char*>(cqRingPtr);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // 2. Register the provided-buffer pool used by every multishot receive
+    bufferCount = count;
+    bufferSize = size;
+    bufferPool = new char[static_cast<size_t>(bufferCount) * bufferSize];
+
+    bufRingSize = bufferCount * sizeof(io_uring_buf);
+    void* ringMem = mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ringMem == MAP_FAILED) {
+        printf("io_uring buffer ring mmap failed with error: %d\n", errno);
+        return false;
+    }
+    bufRing = static_cast<io_uring_buf_ring*>(ringMem);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+    reg.ring_entries = bufferCount;
+    reg.bgid = BUFFER_GROUP;
+    if (SysRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        printf("io_uring buffer ring registration failed with error: %d\n", errno);
+        munmap(bufRing, bufRingSize);
+        bufRing = nullptr;
+        return false;
+    }
+
+    bufLocalTail = 0;
+    for (unsigned i = 0; i < bufferCount; ++i) {
+        io_uring_buf* buf = &RingSlots(bufRing)[bufLocalTail & (bufferCount - 1)];
+        buf->addr = reinterpret_cast<uint64_t>(bufferPool + static_cast<size_t>(i) * bufferSize);
+        buf->len = bufferSize;
+        buf->bid = static_cast<uint16_t>(i);
+        bufLocalTail++;
+    }
+    PublishRingTail(bufRing, bufLocalTail);
+
+    // 3. Cross-thread wakeups complete an eventfd read that is always armed
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        printf("eventfd failed with error: %d\n", errno);
+        return false;
+    }
+    return ArmWake();
+}
+
+bool IoUringBackend::Enable() {
+    if (!ringDisabled) return true;
+    if (SysRegister(ringFd, IORING_REGISTER_ENABLE_RINGS, nullptr, 0) < 0) {
+        printf("io_uring enable failed: %s\n", strerror(errno));
+        return false;
+    }
+    ringDisabled = false;
+    return true;
+}
+
+io_uring_sqe* IoUringBackend::GetSqe() {
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (sqLocalTail - head >= sqEntries && !ringDisabled) {
+        // Ring full: hand what we have to the kernel and try again.
+        Enter(FlushSubmissions(), 0);
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqLocalTail - head >= sqEntries) {
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe* sqe = &sqes[sqLocalTail & *sqMask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqLocalTail++;
+    return sqe;
+}
+
+unsigned IoUringBackend::FlushSubmissions() {
+    // Everything past sqSubmittedTail is still waiting for the kernel, including
+    // entries a failed or partial Enter left behind; they go out with the next one.
+    __atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+    return sqLocalTail - sqSubmittedTail;
+}
+
+int IoUringBackend::Enter(unsigned toSubmit, unsigned minComplete, io_uring_getevents_arg* arg) {
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    if (arg) flags |= IORING_ENTER_EXT_ARG;
+    int ret;
+    do {
+        stats.enterCalls++;
+        ret = SysEnter(ringFd, toSubmit, minComplete, flags, arg, arg ? sizeof(*arg) : 0);
+    } while (ret < 0 && errno == EINTR);
+    // The return value is how many SQEs the kernel consumed, not how many we offered.
+    if (ret > 0) {
+        sqSubmittedTail += static_cast<unsigned>(ret);
+    }
+    return ret;
+}
+
+bool IoUringBackend::ArmWake() {
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeFd;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeValue);
+    sqe->len = sizeof(wakeValue);
+    sqe->user_data = Encode(nullptr, UringCompletion::Kind::Wake);
+    return true;
+}
+
+bool IoUringBackend::ArmAccept(SOCKET listenSocket) {
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenSocket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    // No object to point at: the listening socket itself rides in the upper bits.
+    sqe->user_data = (static_cast<uint64_t>(listenSocket) << 3) | static_cast<uint64_t>(UringCompletion::Kind::Accept);
+    return true;
+}
+
+bool IoUringBackend::ArmRecv(SOCKET socket, void* userData) {
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = Encode(userData, UringCompletion::Kind::Recv);
+    return true;
+}
+
+bool IoUringBackend::SubmitSends(SOCKET socket, void* userData, const std::vector<std::pair<const char*, size_t>>& chunks) {
+    if (chunks.empty()) return true;
+    if (chunks.size() > sqEntries) return false;
+
+    // A link chain must not be split across two submissions, so make room up front.
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (sqEntries - (sqLocalTail - head) < chunks.size() && !ringDisabled) {
+        Enter(FlushSubmissions(), 0);
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqEntries - (sqLocalTail - head) < chunks.size()) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        io_uring_sqe* sqe = GetSqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = socket;
+        sqe->addr = reinterpret_cast<uint64_t>(chunks[i].first);
+        sqe->len = static_cast<unsigned>(chunks[i].second);
+        // The sockets are non-blocking, so without MSG_WAITALL a short send would
+        // complete "successfully" and the next link would go out past the gap.
+        // With it the kernel keeps sending until the chunk is done, and a send
+        // that still comes up short fails the link so the rest is cancelled.
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->user_data = Encode(userData, UringCompletion::Kind::Send);
+        if (i + 1 < chunks.size()) {
+            // MSG_MORE works like TCP_CORK for the chain: only the last send
+            // pushes out a short segment.
+            sqe->flags = IOSQE_IO_LINK;
+            sqe->msg_flags |= MSG_MORE;
+        }
+    }
+    return true;
+}
+
+bool IoUringBackend::CancelAll(SOCKET socket) {
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = socket;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = Encode(nullptr, UringCompletion::Kind::Cancel);
+    return true;
+}
+
+int IoUringBackend::Wait(std::vector<UringCompletion>& out, int timeoutMs) {
+    out.clear();
+
+    unsigned toSubmit = FlushSubmissions();
+    unsigned head = *cqHead;
+    bool haveCompletions = head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+    if (haveCompletions || timeoutMs == 0) {
+        if (toSubmit > 0) Enter(toSubmit, 0);
+    }
+    else if (timeoutMs < 0) {
+        if (Enter(toSubmit, 1) < 0 && errno != EBUSY && errno != ETIME) {
+            return -1;
+        }
+    }
+    else {
+        __kernel_timespec ts{};
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        io_uring_getevents_arg arg{};
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        if (Enter(toSubmit, 1, &arg) < 0 && errno != ETIME && errno != EBUSY) {
+            return -1;
+        }
+    }
+
+    bool rearmWake = false;
+    unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes[head & *cqMask];
+
+        UringCompletion c;
+        c.kind = static_cast<UringCompletion::Kind>(cqe.user_data & KIND_MASK);
+        c.userData = reinterpret_cast<void*>(cqe.user_data & ~KIND_MASK);
+        c.result = cqe.res;
+        c.more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        if (c.kind == UringCompletion::Kind::Accept) {
+            c.listenSocket = static_cast<SOCKET>(cqe.user_data >> 3);
+            c.userData = nullptr;
+        }
+
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            c.bufferId = static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            c.data = bufferPool + static_cast<size_t>(c.bufferId) * bufferSize;
+            c.length = cqe.res > 0 ? cqe.res : 0;
+        }
+
+        if (c.kind == UringCompletion::Kind::Recv) {
+            if (cqe.res > 0) stats.bytesReceived += cqe.res;
+            if (cqe.res == -ENOBUFS) stats.bufferExhausted++;
+        }
+        else if (c.kind == UringCompletion::Kind::Send && cqe.res > 0) {
+            stats.bytesSent += cqe.res;
+        }
+        else if (c.kind == UringCompletion::Kind::Wake) {
+            rearmWake = true;
+        }
+
+        out.push_back(c);
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    stats.completions += out.size();
+
+    if (rearmWake) {
+        ArmWake();
+    }
+    return static_cast<int>(out.size());
+}
+
+void IoUringBackend::RecycleBuffer(int bufferId) {
+    if (bufferId < 0) return;
+    io_uring_buf* buf = &RingSlots(bufRing)[bufLocalTail & (bufferCount - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(bufferPool + static_cast<size_t>(bufferId) * bufferSize);
+    buf->len = bufferSize;
+    buf->bid = static_cast<uint16_t>(bufferId);
+    bufLocalTail++;
+    PublishRingTail(bufRing, bufLocalTail);
+}
+
+void IoUringBackend::Wake() {
+    uint64_t one = 1;
+    (void)write(wakeFd, &one, sizeof(one));
+}
+
+#endif
@@ -0,0 +1,125 @@
+#pragma once
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define MUD_HAS_IO_URING 1
+#include "SocketPlatform.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct UringCompletion
+ * @brief One completed operation handed back by IoUringBackend::Wait.
+ *
+ * For Recv completions 'data'/'length' point into the registered buffer pool.
+ * The bytes stay valid until RecycleBuffer(bufferId) is called.
+ */
+struct UringCompletion {
+    enum class Kind : uint8_t { Accept, Recv, Send, Wake, Cancel };
+
+    Kind kind = Kind::Wake;
+    void* userData = nullptr;
+    int result = 0;        // Bytes / new fd, or -errno
+    bool more = false;     // Multishot op is still armed
+    const char* data = nullptr;
+    int length = 0;
+    int bufferId = -1;
+    SOCKET listenSocket = INVALID_SOCKET;  // Accept: the listener that produced it
+};
+
+/**
+ * @class IoUringBackend
+ * @brief Completion-based socket I/O on io_uring, driven from the network thread.
+ *
+ * Talks to the kernel ABI directly (no liburing dependency):
+ * - a provided-buffer ring is registered once, so multishot receives land
+ *   straight in pooled buffers instead of a per-call stack buffer;
+ * - one multishot accept and one multishot recv per socket stay armed, so the
+ *   steady state needs no re-submission at all;
+ * - queued messages are sent as an IOSQE_IO_LINK chain, one SQE per message,
+ *   without concatenating them first. Every send but the last carries
+ *   MSG_MORE, so the chain leaves in as few segments as possible. Every send
+ *   carries MSG_WAITALL, so a short send breaks the link instead of letting
+ *   the next message overtake the unsent tail.
+ * A whole batch of submissions and completions costs one io_uring_enter call.
+ */
+class IoUringBackend {
+public:
+    struct Stats {
+        uint64_t enterCalls = 0;
+        uint64_t completions = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bufferExhausted = 0;
+    };
+
+    IoUringBackend() = default;
+    ~IoUringBackend();
+
+    // bufferCount must be a power of two.
+    bool Init(unsigned entries = 4096, unsigned bufferCount = 1024, unsigned bufferSize = 4096);
+    // Call from the network thread before its first Wait(). Init() leaves the ring
+    // disabled so that this thread, not the one that built it, becomes the issuer.
+    // Arm* calls made before this only queue SQEs.
+    bool Enable();
+
+    bool ArmAccept(SOCKET listenSocket);
+    bool ArmRecv(SOCKET socket, void* userData);
+    // Queues one linked SEND per chunk. The memory must stay alive until each completes.
+    bool SubmitSends(SOCKET socket, void* userData, const std::vector<std::pair<const char*, size_t>>& chunks);
+    // Cancels every pending op on the socket; their CQEs still arrive (with -ECANCELED).
+    bool CancelAll(SOCKET socket);
+
+    // Submits everything queued and blocks for at least one completion (timeoutMs 0 = poll).
+    // Returns -1 with errno set on failure.
+    int Wait(std::vector<UringCompletion>& out, int timeoutMs);
+    void RecycleBuffer(int bufferId);
+
+    // Thread-safe: completes the armed eventfd read so a blocked Wait() returns.
+    void Wake();
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct io_uring_sqe* GetSqe();
+    int Enter(unsigned toSubmit, unsigned minComplete, struct io_uring_getevents_arg* arg = nullptr);
+    unsigned FlushSubmissions();
+    bool ArmWake();
+
+    int ringFd = -1;
+    bool ringDisabled = false;
+    int wakeFd = -1;
+    uint64_t wakeValue = 0;
+
+    // Submission queue (mmapped)
+    void* sqRingPtr = nullptr;
+    size_t sqRingSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    struct io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned sqEntries = 0;
+    unsigned sqLocalTail = 0;
+    unsigned sqSubmittedTail = 0;
+
+    // Completion queue (mmapped, shares sqRingPtr when IORING_FEAT_SINGLE_MMAP)
+    void* cqRingPtr = nullptr;
+    size_t cqRingSize = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    struct io_uring_cqe* cqes = nullptr;
+
+    // Provided buffer pool
+    static const uint16_t BUFFER_GROUP = 0;
+    struct io_uring_buf_ring* bufRing = nullptr;
+    size_t bufRingSize = 0;
+    char* bufferPool = nullptr;
+    unsigned bufferCount = 0;
+    unsigned bufferSize = 0;
+    uint16_t bufLocalTail = 0;
+
+    Stats stats;
+};
+#endif
@@ -0,0 +1,143 @@
+#include "JobSystem.h"
+
+namespace {
+    thread_local int currentSlot = 0;   // Game thread unless set by WorkerLoop
+}
+
+JobSystem::JobSystem() {
+    queues.push_back(std::make_unique<WorkQueue>());
+}
+
+JobSystem::~JobSystem() {
+    Stop();
+}
+
+void JobSystem::Start(int workerThreads) {
+    Stop();
+    stopping = false;
+    queues.clear();
+    for (int slot = 0; slot <= workerThreads; slot++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int slot = 1; slot <= workerThreads; slot++) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, slot);
+    }
+}
+
+void JobSystem::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleeping.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+int JobSystem::CurrentSlot() {
+    return currentSlot;
+}
+
+void JobSystem::Submit(const Job& job) {
+    if (job.group) job.group->pending.fetch_add(1, std::memory_order_relaxed);
+
+    WorkQueue& queue = *queues[currentSlot];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    if (!workers.empty()) {
+        // Taking the lock orders this against a worker that is about to sleep.
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        sleeping.notify_one();
+    }
+}
+
+void JobSystem::Wait(JobGroup& group) {
+    int slot = currentSlot;
+    while (!group.Done()) {
+        if (TryRunOne(slot)) continue;
+
+        // Whatever is left of the group is running on other threads. Sleep
+        // until one of them finishes it or queues something this thread can take.
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.wait(lock, [this, &group] { return group.Done() || queued.load(std::memory_order_acquire) > 0; });
+    }
+    if (group.failed.load(std::memory_order_acquire)) {
+        std::exception_ptr thrown = group.failure;
+        group.failure = nullptr;
+        group.failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(thrown);
+    }
+}
+
+bool JobSystem::PopLocal(int slot, Job& job) {
+    WorkQueue& queue = *queues[slot];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::Steal(int thief, Job& job) {
+    size_t count = queues.size();
+    for (size_t i = 1; i < count; i++) {
+        WorkQueue& queue = *queues[(thief + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        job = queue.jobs.front();
+        queue.jobs.pop_front();
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::TryRunOne(int slot) {
+    if (queued.load(std::memory_order_acquire) == 0) return false;
+    Job job;
+    if (!PopLocal(slot, job) && !Steal(slot, job)) return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(const Job& job) {
+    try {
+        job.run(job.data, job.begin, job.end);
+    }
+    catch (...) {
+        if (job.group && !job.group->failed.exchange(true, std::memory_order_acq_rel)) {
+            job.group->failure = std::current_exception();
+        }
+    }
+    executed.fetch_add(1, std::memory_order_relaxed);
+    if (job.group && job.group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Wake whoever is waiting on the group; the lock orders this against its check.
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        sleeping.notify_all();
+    }
+}
+
+void JobSystem::WorkerLoop(int slot) {
+    currentSlot = slot;
+    while (true) {
+        if (TryRunOne(slot)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping) return;
+    }
+}
+
+JobSystem::Stats JobSystem::GetStats() const {
+    Stats stats;
+    stats.executed = executed.load(std::memory_order_relaxed);
+    stats.stolen = stolen.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts a batch of jobs still running. Wait on it to join the batch.
+struct JobGroup {
+    std::atomic<int> pending{ 0 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr failure;      // First exception a job threw; written once
+
+    bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// One unit of work: run(data, begin, end). Plain data, so queuing a job never allocates.
+struct Job {
+    void (*run)(void* data, size_t begin, size_t end) = nullptr;
+    void* data = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    JobGroup* group = nullptr;
+};
+
+/**
+ * @class JobSystem
+ * @brief Work-stealing job scheduler shared by the tick's parallel work.
+ *
+ * Every thread that runs jobs has its own slot and its own deque. Slot 0 is the
+ * game thread and slots 1..N are the workers. A thread pushes and pops at the
+ * back of its own deque, so work it just split off stays on a warm cache.
+ * An idle thread steals the oldest job from the front of another deque.
+ * Wait keeps running queued jobs until the group is done and only sleeps when
+ * there is nothing left to take, so a job may submit and wait on jobs of its
+ * own (a system running a parallel loop does this).
+ *
+ * Jobs may be submitted and waited on from the game thread or from inside a
+ * job, never from other threads. With no workers everything runs on the game
+ * thread, in the order submitted.
+ */
+class JobSystem {
+public:
+    struct Stats {
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+    };
+
+    JobSystem();
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Game thread, before the first tick (or between ticks).
+    void Start(int workerThreads);
+    void Stop();
+    int WorkerThreads() const { return (int)workers.size(); }
+
+    // Per-thread data indexed by CurrentSlot() needs Slots() entries.
+    size_t Slots() const { return queues.size(); }
+    static int CurrentSlot();
+
+    void Submit(const Job& job);
+    // Runs jobs until the group is done, then rethrows the first exception a job threw.
+    void Wait(JobGroup& group);
+
+    Stats GetStats() const;
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    bool TryRunOne(int slot);
+    bool PopLocal(int slot, Job& job);
+    bool Steal(int thief, Job& job);
+    void Execute(const Job& job);
+    void WorkerLoop(int slot);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable sleeping;
+    bool stopping = false;
+
+    std::atomic<uint64_t> executed{ 0 };
+    std::atomic<uint64_t> stolen{ 0 };
+};
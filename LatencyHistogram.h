@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-size latency histogram in microseconds, cheap enough to record on hot paths.
+ *
+ * Each power of two is split into four linear sub-buckets, so a percentile is
+ * reported to within about 20% of the true value from 1 us to hours, in 2 KB
+ * and without allocating. Not thread-safe; callers lock or keep one per thread
+ * and Merge.
+ */
+class LatencyHistogram {
+public:
+    void Record(uint64_t micros) {
+        buckets[BucketFor(micros)]++;
+        count++;
+        totalMicros += micros;
+        if (micros > maxMicros) maxMicros = micros;
+    }
+
+    uint64_t Count() const { return count; }
+    uint64_t MaxMicros() const { return maxMicros; }
+    double MeanMicros() const { return count ? (double)totalMicros / (double)count : 0.0; }
+
+    // Upper bound of the bucket holding the given percentile (0-100); 0 when empty.
+    uint64_t Percentile(double percent) const {
+        if (count == 0) return 0;
+        uint64_t rank = (uint64_t)((percent / 100.0) * (double)count);
+        if (rank >= count) rank = count - 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen > rank) {
+                uint64_t upper = UpperBound(i);
+                return upper < maxMicros ? upper : maxMicros;
+            }
+        }
+        return maxMicros;
+    }
+
+    void Merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKETS; i++) buckets[i] += other.buckets[i];
+        count += other.count;
+        totalMicros += other.totalMicros;
+        if (other.maxMicros > maxMicros) maxMicros = other.maxMicros;
+    }
+
+    void Reset() { *this = LatencyHistogram(); }
+
+private:
+    static const size_t SUB_BUCKETS = 4;
+    static const size_t BUCKETS = SUB_BUCKETS + (64 - 2) * SUB_BUCKETS;
+
+    static size_t BucketFor(uint64_t micros) {
+        if (micros < SUB_BUCKETS) return (size_t)micros;
+        int exponent = 63;
+        while (!(micros >> exponent)) exponent--;
+        size_t sub = (size_t)(micros >> (exponent - 2)) & (SUB_BUCKETS - 1);
+        return SUB_BUCKETS + (size_t)(exponent - 2) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t UpperBound(size_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+        uint64_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+    }
+
+    uint64_t buckets[BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t totalMicros = 0;
+    uint64_t maxMicros = 0;
+};
@@ -0,0 +1,108 @@
+#include "LineFramer.h"
+#include <cstring>
+
+LineFramer::LineFramer(size_t maxLineLength) : maxLineLength(maxLineLength) {
+    // Room for a full line plus whatever arrives behind it before it is taken.
+    size_t size = 64;
+    while (size < maxLineLength * 4) size <<= 1;
+    ring.resize(size);
+    scratch.resize(maxLineLength + 1);
+    mask = size - 1;
+}
+
+void LineFramer::Release() {
+    head += pendingRelease;
+    pendingRelease = 0;
+}
+
+char* LineFramer::WritableSpan(size_t& length) {
+    Release();
+    size_t used = tail - head;
+    size_t free = ring.size() - used;
+    size_t offset = tail & mask;
+    size_t untilEnd = ring.size() - offset;
+    length = free < untilEnd ? free : untilEnd;
+    return ring.data() + offset;
+}
+
+void LineFramer::Commit(size_t bytes) {
+    tail += bytes;
+}
+
+size_t LineFramer::Append(const char* data, size_t length) {
+    size_t taken = 0;
+    while (taken < length) {
+        size_t span;
+        char* dest = WritableSpan(span);
+        if (span == 0) break;
+        size_t n = (length - taken) < span ? (length - taken) : span;
+        memcpy(dest, data + taken, n);
+        Commit(n);
+        taken += n;
+    }
+    return taken;
+}
+
+bool LineFramer::NextLine(std::string_view& line) {
+    Release();
+
+    while (scan < tail) {
+        if (ring[scan & mask] != '\n') {
+            scan++;
+            if (!discarding && scan - head > maxLineLength) {
+                // Too long to ever be a command: drop what we have and skip to the newline.
+                discarding = true;
+                overlongLines++;
+            }
+            if (discarding) {
+                head = scan;
+            }
+            continue;
+        }
+
+        size_t lineStart = head;
+        size_t lineEnd = scan;
+        scan++;
+
+        if (discarding) {
+            discarding = false;
+            head = scan;
+            continue;
+        }
+
+        pendingRelease = scan - head;
+
+        // Strip the telnet carriage return
+        if (lineEnd > lineStart && ring[(lineEnd - 1) & mask] == '\r') {
+            lineEnd--;
+        }
+
+        size_t length = lineEnd - lineStart;
+        size_t begin = lineStart & mask;
+        if (begin + length <= ring.size()) {
+            line = std::string_view(ring.data() + begin, length);
+        }
+        else {
+            size_t first = ring.size() - begin;
+            memcpy(scratch.data(), ring.data() + begin, first);
+            memcpy(scratch.data() + first, ring.data(), length - first);
+            line = std::string_view(scratch.data(), length);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void TokenizeLine(std::string_view line, std::vector<std::string_view>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) i++;
+        size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t') i++;
+        if (i > start) {
+            out.push_back(line.substr(start, i - start));
+        }
+    }
+}
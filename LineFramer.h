@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class LineFramer
+ * @brief Fixed ring buffer that splits a byte stream into '\n'-terminated lines.
+ *
+ * The socket reads straight into the ring (WritableSpan/Commit) or a
+ * completion backend copies in once (Append). NextLine hands out
+ * std::string_view lines with the trailing "\r\n" stripped, and scans each
+ * byte once, so a pasted block of N lines costs O(N) instead of a
+ * find/substr/erase per line. Nothing is allocated after construction.
+ *
+ * A line longer than maxLineLength is discarded up to its newline and counted
+ * in OverlongLines(), so a client can't grow the buffer without bound.
+ */
+class LineFramer {
+public:
+    static const size_t DEFAULT_MAX_LINE = 512;
+
+    explicit LineFramer(size_t maxLineLength = DEFAULT_MAX_LINE);
+
+    // Contiguous free space to recv() into; length 0 means the ring is full and
+    // the caller must take lines out first.
+    char* WritableSpan(size_t& length);
+    void Commit(size_t bytes);
+    // Copies as much as fits; returns the number of bytes taken.
+    size_t Append(const char* data, size_t length);
+
+    // The next complete line, valid until the next call to NextLine/Append/Commit.
+    bool NextLine(std::string_view& line);
+
+    uint64_t OverlongLines() const { return overlongLines; }
+
+private:
+    void Release();
+
+    std::vector<char> ring;
+    std::vector<char> scratch;      // A line that wraps the ring end is copied here
+    size_t mask;
+    size_t maxLineLength;
+
+    size_t head = 0;                // First unconsumed byte
+    size_t scan = 0;                // Bytes before this position hold no newline
+    size_t tail = 0;                // One past the last byte written
+    size_t pendingRelease = 0;      // Length of the line last handed out (incl. '\n')
+    bool discarding = false;        // Dropping the rest of an overlong line
+    uint64_t overlongLines = 0;
+};
+
+// Splits a line on spaces/tabs into views of the line itself.
+// 'out' is reused between calls, so steady-state tokenizing does not allocate.
+void TokenizeLine(std::string_view line, std::vector<std::string_view>& out);
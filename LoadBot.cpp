@@ -0,0 +1,496 @@
+#include "LoadBot.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const uint8_t IAC = 255;
+    const uint8_t SB = 250;
+    const uint8_t SE = 240;
+    const uint8_t WILL = 251;
+    const uint8_t WONT = 252;
+    const uint8_t DO = 253;
+    const uint8_t DONT = 254;
+
+    // Prompts are short; anything older than this can't still be waiting to match.
+    const size_t MAX_PENDING_TEXT = 64 * 1024;
+    const int LOGIN_TIMEOUT_SECONDS = 30;
+
+    const char* HELLO = "hello {\"type\":\"hello\",\"features\":[\"sidebar\",\"minimap\"]}";
+
+    uint64_t MicrosSince(LoadBot::Clock::time_point start, LoadBot::Clock::time_point now) {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+    }
+
+    std::string Base64(const unsigned char* data, size_t length) {
+        static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t chunk = (uint32_t)data[i] << 16;
+            if (i + 1 < length) chunk |= (uint32_t)data[i + 1] << 8;
+            if (i + 2 < length) chunk |= data[i + 2];
+            out.push_back(alphabet[(chunk >> 18) & 63]);
+            out.push_back(alphabet[(chunk >> 12) & 63]);
+            out.push_back(i + 1 < length ? alphabet[(chunk >> 6) & 63] : '=');
+            out.push_back(i + 2 < length ? alphabet[chunk & 63] : '=');
+        }
+        return out;
+    }
+}
+
+void LoadStats::Merge(const LoadStats& other) {
+    connectsAttempted += other.connectsAttempted;
+    connectsFailed += other.connectsFailed;
+    loggedIn += other.loggedIn;
+    loginFailures += other.loginFailures;
+    disconnects += other.disconnects;
+    commandsSent += other.commandsSent;
+    unanswered += other.unanswered;
+    bytesIn += other.bytesIn;
+    unsolicitedBytes += other.unsolicitedBytes;
+    bytesOut += other.bytesOut;
+    login.Merge(other.login);
+    response.Merge(other.response);
+}
+
+LoadBot::LoadBot(const LoadBotConfig& config, int index, uint32_t seed)
+    : config(config), name(config.namePrefix + std::to_string(index)), rng(seed) {
+}
+
+LoadBot::~LoadBot() {
+    Close();
+}
+
+bool LoadBot::Connect(IEventReactor& eventReactor, LoadStats& stats) {
+    stats.connectsAttempted++;
+    // A failed reconnect isn't retried
+    loginMode = config.login == LoadLogin::Existing || reconnect;
+    reconnect = false;
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(config.host.c_str(), config.port.c_str(), &hints, &result) != 0) {
+        stats.connectsFailed++;
+        return false;
+    }
+    for (addrinfo* address = result; address && socket == INVALID_SOCKET; address = address->ai_next) {
+        SOCKET candidate = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (candidate == INVALID_SOCKET) continue;
+        if (::connect(candidate, address->ai_addr, (int)address->ai_addrlen) == 0) {
+            socket = candidate;
+        }
+        else {
+            closesocket(candidate);
+        }
+    }
+    freeaddrinfo(result);
+    if (socket == INVALID_SOCKET) {
+        stats.connectsFailed++;
+        return false;
+    }
+
+    SocketPlatform::SetNonBlocking(socket);
+    SocketPlatform::SetNoDelay(socket);
+    if (!eventReactor.Add(socket, this)) {
+        closesocket(socket);
+        socket = INVALID_SOCKET;
+        stats.connectsFailed++;
+        return false;
+    }
+    reactor = &eventReactor;
+
+    connectedAt = Clock::now();
+    if (!started) {
+        startedAt = connectedAt;
+        started = true;
+    }
+    text.clear();
+    raw.clear();
+    outbox.clear();
+    telnetState = 0;
+    awaitingResponse = false;
+
+    if (config.protocol == LoadProtocol::Json) {
+        unsigned char key[16];
+        for (unsigned char& byte : key) byte = (unsigned char)(rng() & 0xFF);
+        outbox = "GET / HTTP/1.1\r\nHost: " + config.host + ":" + config.port +
+            "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + Base64(key, sizeof(key)) +
+            "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+        phase = Phase::Handshake;
+    }
+    else {
+        phase = Phase::Menu;
+    }
+    Flush(stats);
+    return true;
+}
+
+void LoadBot::Close() {
+    if (socket == INVALID_SOCKET) return;
+    if (reactor) reactor->Remove(socket);
+    closesocket(socket);
+    socket = INVALID_SOCKET;
+    finishedAt = Clock::now();
+    if (phase != Phase::Failed) phase = Phase::Closed;
+}
+
+double LoadBot::ActiveSeconds(Clock::time_point now) const {
+    if (!started) return 0.0;
+    Clock::time_point end = IsConnected() ? now : finishedAt;
+    return std::chrono::duration<double>(end - startedAt).count();
+}
+
+void LoadBot::OnReadable(LoadStats& stats) {
+    char buffer[8192];
+    while (socket != INVALID_SOCKET) {
+        int received = recv(socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            bytesIn += (uint64_t)received;
+            stats.bytesIn += (uint64_t)received;
+            if (phase == Phase::Playing && !awaitingResponse) {
+                stats.unsolicitedBytes += (uint64_t)received;
+            }
+            if (config.protocol == LoadProtocol::Json) {
+                ReceiveWebSocket(buffer, (size_t)received);
+            }
+            else {
+                ReceiveTelnet(buffer, (size_t)received);
+            }
+            // A WebSocket close frame
+            if (socket == INVALID_SOCKET) {
+                if (phase == Phase::Closed) stats.disconnects++;
+                return;
+            }
+            continue;
+        }
+
+        int err = SocketPlatform::LastError();
+        if (received < 0 && SocketPlatform::Interrupted(err)) continue;
+        if (received < 0 && SocketPlatform::WouldBlock(err)) break;
+        // The server hung up (or the connection failed)
+        if (phase != Phase::Failed) stats.disconnects++;
+        Close();
+        return;
+    }
+    Advance(stats);
+}
+
+void LoadBot::Update(Clock::time_point now, LoadStats& stats) {
+    if (socket == INVALID_SOCKET) return;
+
+    if (phase != Phase::Playing) {
+        if (now - connectedAt > std::chrono::seconds(LOGIN_TIMEOUT_SECONDS)) {
+            Fail("timed out waiting for a login prompt", stats);
+            return;
+        }
+        Flush(stats);
+        return;
+    }
+
+    if (awaitingResponse && now - commandSentAt > std::chrono::milliseconds(config.responseTimeoutMs)) {
+        stats.unanswered++;
+        awaitingResponse = false;
+    }
+    if (now >= nextCommandAt && config.totalWeight > 0) {
+        // The previous command never got an answer before this one went out
+        if (awaitingResponse) stats.unanswered++;
+        // Numbered, so a late echo of an earlier command never matches
+        pendingMarker = "~lb" + std::to_string(++commandSequence) + "~";
+        SendLine(PickCommand(), stats);
+        SendLine("echo " + pendingMarker, stats);
+        stats.commandsSent++;
+        commandSentAt = now;
+        awaitingResponse = true;
+        ScheduleNextCommand(now);
+    }
+    Flush(stats);
+}
+
+void LoadBot::Advance(LoadStats& stats) {
+    bool progressed = true;
+    while (progressed && socket != INVALID_SOCKET) {
+        progressed = false;
+        switch (phase) {
+        case Phase::Menu:
+            if (Consume("Type Login")) {
+                // Anything but "Login" goes to character creation
+                SendLine(loginMode ? "Login" : "create", stats);
+                phase = loginMode ? Phase::LoginName : Phase::CreateName;
+                progressed = true;
+            }
+            break;
+        case Phase::CreateName:
+            if (Consume("Enter your desired username")) {
+                SendLine(name, stats);
+                phase = Phase::CreatePassword;
+                progressed = true;
+            }
+            break;
+        case Phase::CreatePassword:
+            if (Consume("already taken")) {
+                if (config.login == LoadLogin::Auto) {
+                    // Left over from an earlier run; come back through the login menu
+                    reconnect = true;
+                    Close();
+                }
+                else {
+                    Fail("name already taken (use --login=existing or auto)", stats);
+                }
+            }
+            else if (Consume("Error checking that username")) {
+                Fail("server could not check the name", stats);
+            }
+            else if (Consume("Choose a password")) {
+                SendLine(config.password, stats);
+                phase = Phase::CreateConfirm;
+                progressed = true;
+            }
+            break;
+        case Phase::CreateConfirm:
+            if (Consume("Confirm your password")) {
+                SendLine(config.password, stats);
+                phase = Phase::CreateDone;
+                progressed = true;
+            }
+            break;
+        case Phase::CreateDone:
+            if (Consume("Please login with your new credentials")) {
+                phase = Phase::LoginName;
+                progressed = true;
+            }
+            else if (Consume("Error creating character")) {
+                Fail("character creation failed", stats);
+            }
+            break;
+        case Phase::LoginName:
+            if (Consume("Enter your username")) {
+                SendLine(name, stats);
+                phase = Phase::LoginPassword;
+                progressed = true;
+            }
+            break;
+        case Phase::LoginPassword:
+            if (Consume("User not found")) {
+                Fail("no such account (use --login=create or auto)", stats);
+            }
+            else if (Consume("Enter your password")) {
+                SendLine(config.password, stats);
+                phase = Phase::LoginWait;
+                progressed = true;
+            }
+            break;
+        case Phase::LoginWait:
+            if (Consume("Login Successful")) {
+                Clock::time_point now = Clock::now();
+                stats.loggedIn++;
+                stats.login.Record(MicrosSince(connectedAt, now));
+                phase = Phase::Playing;
+                if (config.protocol == LoadProtocol::Json) {
+                    SendLine(HELLO, stats);
+                }
+                ScheduleNextCommand(now);
+            }
+            else if (Consume("Incorrect password")) {
+                Fail("wrong password", stats);
+            }
+            else if (Consume("Login Failed")) {
+                Fail("server could not load the player", stats);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // In the world only the outstanding command's marker is matched, and a
+    // prompt never gets this long
+    if (phase == Phase::Playing) {
+        if (awaitingResponse && Consume(pendingMarker.c_str())) {
+            stats.response.Record(MicrosSince(commandSentAt, Clock::now()));
+            awaitingResponse = false;
+        }
+        // Keeps enough to match a marker split across reads
+        if (text.size() > pendingMarker.size()) text.erase(0, text.size() - pendingMarker.size());
+    }
+    else if (text.size() > MAX_PENDING_TEXT) {
+        text.erase(0, text.size() - 1024);
+    }
+    Flush(stats);
+}
+
+bool LoadBot::Consume(const char* prompt) {
+    size_t at = text.find(prompt);
+    if (at == std::string::npos) return false;
+    text.erase(0, at + strlen(prompt));
+    return true;
+}
+
+void LoadBot::SendLine(const std::string& line, LoadStats& stats) {
+    if (config.protocol == LoadProtocol::Json) {
+        // Each message is one line to the server; no terminator needed
+        QueueWebSocketFrame(0x1, line.data(), line.size());
+    }
+    else {
+        outbox.append(line);
+        outbox.append("\r\n");
+    }
+    Flush(stats);
+}
+
+void LoadBot::Flush(LoadStats& stats) {
+    while (socket != INVALID_SOCKET && !outbox.empty()) {
+        int sent = send(socket, outbox.data(), (int)outbox.size(), SocketPlatform::SEND_FLAGS);
+        if (sent > 0) {
+            stats.bytesOut += (uint64_t)sent;
+            outbox.erase(0, (size_t)sent);
+            continue;
+        }
+        int err = SocketPlatform::LastError();
+        if (SocketPlatform::Interrupted(err)) continue;
+        // Full send buffer: the rest goes on a later pass
+        if (SocketPlatform::WouldBlock(err)) return;
+        if (phase != Phase::Failed) stats.disconnects++;
+        Close();
+    }
+}
+
+void LoadBot::ScheduleNextCommand(Clock::time_point now) {
+    std::uniform_int_distribution<int> think(config.thinkMs / 2, config.thinkMs + config.thinkMs / 2);
+    nextCommandAt = now + std::chrono::milliseconds(think(rng));
+}
+
+const std::string& LoadBot::PickCommand() {
+    std::uniform_int_distribution<int> roll(1, config.totalWeight);
+    int remaining = roll(rng);
+    for (const LoadCommand& command : config.mix) {
+        remaining -= command.weight;
+        if (remaining <= 0) return command.text;
+    }
+    return config.mix.back().text;
+}
+
+void LoadBot::Fail(const char* reason, LoadStats& stats) {
+    printf("[Load] %s: %s\n", name.c_str(), reason);
+    stats.loginFailures++;
+    phase = Phase::Failed;
+    Close();
+}
+
+void LoadBot::ReceiveTelnet(const char* data, size_t length) {
+    // Game text passes through; option offers are refused so the stream stays
+    // plain text (no MCCP2, GMCP or NAWS); subnegotiations are skipped.
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)data[i];
+        switch (telnetState) {
+        case 0:
+            if (c == IAC) telnetState = 1;
+            else text.push_back((char)c);
+            break;
+        case 1:
+            if (c == IAC) {
+                text.push_back((char)c);
+                telnetState = 0;
+            }
+            else if (c >= WILL && c <= DONT) {
+                telnetCommand = c;
+                telnetState = 2;
+            }
+            else {
+                telnetState = (c == SB) ? 3 : 0;
+            }
+            break;
+        case 2:
+            if (telnetCommand == WILL || telnetCommand == DO) {
+                char reply[3] = { (char)IAC, (char)(telnetCommand == WILL ? DONT : WONT), (char)c };
+                outbox.append(reply, sizeof(reply));
+            }
+            telnetState = 0;
+            break;
+        case 3:
+            if (c == IAC) telnetState = 4;
+            break;
+        case 4:
+            telnetState = (c == SE) ? 0 : 3;
+            break;
+        }
+    }
+}
+
+void LoadBot::ReceiveWebSocket(const char* data, size_t length) {
+    raw.append(data, length);
+
+    if (phase == Phase::Handshake) {
+        size_t end = raw.find("\r\n\r\n");
+        if (end == std::string::npos) return;
+        if (raw.compare(0, 12, "HTTP/1.1 101") != 0) {
+            printf("[Load] %s: WebSocket upgrade refused\n", name.c_str());
+            phase = Phase::Failed;
+            Close();
+            return;
+        }
+        raw.erase(0, end + 4);
+        phase = Phase::Menu;
+    }
+
+    // Server frames are never masked. Text and binary payloads both go to 'text';
+    // pings are answered, and a close frame ends the connection.
+    while (raw.size() >= 2 && socket != INVALID_SOCKET) {
+        const unsigned char* bytes = (const unsigned char*)raw.data();
+        uint8_t opcode = bytes[0] & 0x0F;
+        uint64_t payloadLength = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (payloadLength == 126) {
+            if (raw.size() < 4) return;
+            payloadLength = ((uint64_t)bytes[2] << 8) | bytes[3];
+            header = 4;
+        }
+        else if (payloadLength == 127) {
+            if (raw.size() < 10) return;
+            payloadLength = 0;
+            for (int i = 0; i < 8; i++) payloadLength = (payloadLength << 8) | bytes[2 + i];
+            header = 10;
+        }
+        if (raw.size() < header + payloadLength) return;
+
+        const char* payload = raw.data() + header;
+        size_t size = (size_t)payloadLength;
+        if (opcode == 0x8) {
+            Close();
+            return;
+        }
+        if (opcode == 0x9) {
+            QueueWebSocketFrame(0xA, payload, size);
+        }
+        else if (opcode <= 0x2) {
+            text.append(payload, size);
+        }
+        raw.erase(0, header + size);
+    }
+}
+
+void LoadBot::QueueWebSocketFrame(uint8_t opcode, const char* payload, size_t length) {
+    // Client frames must be masked (RFC 6455 5.3)
+    outbox.push_back((char)(0x80 | opcode));
+    if (length < 126) {
+        outbox.push_back((char)(0x80 | length));
+    }
+    else if (length <= 0xFFFF) {
+        outbox.push_back((char)(0x80 | 126));
+        outbox.push_back((char)((length >> 8) & 0xFF));
+        outbox.push_back((char)(length & 0xFF));
+    }
+    else {
+        outbox.push_back((char)(0x80 | 127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            outbox.push_back((char)(((uint64_t)length >> shift) & 0xFF));
+        }
+    }
+    uint32_t maskValue = rng();
+    char mask[4] = { (char)(maskValue >> 24), (char)(maskValue >> 16), (char)(maskValue >> 8), (char)maskValue };
+    outbox.append(mask, sizeof(mask));
+    for (size_t i = 0; i < length; i++) {
+        outbox.push_back((char)(payload[i] ^ mask[i % 4]));
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include "SocketPlatform.h"
+#include "IEventReactor.h"
+#include "LatencyHistogram.h"
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Which port a bot connects to and how it frames its commands.
+enum class LoadProtocol {
+    Telnet,     // Plain lines; telnet option offers are refused
+    Json        // WebSocket text frames; sends the hello packet once in the world
+};
+
+// How a bot gets into the world.
+enum class LoadLogin {
+    Create,     // Character creation, then login
+    Existing,   // Straight to login; the account must already exist
+    Auto        // Create, and if the name is taken reconnect and log in
+};
+
+struct LoadCommand {
+    std::string text;
+    int weight = 1;
+};
+
+struct LoadBotConfig {
+    std::string host = "127.0.0.1";
+    std::string port = "27015";
+    LoadProtocol protocol = LoadProtocol::Telnet;
+    LoadLogin login = LoadLogin::Auto;
+    std::string namePrefix = "bot";
+    std::string password = "botpass";
+    std::vector<LoadCommand> mix;
+    int totalWeight = 0;
+    int thinkMs = 1000;                 // Mean pause between commands; each is drawn from 0.5x..1.5x
+    int responseTimeoutMs = 5000;       // A command whose marker hasn't come back by then counts as unanswered
+};
+
+// Counters and histograms for a group of bots. Workers fill their own and the
+// report merges them.
+struct LoadStats {
+    uint64_t connectsAttempted = 0;
+    uint64_t connectsFailed = 0;
+    uint64_t loggedIn = 0;
+    uint64_t loginFailures = 0;
+    uint64_t disconnects = 0;           // Closed by the server after connecting
+    uint64_t commandsSent = 0;
+    uint64_t unanswered = 0;
+    uint64_t bytesIn = 0;
+    uint64_t unsolicitedBytes = 0;      // Received in the world with no command outstanding
+    uint64_t bytesOut = 0;
+    LatencyHistogram login;             // Connect to "Login Successful"
+    LatencyHistogram response;          // Command sent to its echo marker coming back
+
+    void Merge(const LoadStats& other);
+};
+
+/**
+ * @class LoadBot
+ * @brief One scripted client for the load generator: connects, logs in, then plays a weighted command mix.
+ *
+ * The bot walks the same prompts a person would: the main menu, character
+ * creation, then login. Each step waits for the server's prompt text before
+ * it answers. Once in the world it sends a command from the mix every think
+ * interval, followed by "echo <marker>". The server handles both in the same
+ * tick and flushes their output together, so the time until the marker comes
+ * back is the response latency. Room chatter and combat can't end the wait
+ * early; output that arrives with no command outstanding is counted as
+ * unsolicited instead.
+ *
+ * Not thread-safe; each worker thread owns its bots and polls their sockets
+ * through its own IEventReactor.
+ */
+class LoadBot {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LoadBot(const LoadBotConfig& config, int index, uint32_t seed);
+    ~LoadBot();
+
+    LoadBot(const LoadBot&) = delete;
+    LoadBot& operator=(const LoadBot&) = delete;
+
+    // Opens the connection (blocking, so local connects are quick), makes the
+    // socket non-blocking and registers it. Returns false if the server refused it.
+    bool Connect(IEventReactor& reactor, LoadStats& stats);
+    // Reads until the socket would block and answers any prompts found.
+    void OnReadable(LoadStats& stats);
+    // Sends the next command when it is due, retries unsent output and expires
+    // unanswered commands. Called on every pass of the worker loop.
+    void Update(Clock::time_point now, LoadStats& stats);
+    void Close();
+
+    SOCKET Socket() const { return socket; }
+    bool IsConnected() const { return socket != INVALID_SOCKET; }
+    bool IsPlaying() const { return phase == Phase::Playing; }
+    // True once the bot has stopped for good (login failed or the server hung up).
+    bool IsFinished() const { return phase == Phase::Failed || phase == Phase::Closed; }
+    // Auto login: the name was taken, so the next Connect logs in instead.
+    bool WantsReconnect() const { return reconnect; }
+
+    uint64_t BytesIn() const { return bytesIn; }
+    // From the first connect until now, or until the bot finished.
+    double ActiveSeconds(Clock::time_point now) const;
+
+private:
+    enum class Phase {
+        Handshake,          // WebSocket upgrade sent, waiting for 101
+        Menu,
+        CreateName,
+        CreatePassword,
+        CreateConfirm,
+        CreateDone,
+        LoginName,
+        LoginPassword,
+        LoginWait,
+        Playing,
+        Failed,
+        Closed
+    };
+
+    void Advance(LoadStats& stats);
+    // Finds 'prompt' in the received text and drops everything up to its end.
+    bool Consume(const char* prompt);
+    void SendLine(const std::string& line, LoadStats& stats);
+    void Flush(LoadStats& stats);
+    void ScheduleNextCommand(Clock::time_point now);
+    const std::string& PickCommand();
+    void Fail(const char* reason, LoadStats& stats);
+
+    // Protocol decoding into 'text'
+    void ReceiveTelnet(const char* data, size_t length);
+    void ReceiveWebSocket(const char* data, size_t length);
+    void QueueWebSocketFrame(uint8_t opcode, const char* payload, size_t length);
+
+    const LoadBotConfig& config;
+    std::string name;
+    std::mt19937 rng;
+    IEventReactor* reactor = nullptr;
+    SOCKET socket = INVALID_SOCKET;
+    Phase phase = Phase::Closed;
+    bool reconnect = false;
+    bool loginMode = false;             // This connection logs in rather than creating
+
+    std::string text;                   // Decoded text not yet matched against a prompt
+    std::string raw;                    // Received bytes not yet decoded (partial frames)
+    std::string outbox;                 // Bytes the socket has not taken yet
+    int telnetState = 0;                // Position inside an IAC sequence
+    uint8_t telnetCommand = 0;
+
+    Clock::time_point startedAt;
+    Clock::time_point finishedAt;
+    bool started = false;
+    Clock::time_point connectedAt;
+    Clock::time_point nextCommandAt;
+    Clock::time_point commandSentAt;
+    bool awaitingResponse = false;
+    uint32_t commandSequence = 0;
+    std::string pendingMarker;          // Echo text that answers the outstanding command
+    uint64_t bytesIn = 0;
+};
@@ -0,0 +1,359 @@
+// Load generator: a fleet of LoadBots against a running server. Each bot opens
+// its own telnet or WebSocket connection, walks the main menu into the world
+// (creating its character the first time) and then plays a weighted command mix.
+// Each command is followed by "echo <marker>", and the response latency runs
+// until that marker comes back, so broadcasts from other bots don't count.
+// The report shows command-to-response latency and bytes/sec per client while
+// the fleet ramps up, so the connection count where the server's tick time
+// blows its budget shows up as the point where response latency climbs.
+//
+// Start the server with --load-test, which adds the echo command, and with
+// --ip-connect-rate=0; every bot connects from the same address and the
+// default per-IP limit would refuse most of them. Ramping faster than 100/s
+// also needs --connect-rate=0.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LoadBot.h"
+#include "IEventReactor.h"
+#include "NetworkBackend.h"
+#include "SocketPlatform.h"
+#ifdef _WIN32
+#pragma comment (lib, "Ws2_32.lib")
+#endif
+
+// "look" is not a server command, so it is left out.
+static const char* DEFAULT_MIX =
+    "north:3,south:3,east:2,west:2,attack goblin grunt:2,cast punch goblin grunt:1,pickup stick:1,say hello:1";
+
+struct LoadOptions {
+    LoadBotConfig bot;
+    int clientCount = 100;
+    int threadCount = 4;
+    double rampPerSecond = 50;    // New connections per second across all threads
+    int durationSeconds = 60;
+    int reportSeconds = 5;
+    int firstIndex = 0;
+    uint32_t seed = 1;
+    NetworkBackend backend = NetworkBackend::Auto;
+};
+
+// One thread's share of the fleet. The thread fills 'local' and hands it over
+// to 'window' under the mutex a few times a second; the report takes 'window'.
+struct LoadWorker {
+    std::vector<std::unique_ptr<LoadBot>> bots;
+    std::thread thread;
+    std::mutex mutex;
+    LoadStats window;
+    int connected = 0;
+    int playing = 0;
+};
+
+static std::atomic<bool> stopping{ false };
+
+// "cmd:weight,cmd:weight"; the weight is after the last colon and defaults to 1.
+static bool ParseMix(const std::string& spec, LoadBotConfig& config) {
+    config.mix.clear();
+    config.totalWeight = 0;
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) end = spec.size();
+        std::string entry = spec.substr(start, end - start);
+        start = end + 1;
+        if (entry.empty()) continue;
+
+        LoadCommand command;
+        command.text = entry;
+        size_t colon = entry.rfind(':');
+        if (colon != std::string::npos && colon + 1 < entry.size() &&
+            entry.find_first_not_of("0123456789", colon + 1) == std::string::npos) {
+            command.text = entry.substr(0, colon);
+            command.weight = std::atoi(entry.substr(colon + 1).c_str());
+        }
+        if (command.text.empty() || command.weight <= 0) continue;
+        config.totalWeight += command.weight;
+        config.mix.push_back(command);
+    }
+    return !config.mix.empty();
+}
+
+static void RunWorker(LoadWorker& worker, const LoadOptions& options) {
+    std::unique_ptr<IEventReactor> reactor = CreateEventReactor(options.backend);
+    if (!reactor) {
+        printf("[Load] Worker could not set up its event loop\n");
+        return;
+    }
+    std::vector<ReactorEvent> events;
+    LoadStats local;
+
+    // This thread's share of the ramp rate
+    double perThreadRate = options.rampPerSecond / options.threadCount;
+    auto connectInterval = std::chrono::duration_cast<LoadBot::Clock::duration>(
+        std::chrono::duration<double>(perThreadRate > 0 ? 1.0 / perThreadRate : 0.0));
+    LoadBot::Clock::time_point nextConnect = LoadBot::Clock::now();
+    LoadBot::Clock::time_point nextHandOver = nextConnect;
+    size_t launched = 0;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        LoadBot::Clock::time_point now = LoadBot::Clock::now();
+        while (launched < worker.bots.size() && now >= nextConnect) {
+            worker.bots[launched++]->Connect(*reactor, local);
+            nextConnect += connectInterval;
+        }
+
+        // Short timeout: commands fall due and unsent output is retried on this loop
+        reactor->Wait(events, 10);
+        for (const ReactorEvent& event : events) {
+            LoadBot* bot = static_cast<LoadBot*>(event.userData);
+            if (bot && (event.readable || event.hangup)) bot->OnReadable(local);
+        }
+
+        now = LoadBot::Clock::now();
+        for (size_t i = 0; i < launched; i++) {
+            LoadBot& bot = *worker.bots[i];
+            if (!bot.IsConnected() && bot.WantsReconnect()) bot.Connect(*reactor, local);
+            bot.Update(now, local);
+        }
+
+        if (now >= nextHandOver) {
+            int connected = 0, playing = 0;
+            for (size_t i = 0; i < launched; i++) {
+                if (worker.bots[i]->IsConnected()) connected++;
+                if (worker.bots[i]->IsPlaying()) playing++;
+            }
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.window.Merge(local);
+            worker.connected = connected;
+            worker.playing = playing;
+            local = LoadStats();
+            nextHandOver = now + std::chrono::milliseconds(100);
+        }
+    }
+
+    for (size_t i = 0; i < launched; i++) worker.bots[i]->Close();
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.window.Merge(local);
+}
+
+static void PrintLatency(const char* label, const LatencyHistogram& histogram) {
+    printf("[Load] %s: n=%llu p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms\n", label,
+        (unsigned long long)histogram.Count(),
+        histogram.Percentile(50) / 1000.0, histogram.Percentile(90) / 1000.0,
+        histogram.Percentile(99) / 1000.0, histogram.MaxMicros() / 1000.0);
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    std::string mix = DEFAULT_MIX;
+    bool portGiven = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        // --clients=N bots in total (default 100), spread over --threads=T (default 4)
+        if (arg.rfind("--clients=", 0) == 0) {
+            options.clientCount = std::max(1, std::atoi(arg.substr(10).c_str()));
+        }
+        else if (arg.rfind("--threads=", 0) == 0) {
+            options.threadCount = std::max(1, std::atoi(arg.substr(10).c_str()));
+        }
+        // --host=ADDR and --port=P (default 127.0.0.1, 27015 for telnet and 27016 for json)
+        else if (arg.rfind("--host=", 0) == 0) {
+            options.bot.host = arg.substr(7);
+        }
+        else if (arg.rfind("--port=", 0) == 0) {
+            options.bot.port = arg.substr(7);
+            portGiven = true;
+        }
+        // --protocol=telnet|json: plain telnet lines or WebSocket frames with the hello packet
+        else if (arg.rfind("--protocol=", 0) == 0) {
+            std::string protocol = arg.substr(11);
+            if (protocol == "json") options.bot.protocol = LoadProtocol::Json;
+            else if (protocol == "telnet") options.bot.protocol = LoadProtocol::Telnet;
+            else {
+                printf("[Load] Unknown protocol %s (telnet or json)\n", protocol.c_str());
+                return 2;
+            }
+        }
+        // --login=create|existing|auto (default auto: create, or log in if the name exists)
+        else if (arg.rfind("--login=", 0) == 0) {
+            std::string login = arg.substr(8);
+            if (login == "create") options.bot.login = LoadLogin::Create;
+            else if (login == "existing") options.bot.login = LoadLogin::Existing;
+            else if (login == "auto") options.bot.login = LoadLogin::Auto;
+            else {
+                printf("[Load] Unknown login mode %s (create, existing or auto)\n", login.c_str());
+                return 2;
+            }
+        }
+        // --prefix=NAME and --first=N: bot i is NAME<N+i> (default bot0, bot1, ...)
+        else if (arg.rfind("--prefix=", 0) == 0) {
+            options.bot.namePrefix = arg.substr(9);
+        }
+        else if (arg.rfind("--first=", 0) == 0) {
+            options.firstIndex = std::max(0, std::atoi(arg.substr(8).c_str()));
+        }
+        else if (arg.rfind("--password=", 0) == 0) {
+            options.bot.password = arg.substr(11);
+        }
+        // --mix="north:3,attack goblin grunt:1" weights the commands sent once in the world
+        else if (arg.rfind("--mix=", 0) == 0) {
+            mix = arg.substr(6);
+        }
+        // --think=MS mean pause between a bot's commands (default 1000)
+        else if (arg.rfind("--think=", 0) == 0) {
+            options.bot.thinkMs = std::max(1, std::atoi(arg.substr(8).c_str()));
+        }
+        // --timeout=MS a command whose echo marker hasn't come back by then counts as unanswered (default 5000)
+        else if (arg.rfind("--timeout=", 0) == 0) {
+            options.bot.responseTimeoutMs = std::max(1, std::atoi(arg.substr(10).c_str()));
+        }
+        // --ramp=N new connections per second (default 50, 0 = all at once)
+        else if (arg.rfind("--ramp=", 0) == 0) {
+            options.rampPerSecond = std::max(0.0, std::atof(arg.substr(7).c_str()));
+        }
+        // --duration=S total run time (default 60); --report=S between progress lines (default 5)
+        else if (arg.rfind("--duration=", 0) == 0) {
+            options.durationSeconds = std::max(1, std::atoi(arg.substr(11).c_str()));
+        }
+        else if (arg.rfind("--report=", 0) == 0) {
+            options.reportSeconds = std::max(1, std::atoi(arg.substr(9).c_str()));
+        }
+        // --seed=S seeds think times and command picks (default 1)
+        else if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(arg.substr(7).c_str(), nullptr, 10));
+        }
+        // --net=select|epoll picks the readiness backend for the worker threads
+        else if (arg.rfind("--net=", 0) == 0) {
+            options.backend = ParseNetworkBackend(arg.substr(6));
+        }
+        else {
+            printf("[Load] Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    if (!portGiven && options.bot.protocol == LoadProtocol::Json) options.bot.port = "27016";
+    if (!ParseMix(mix, options.bot)) {
+        printf("[Load] No commands in mix \"%s\"\n", mix.c_str());
+        return 2;
+    }
+    std::string longestName = options.bot.namePrefix + std::to_string(options.firstIndex + options.clientCount - 1);
+    if (options.bot.namePrefix.size() + 1 < 3 || longestName.size() > 20) {
+        printf("[Load] Bot names must be 3-20 characters; %s doesn't fit\n", longestName.c_str());
+        return 2;
+    }
+    if (options.bot.password.size() < 4) {
+        printf("[Load] The server wants passwords of at least 4 characters\n");
+        return 2;
+    }
+    options.threadCount = std::min(options.threadCount, options.clientCount);
+
+    if (!SocketPlatform::Startup()) {
+        printf("[Load] Socket startup failed\n");
+        return 2;
+    }
+
+    // Bot i goes to worker i % threads, so every worker ramps at the same pace
+    std::vector<std::unique_ptr<LoadWorker>> workers;
+    for (int t = 0; t < options.threadCount; t++) {
+        workers.push_back(std::make_unique<LoadWorker>());
+    }
+    for (int i = 0; i < options.clientCount; i++) {
+        int index = options.firstIndex + i;
+        workers[i % options.threadCount]->bots.push_back(
+            std::make_unique<LoadBot>(options.bot, index, options.seed * 2654435761u + static_cast<uint32_t>(index)));
+    }
+
+    printf("[Load] %d %s clients against %s:%s on %d threads, ramping %.0f/s, %d s\n",
+        options.clientCount, options.bot.protocol == LoadProtocol::Json ? "json" : "telnet",
+        options.bot.host.c_str(), options.bot.port.c_str(), options.threadCount,
+        options.rampPerSecond, options.durationSeconds);
+#ifdef _WIN32
+    if (options.clientCount / options.threadCount >= FD_SETSIZE) {
+        printf("[Load] Warning: %d sockets per thread is past FD_SETSIZE (%d); use more --threads\n",
+            options.clientCount / options.threadCount, FD_SETSIZE);
+    }
+#endif
+
+    for (auto& worker : workers) {
+        LoadWorker* w = worker.get();
+        w->thread = std::thread([w, &options] { RunWorker(*w, options); });
+    }
+
+    LoadStats total;
+    auto start = LoadBot::Clock::now();
+    auto end = start + std::chrono::seconds(options.durationSeconds);
+    auto nextReport = start + std::chrono::seconds(options.reportSeconds);
+    auto lastReport = start;
+    while (LoadBot::Clock::now() < end) {
+        std::this_thread::sleep_until(std::min(nextReport, end));
+        auto now = LoadBot::Clock::now();
+
+        LoadStats window;
+        int connected = 0, playing = 0;
+        for (auto& worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            window.Merge(worker->window);
+            worker->window = LoadStats();
+            connected += worker->connected;
+            playing += worker->playing;
+        }
+        total.Merge(window);
+
+        // Latency over the last interval, so it shows when the server started to lag
+        double seconds = std::chrono::duration<double>(now - lastReport).count();
+        printf("[Load] %5.0fs: %d connected, %d playing, %.0f cmd/s, response p50 %.1f ms p99 %.1f ms, %.1f KB/s in, %llu unanswered\n",
+            std::chrono::duration<double>(now - start).count(), connected, playing,
+            window.commandsSent / seconds,
+            window.response.Percentile(50) / 1000.0, window.response.Percentile(99) / 1000.0,
+            window.bytesIn / seconds / 1024.0, (unsigned long long)window.unanswered);
+        lastReport = now;
+        nextReport += std::chrono::seconds(options.reportSeconds);
+    }
+
+    stopping = true;
+    for (auto& worker : workers) worker->thread.join();
+    auto finished = LoadBot::Clock::now();
+    for (auto& worker : workers) total.Merge(worker->window);
+
+    // Per-client receive rate over each bot's own connected time
+    std::vector<double> rates;
+    for (auto& worker : workers) {
+        for (auto& bot : worker->bots) {
+            double seconds = bot->ActiveSeconds(finished);
+            if (seconds > 0) rates.push_back(bot->BytesIn() / seconds);
+        }
+    }
+    std::sort(rates.begin(), rates.end());
+
+    double seconds = std::chrono::duration<double>(finished - start).count();
+    printf("[Load] --- %.0f s, %d clients ---\n", seconds, options.clientCount);
+    printf("[Load] Connections: %llu attempted, %llu failed, %llu dropped by the server\n",
+        (unsigned long long)total.connectsAttempted, (unsigned long long)total.connectsFailed,
+        (unsigned long long)total.disconnects);
+    printf("[Load] Logins: %llu succeeded, %llu failed\n",
+        (unsigned long long)total.loggedIn, (unsigned long long)total.loginFailures);
+    PrintLatency("Login", total.login);
+    PrintLatency("Response", total.response);
+    printf("[Load] Commands: %llu sent, %llu unanswered after %d ms\n",
+        (unsigned long long)total.commandsSent, (unsigned long long)total.unanswered, options.bot.responseTimeoutMs);
+    printf("[Load] Traffic: %.1f KB/s in (%.1f KB/s unsolicited), %.1f KB/s out\n",
+        total.bytesIn / seconds / 1024.0, total.unsolicitedBytes / seconds / 1024.0, total.bytesOut / seconds / 1024.0);
+    if (!rates.empty()) {
+        printf("[Load] Per client in: p50 %.0f B/s, p99 %.0f B/s, max %.0f B/s\n",
+            rates[rates.size() / 2], rates[std::min(rates.size() - 1, rates.size() * 99 / 100)], rates.back());
+    }
+
+    workers.clear();
+    SocketPlatform::Cleanup();
+    return 0;
+}
@@ -4,13 +4,15 @@
 #include "ClientConnection.h"
 #include "PlayingState.h"
 #include "PlayerFactory.h"
+#include "AuthService.h"
 
 class LoginState : public GameState
 {
 public:
     enum class LoginStep {
         USERNAME,
-        PASSWORD
+        PASSWORD,
+        WAITING         // An AuthService request is running; input is held off
     };
 
     LoginState() : step(LoginStep::USERNAME) {}
@@ -20,7 +22,7 @@ public:
         client->QueueMessage("Enter your username:\r\n");
     }
 
-    void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+    void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
         if (p.empty()) return;
 
         GameEngine* engine = client->GetEngine();
@@ -28,48 +30,70 @@ public:
         switch (step) {
         case LoginStep::USERNAME:
             tempUsername = p[0];
+            step = LoginStep::WAITING;
+            ticket = engine->gameContext.auth->Submit(AuthRequestKind::NameExists, client->clientID, tempUsername);
+            break;
 
-            if (!engine->gameContext.db->PlayerExists(tempUsername)) {
-                client->QueueMessage("User not found.\r\n");
-                client->QueueMessage("Enter your username:\r\n");
-                return;
-            }
+        case LoginStep::PASSWORD:
+            step = LoginStep::WAITING;
+            ticket = engine->gameContext.auth->Submit(AuthRequestKind::Login, client->clientID, tempUsername, p[0]);
+            break;
 
-            step = LoginStep::PASSWORD;
-            client->QueueMessage("Enter your password:\r\n");
+        case LoginStep::WAITING:
+            client->QueueMessage("Please wait...\r\n");
             break;
+        }
+    }
 
-        case LoginStep::PASSWORD:
-            if (!engine->gameContext.db->VerifyPassword(tempUsername, p[0])) {
-                client->QueueMessage("Incorrect password.\r\n");
-                client->QueueMessage("Enter your username:\r\n");
-                step = LoginStep::USERNAME;
-                tempUsername.clear();
-                return;
-            }
+    void OnAuthResult(ClientConnection* client, const AuthResult& result) override {
+        if (step != LoginStep::WAITING || result.ticket != ticket) return;
 
-            // Password verified, load the player
-            {
-                EntityID playerEntity = engine->LoadPlayer(client, tempUsername);
+        GameEngine* engine = client->GetEngine();
 
-                if (playerEntity != -1) {
-                    client->playerEntityID = playerEntity;
-                    client->QueueMessage("Login Successful! Entering world...\r\n");
-                    client->GetEngine()->gameContext.registry->AddComponent<PlayerLoginComponent>(client->playerEntityID);
-                    client->PushState(new PlayingState(engine->GetContext()));
-                }
-                else {
-                    client->QueueMessage("Login Failed (DB error).\r\n");
-                    client->QueueMessage("Enter your username:\r\n");
-                    step = LoginStep::USERNAME;
-                    tempUsername.clear();
-                }
+        if (result.kind == AuthRequestKind::NameExists) {
+            if (result.status != AuthStatus::Ok) {
+                client->QueueMessage("User not found.\r\n");
+                Restart(client);
+                return;
             }
+            step = LoginStep::PASSWORD;
+            client->QueueMessage("Enter your password:\r\n");
+            return;
+        }
+
+        switch (result.status) {
+        case AuthStatus::Ok: {
+            // Password verified and the row is loaded; build the player
+            EntityID playerEntity = engine->SpawnPlayer(client, result.player);
+            client->playerEntityID = playerEntity;
+            client->QueueMessage("Login Successful! Entering world...\r\n");
+            engine->gameContext.registry->AddComponent<PlayerLoginComponent>(client->playerEntityID);
+            client->PushState(new PlayingState(engine->GetContext()));
+            break;
+        }
+        case AuthStatus::NotFound:
+            client->QueueMessage("User not found.\r\n");
+            Restart(client);
+            break;
+        case AuthStatus::BadPassword:
+            client->QueueMessage("Incorrect password.\r\n");
+            Restart(client);
+            break;
+        default:
+            client->QueueMessage("Login Failed (DB error).\r\n");
+            Restart(client);
             break;
         }
     }
 
 private:
+    void Restart(ClientConnection* client) {
+        client->QueueMessage("Enter your username:\r\n");
+        step = LoginStep::USERNAME;
+        tempUsername.clear();
+    }
+
     LoginStep step;
     std::string tempUsername;
+    uint64_t ticket = 0;
 };
@@ -52,6 +52,9 @@ public:
         return "";
     }
 
+    // Fixed seed for repeatable runs (the headless simulation)
+    void Seed(uint32_t seed) { rng.seed(seed); }
+
 private:
     std::mt19937 rng{ std::random_device{}() };
 };
@@ -1,45 +1,207 @@
 #include "Server.h"
 #include <thread>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
 #include "GameEngine.h"
 #include "GameContext.h"
 #include "ClientInput.h"
+#include "AuthService.h"
+#include "ConnectionLimiter.h"
+#include "TickScheduler.h"
+#include "CommandInterpreter.h"
 // Need to link with Ws2_32.lib
+#ifdef _WIN32
 #pragma comment (lib, "Ws2_32.lib")
+#endif
 // #pragma comment (lib, "Mswsock.lib")
 
 #define DEFAULT_BUFLEN 1024
 #define DEFAULT_PORT "27015"
+#define DEFAULT_WS_PORT "27016"
+
+int main(int argc, char* argv[]) {
+    // --net=select|epoll|uring picks the socket backend (default: best available)
+    NetworkBackend backend = NetworkBackend::Auto;
+    int ioThreads = 1;
+    int authThreads = 2;
+    int tickRate = 30;
+    // Systems run in order on the game thread unless workers are asked for. Few
+    // of them overlap; the workers mainly split network sync's map renders.
+    int systemThreads = 0;
+    TelnetConfig telnetConfig;
+    ConnectionLimits connectionLimits;
+    std::string webSocketPort = DEFAULT_WS_PORT;
+    std::vector<std::string> admins;
+    std::string recordPath;
+    bool loadTest = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--net=", 0) == 0) {
+            backend = ParseNetworkBackend(arg.substr(6));
+        }
+        // --io-threads=N serves connections from N network threads (default 1)
+        else if (arg.rfind("--io-threads=", 0) == 0) {
+            ioThreads = std::max(1, std::atoi(arg.substr(13).c_str()));
+        }
+        // --mccp-level=0..9 sets the MCCP2 zlib level (0 turns compression off)
+        else if (arg.rfind("--mccp-level=", 0) == 0) {
+            int level = std::atoi(arg.substr(13).c_str());
+            telnetConfig.enableCompression = level > 0;
+            telnetConfig.compressionLevel = std::min(9, std::max(1, level));
+        }
+        // --mccp-memory=KB caps the zlib state kept per compressed connection
+        else if (arg.rfind("--mccp-memory=", 0) == 0) {
+            telnetConfig.compressionMemory = static_cast<size_t>(std::max(1, std::atoi(arg.substr(14).c_str()))) * 1024;
+        }
+        // --auth-threads=N runs logins and account writes on N workers (default 2)
+        else if (arg.rfind("--auth-threads=", 0) == 0) {
+            authThreads = std::max(1, std::atoi(arg.substr(15).c_str()));
+        }
+        // --connect-rate=N caps new connections per second server-wide (0 turns it off)
+        else if (arg.rfind("--connect-rate=", 0) == 0) {
+            connectionLimits.globalRate = std::max(0.0, std::atof(arg.substr(15).c_str()));
+            connectionLimits.globalBurst = std::max(1.0, connectionLimits.globalRate * 3);
+        }
+        // --ip-connect-rate=N caps new connections per second from one address (0 turns it off)
+        else if (arg.rfind("--ip-connect-rate=", 0) == 0) {
+            connectionLimits.perIpRate = std::max(0.0, std::atof(arg.substr(18).c_str()));
+        }
+        // --tick-rate=N runs the world at N ticks per second (default 30)
+        else if (arg.rfind("--tick-rate=", 0) == 0) {
+            tickRate = std::min(1000, std::max(1, std::atoi(arg.substr(12).c_str())));
+        }
+        // --system-threads=N runs independent systems on N workers (default 0 runs them in order)
+        else if (arg.rfind("--system-threads=", 0) == 0) {
+            systemThreads = std::max(0, std::atoi(arg.substr(17).c_str()));
+        }
+        // --ws-port=N moves the WebSocket listener (0 turns it off)
+        else if (arg.rfind("--ws-port=", 0) == 0) {
+            webSocketPort = arg.substr(10);
+        }
+        // --admins=Name,Name lets these characters use admin commands (profile)
+        else if (arg.rfind("--admins=", 0) == 0) {
+            std::stringstream names(arg.substr(9));
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) admins.push_back(name);
+            }
+        }
+        // --record=FILE logs every command, connect and disconnect by tick for ModularMudSim --replay
+        else if (arg.rfind("--record=", 0) == 0) {
+            recordPath = arg.substr(9);
+        }
+        // --load-test adds the echo command ModularMudLoad matches its responses with
+        else if (arg == "--load-test") {
+            loadTest = true;
+        }
+    }
 
-int __cdecl main(void) {
-   
     GameContext ctx;
-	ThreadSafeQueue<ClientInput> inputQueue;
-    GameEngine engine(ctx, inputQueue);
-    Server server(ctx, &engine, inputQueue);
-	server.Start(DEFAULT_PORT);
-    std::thread networkThread([&server]() {
-        server.Run();
-        });
-    networkThread.detach();
-
-    // 2. Run the Game Engine on the Main Thread
-    // This is your "New Loop"
-    const int TICKS_PER_SECOND = 30;
-    const int SKIP_TICKS = 1000 / TICKS_PER_SECOND;
+    std::vector<std::unique_ptr<MpscQueue<ClientInput>>> inputQueues;
+    inputQueues.push_back(std::make_unique<MpscQueue<ClientInput>>());
+    GameEngine engine(ctx, *inputQueues[0]);
+    ctx.auth->Start(authThreads);
+    engine.SetSystemThreads(systemThreads);
+    ctx.interpreter->SetAdmins(admins);
+    if (loadTest) {
+        ctx.interpreter->EnableLoadTestCommands();
+    }
+    if (!recordPath.empty()) {
+        engine.StartRecording(recordPath, tickRate);
+    }
+    ConnectionLimiter connectionLimiter(connectionLimits);
+    ClientConnection::ReservePool(256);
+
+    // 1. One Server per I/O shard, each with its own input queue
+    std::vector<std::unique_ptr<Server>> servers;
+    std::vector<Server*> shards;
+    for (int i = 0; i < ioThreads; i++) {
+        if (i > 0) {
+            inputQueues.push_back(std::make_unique<MpscQueue<ClientInput>>());
+            engine.AddInputQueue(inputQueues[i].get());
+        }
+        servers.push_back(std::make_unique<Server>(ctx, &engine, *inputQueues[i]));
+        servers[i]->shardIndex = i;
+        servers[i]->SetTelnetConfig(telnetConfig);
+        // permessage-deflate follows the same level and memory budget as MCCP2
+        WebSocketConfig webSocketConfig;
+        webSocketConfig.enableDeflate = telnetConfig.enableCompression;
+        webSocketConfig.compressionLevel = telnetConfig.compressionLevel;
+        webSocketConfig.compressionMemory = telnetConfig.compressionMemory;
+        servers[i]->SetWebSocketConfig(webSocketConfig);
+        servers[i]->SetConnectionLimiter(&connectionLimiter);
+        shards.push_back(servers[i].get());
+    }
+
+    // With SO_REUSEPORT every shard listens and the kernel balances accepts.
+    // Otherwise shard 0 accepts and hands clients to the shards round-robin.
+    bool reusePort = ioThreads > 1 && SocketPlatform::HasReusePort();
+    for (int i = 0; i < ioThreads; i++) {
+        if (i == 0 || reusePort) {
+            if (!servers[i]->Start(DEFAULT_PORT, backend, reusePort)) {
+                printf("Shard %d failed to start\n", i);
+            }
+            else if (webSocketPort != "0" && !servers[i]->ListenWebSocket(webSocketPort.c_str(), reusePort)) {
+                printf("Shard %d failed to listen for WebSocket clients\n", i);
+            }
+        }
+        else if (!servers[i]->StartWorker(backend)) {
+            printf("I/O shard %d failed to start\n", i);
+        }
+    }
+    // Shard 0 always owns a listener; without it nobody can connect.
+    if (!servers[0]->HasBackend()) {
+        printf("Shard 0 failed to start; exiting\n");
+        return 1;
+    }
+
+    // Only shards with a running event loop get clients or a thread.
+    std::vector<Server*> liveShards;
+    for (Server* shard : shards) {
+        if (shard->HasBackend()) {
+            liveShards.push_back(shard);
+        }
+    }
+    if (!reusePort) {
+        servers[0]->SetAcceptPeers(liveShards);
+    }
+
+    for (Server* shard : liveShards) {
+        std::thread networkThread([shard]() {
+            shard->Run();
+            });
+        networkThread.detach();
+    }
 
+    // 2. Run the Game Engine on the Main Thread, at a fixed timestep. After a
+    // slow tick the ticks that fell due run back to back, so game time keeps
+    // up with the wall clock.
+    TickScheduler scheduler(tickRate);
     while (engine.IsRunning()) {
-        auto next_game_tick = GetTickCount64() + SKIP_TICKS;
+        int dueTicks = scheduler.DueTicks();
+        for (int i = 0; i < dueTicks && engine.IsRunning(); i++) {
+            scheduler.BeginTick();
 
-        engine.ProcessInputs();
+            // A. Commands received since the last tick
+            engine.ProcessInputs();
 
-        // B. Update Game World
-        engine.Update(0.033f);
+            // B. Update Game World
+            engine.Update(scheduler.StepSeconds());
 
-        // C. Sleep to maintain framerate
-        int sleep_time = next_game_tick - GetTickCount64();
-        if (sleep_time > 0) {
-            Sleep(sleep_time);
+            // Let the network thread flush this tick's output without polling for it.
+            for (Server* shard : liveShards) {
+                shard->Wake();
+            }
+            scheduler.EndTick();
         }
+        scheduler.LogStatsIfDue();
+
+        // C. Sleep until the next tick is due
+        scheduler.WaitForNextTick();
     }
 
     return 0;
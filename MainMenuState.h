@@ -10,7 +10,7 @@ class MainMenuState : public GameState {
         client->QueueMessage("ENTERING MAIN MENU\r\nType Login to go to login\r\nType Anything else to go to Char creation ");
     }
 
-    void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+    void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
         if(p[0] == "Login")
         {
             client->PushState(new LoginState());
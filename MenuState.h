@@ -91,7 +91,7 @@ public:
         client->QueueMessage(menuText.str());
     }
 
-    void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+    void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
         std::string input = p[0];
 
         if (input == "exit" || input == "back") {
@@ -6,6 +6,8 @@
 #include "ItemComponent.h"
 #include "NameComponent.h"
 #include "TextHelperFunctions.h"
+#include "SharedMessage.h"
+#include <algorithm>
 
 MessageSystem::~MessageSystem() {
     // Destructor - nothing special to clean up
@@ -41,9 +43,138 @@ void MessageSystem::ToPlayer(int entityID, std::string msg)
 
 void MessageSystem::ToRoom(int roomID, std::string msg, int excludeID)
 {
+	auto it = roomListeners.find(roomID);
+	if (it == roomListeners.end()) return;
+
+	SharedMessage shared(GameMessage("room_message", msg));
+	std::vector<Listener>& listeners = it->second;
+
+	for (size_t i = 0; i < listeners.size();) {
+		ClientComponent* client = Resolve(listeners[i]);
+
+		// Clients that disconnected without RemoveClient are dropped here
+		if (!client) {
+			listenerRoom.erase(listeners[i].entity);
+			listeners[i] = listeners.back();
+			listeners.pop_back();
+			continue;
+		}
+		if (listeners[i].entity != excludeID) {
+			shared.DeliverTo(*client);
+		}
+		i++;
+	}
+}
+
+void MessageSystem::EnterRoom(int entityID, int roomID)
+{
+	ClientComponent* client = ctx.registry->GetComponent<ClientComponent>(entityID);
+	if (!client || !client->client) return;
+
+	auto filed = listenerRoom.find(entityID);
+	if (filed != listenerRoom.end()) {
+		if (filed->second == roomID) return;
+		LeaveRoom(entityID);
+	}
+	if (roomID < 0) return;
+
+	roomListeners[roomID].push_back(Listener{ entityID, client->client->clientID });
+	listenerRoom[entityID] = roomID;
+}
+
+void MessageSystem::RemoveClient(int entityID)
+{
+	LeaveRoom(entityID);
+	// Channel entries are keyed by session, so they lapse on their own
+}
+
+void MessageSystem::LeaveRoom(int entityID)
+{
+	auto filed = listenerRoom.find(entityID);
+	if (filed == listenerRoom.end()) return;
+
+	auto it = roomListeners.find(filed->second);
+	if (it != roomListeners.end()) {
+		std::vector<Listener>& listeners = it->second;
+		for (size_t i = 0; i < listeners.size(); i++) {
+			if (listeners[i].entity == entityID) {
+				listeners[i] = listeners.back();
+				listeners.pop_back();
+				break;
+			}
+		}
+		if (listeners.empty()) {
+			roomListeners.erase(it);
+		}
+	}
+	listenerRoom.erase(filed);
+}
+
+ClientComponent* MessageSystem::Resolve(const Listener& listener)
+{
+	ClientComponent* client = ctx.registry->GetComponent<ClientComponent>(listener.entity);
+	if (!client || !client->client || client->client->clientID != listener.session) return nullptr;
+	return client;
 }
 
 void MessageSystem::ToGlobal(std::string msg)
 {
+	SharedMessage shared(GameMessage("global_message", msg));
+
+	for (EntityID entity : ctx.registry->view<ClientComponent>()) {
+		ClientComponent* client = ctx.registry->GetComponent<ClientComponent>(entity);
+		if (client) {
+			shared.DeliverTo(*client);
+		}
+	}
+}
+
+void MessageSystem::JoinChannel(int entityID, const std::string& channel)
+{
+	ClientComponent* client = ctx.registry->GetComponent<ClientComponent>(entityID);
+	if (!client || !client->client) return;
+
+	std::vector<Listener>& members = channels[channel];
+	for (const Listener& member : members) {
+		if (member.entity == entityID && member.session == client->client->clientID) return;
+	}
+	members.push_back(Listener{ entityID, client->client->clientID });
+}
+
+void MessageSystem::LeaveChannel(int entityID, const std::string& channel)
+{
+	auto it = channels.find(channel);
+	if (it == channels.end()) return;
 
+	std::vector<Listener>& members = it->second;
+	members.erase(std::remove_if(members.begin(), members.end(),
+		[entityID](const Listener& member) { return member.entity == entityID; }), members.end());
+	if (members.empty()) {
+		channels.erase(it);
+	}
 }
+
+void MessageSystem::ToChannel(const std::string& channel, std::string msg, int excludeID)
+{
+	auto it = channels.find(channel);
+	if (it == channels.end()) return;
+
+	SharedMessage shared(GameMessage("channel_message", msg));
+	std::vector<Listener>& members = it->second;
+
+	for (size_t i = 0; i < members.size();) {
+		ClientComponent* client = Resolve(members[i]);
+
+		// Members whose session ended (logout, or the entity now belongs to
+		// another connection) are dropped lazily here
+		if (!client) {
+			members[i] = members.back();
+			members.pop_back();
+			continue;
+		}
+		if (members[i].entity != excludeID) {
+			shared.DeliverTo(*client);
+		}
+		i++;
+	}
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include "GameContext.h"
 
 class GameContext;
 class Registry;
+struct ClientComponent;
 
 class MessageSystem
 {
@@ -15,10 +18,36 @@ public:
 	void SubscribeToEvents();
 	void ToPlayer(int entityID, std::string msg);
 
+	// Broadcasts render the text once per client flavour and share it with every
+	// recipient (see SharedMessage).
 	// Send to everyone in the room (Web Novel 'System' broadcasts)
 	void ToRoom(int roomID, std::string msg, int excludeID = -1);
 	void ToGlobal(std::string msg);
 
+	// Room occupancy for ToRoom. Call EnterRoom whenever a client's roomId
+	// changes (login, movement, teleport) and RemoveClient before its
+	// ClientComponent goes away.
+	void EnterRoom(int entityID, int roomID);
+	void RemoveClient(int entityID);
+
+	// Named chat channels (e.g. "ooc", "trade")
+	void JoinChannel(int entityID, const std::string& channel);
+	void LeaveChannel(int entityID, const std::string& channel);
+	void ToChannel(const std::string& channel, std::string msg, int excludeID = -1);
+
 private:
+	// An entity together with the session it had when it was filed. If the
+	// entity's connection is gone or replaced, the session no longer matches
+	// and the entry is dropped instead of reaching whoever holds it now.
+	struct Listener {
+		int entity;
+		int session;
+	};
+
+	ClientComponent* Resolve(const Listener& listener);
+	void LeaveRoom(int entityID);
 
+	std::unordered_map<int, std::vector<Listener>> roomListeners;
+	std::unordered_map<int, int> listenerRoom;	// Entity -> room it is filed under
+	std::unordered_map<std::string, std::vector<Listener>> channels;
 };
\ No newline at end of file
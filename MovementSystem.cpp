@@ -9,6 +9,7 @@
 #include "Registry.h"
 #include "EventBus.h"       
 #include "ScriptManager.h"  
+#include "MessageSystem.h"
 
 #include "MoveIntentComponent.h"  
 #include "PositionComponent.h"    
@@ -52,6 +53,7 @@ void MovementSystem::MovementSystemRun() {
         if (!posComponent || !intent) continue;
 
         bool moved = false;
+        int startRoom = posComponent->roomId;
 
         // Portal logic...
         for (EntityID portalId : ctx.registry->view<PortalComponent>()) {
@@ -93,6 +95,11 @@ void MovementSystem::MovementSystemRun() {
             }
         }
         
+        // Portals and exits both land here; room broadcasts follow the player
+        if (posComponent->roomId != startRoom) {
+            ctx.messages->EnterRoom(entityId, posComponent->roomId);
+        }
+
         // Remove the intent after it has been processed.
         ctx.registry->RemoveComponent<MoveIntentComponent>(entityId);
     }
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class MpscQueue
+ * @brief Bounded lock-free multi-producer / single-consumer ring.
+ *
+ * Network threads call TryPush. The game thread is the only caller of TryPop
+ * and PopBatch. Each slot has a sequence number that tells producers and the
+ * consumer whose turn it is (Vyukov's bounded queue), so neither side takes a
+ * lock, and items are moved in and out rather than copied. When the ring is
+ * full, TryPush refuses the item and counts it as dropped instead of blocking
+ * the network thread.
+ */
+template<typename T>
+class MpscQueue {
+public:
+    // capacity is rounded up to a power of two.
+    explicit MpscQueue(size_t capacity = 4096) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread. Returns false (and counts a drop) if the ring is full.
+    bool TryPush(T item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only.
+    bool TryPop(T& out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &cells[pos & mask];
+        if (cell->sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        out = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer thread only: moves up to maxItems into 'out' in one call.
+    size_t PopBatch(std::vector<T>& out, size_t maxItems) {
+        size_t count = 0;
+        T item;
+        while (count < maxItems && TryPop(item)) {
+            out.push_back(std::move(item));
+            count++;
+        }
+        return count;
+    }
+
+    // Approximate while producers are active.
+    size_t Depth() const {
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    bool IsEmpty() const { return Depth() == 0; }
+    size_t Capacity() const { return mask + 1; }
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+
+    // Producers and the consumer write different cache lines.
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+    alignas(64) std::atomic<uint64_t> dropped{ 0 };
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+// Which socket multiplexer Server::Run uses. Chosen once at startup.
+enum class NetworkBackend {
+    Auto,     // Best available: epoll on Linux, select elsewhere
+    Select,   // Portable select() poll loop
+    Epoll,    // Edge-triggered epoll reactor (Linux)
+    IoUring   // Completion-based io_uring with a registered buffer pool (Linux)
+};
+
+inline NetworkBackend ParseNetworkBackend(const std::string& name) {
+    if (name == "select") return NetworkBackend::Select;
+    if (name == "epoll") return NetworkBackend::Epoll;
+    if (name == "uring" || name == "io_uring") return NetworkBackend::IoUring;
+    return NetworkBackend::Auto;
+}
+
+inline const char* NetworkBackendName(NetworkBackend backend) {
+    switch (backend) {
+    case NetworkBackend::Select: return "select";
+    case NetworkBackend::Epoll: return "epoll";
+    case NetworkBackend::IoUring: return "io_uring";
+    default: return "auto";
+    }
+}
+
+// Running totals kept by the network thread so backends can be compared under the
+// same load. "kernelCalls" counts every wait/recv/send (or io_uring_enter) made.
+// bytesOut, flushSends and tcpSegments divided by flushes give the per-flush cost.
+struct NetworkStats {
+    uint64_t wakeups = 0;
+    uint64_t kernelCalls = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t flushes = 0;           // Per-client tick flushes
+    uint64_t flushSends = 0;        // send/sendmsg calls (or linked SENDs) made by those flushes
+    uint64_t tcpSegments = 0;       // Data segments the kernel put on the wire (TCP_INFO, Linux)
+    uint64_t uncompressedBytes = 0; // Output before MCCP2 / permessage-deflate
+    uint64_t compressedBytes = 0;   // The same output after compression
+    uint64_t accepted = 0;          // Sockets accepted by this shard's listeners
+    uint64_t refused = 0;           // Of those, closed by the connection rate limit
+};
@@ -11,6 +11,11 @@
 #include "Room.h"
 #include "World.h"
 #include "ClientConnection.h"
+#include "ClientComponent.h"
+#include "StatComponent.h"
+#include "NetworkSystem.h"
+#include "JobSystem.h"
+#include <nlohmann/json.hpp>
 
 
 // Telnet Constants
@@ -24,14 +29,35 @@ NetworkSyncSystem::NetworkSyncSystem(GameContext& c) : ctx(c) {}
 
 
 void NetworkSyncSystem::Run() {
-    // Process entities whose position has changed.
-    for (EntityID id : ctx.registry->view<PositionChangedComponent>()) {
+    // Entities whose position has changed get a fresh map. Rendering one walks
+    // every visible entity, so the renders are split across the job workers;
+    // queueing them and removing the tags happen afterwards, in pool order.
+    ParallelForEach<PositionChangedComponent>(*ctx.jobs, *ctx.registry, lookCommands,
+        [this](EntityID id, PositionChangedComponent&, CommandBuffer& commands) {
+            ClientComponent* client = ctx.registry->GetComponent<ClientComponent>(id);
+            if (client && client->client) {
+                std::string look = RenderLook(client->client);
+                if (!look.empty()) {
+                    ClientConnection* connection = client->client;
+                    commands.Defer([connection, look = std::move(look)](Registry&) mutable {
+                        connection->QueueLatest(SupersededOutput::MapRender, std::move(look));
+                    });
+                }
+            }
+            commands.RemoveComponent<PositionChangedComponent>(id);
+        }, 4);  // A render is a whole-room walk, so a few per chunk is enough
+
+    // Vitals changed this tick (combat, healing, scripts' mark_dirty).
+    auto& vitalsChanged = ctx.registry->view<VitalsChangedComponent>();
+    for (EntityID id : vitalsChanged) {
         ClientComponent* client = ctx.registry->GetComponent<ClientComponent>(id);
-        if (client) {
-            SendLook(client->client);
+        if (client && client->client) {
+            SendVitals(*client, id);
         }
-        // Remove the tag component now that it has been processed.
-        ctx.registry->RemoveComponent<PositionChangedComponent>(id);
+    }
+    // Removing swaps the last entity into the hole, so clear from the back.
+    while (!vitalsChanged.empty()) {
+        ctx.registry->RemoveComponent<VitalsChangedComponent>(vitalsChanged.back());
     }
 
     // Process entities that have just logged in.
@@ -56,13 +82,21 @@ void NetworkSyncSystem::SendMapUpdate(ClientConnection* client)
 }
 
 void NetworkSyncSystem::SendLook(ClientConnection* client)
+{
+    std::string look = RenderLook(client);
+    if (look.empty()) return;
+    // A newer render replaces this one, so a congested client only gets the latest.
+    client->QueueLatest(SupersededOutput::MapRender, std::move(look));
+}
+
+std::string NetworkSyncSystem::RenderLook(ClientConnection* client)
 {
     // 1. Get Data
     PositionComponent* playerPos = ctx.registry->GetComponent<PositionComponent>(client->playerEntityID);
-    if (!playerPos) return;
+    if (!playerPos) return "";
 
     Room* room = ctx.worldManager->world->GetRoom(playerPos->roomId);
-    if (!room) return;
+    if (!room) return "";
 
     // Create an overlay grid to place entities on.
     std::vector<std::vector<VisualComponent*>> entityOverlay(
@@ -147,6 +181,27 @@ void NetworkSyncSystem::SendLook(ClientConnection* client)
     for (const std::string& line : gridRows) {
         text << line << "\r\n";
     }
-    
-    client->QueueMessage(TextHelperFunctions::Colorize(text.str()));
+
+    return TextHelperFunctions::Colorize(text.str());
+}
+
+void NetworkSyncSystem::SendVitals(const ClientComponent& client, EntityID id)
+{
+    StatComponent* stats = ctx.registry->GetComponent<StatComponent>(id);
+    if (!stats) return;
+
+    // Sidebar data only: plain telnet clients see their health in combat text.
+    nlohmann::json vitals = {
+        {"hp", stats->Health},
+        {"max_hp", stats->MaxHealth},
+        {"mana", stats->Mana}
+    };
+    GameMessage msg("vitals", "", std::move(vitals));
+
+    if (client.isWebClient) {
+        client.client->QueueLatest(SupersededOutput::Vitals, NetworkSystem::BuildWebEnvelope(msg, client.wireFormat));
+    }
+    else if (client.WantsGmcp()) {
+        client.client->QueueLatest(SupersededOutput::Vitals, NetworkSystem::BuildGMCPSession(msg.type, msg.uiData.dump()));
+    }
 }
\ No newline at end of file
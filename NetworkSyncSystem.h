@@ -4,7 +4,10 @@
 #include "TerrainDef.h"
 #include "EventBus.h"
 #include "GameContext.h";
+#include "ParallelFor.h"
+#include <string>
 class ClientConnection;
+struct ClientComponent;
 
 class NetworkSyncSystem {
 	GameContext& ctx;
@@ -15,5 +18,10 @@ public:
 	void Run();
 	void SendMapUpdate(ClientConnection* clientConnection);
 	void SendLook(ClientConnection* client);
+	// Only reads the world and the registry, so looks for several players can render at once.
+	std::string RenderLook(ClientConnection* client);
+	// GMCP / JSON vitals for clients with a sidebar; only the latest survives congestion.
+	void SendVitals(const ClientComponent& client, EntityID id);
 private:
+	DeferredCommands lookCommands;  // Queued looks and tag removals from the parallel render
 };
\ No newline at end of file
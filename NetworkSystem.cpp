@@ -2,11 +2,13 @@
 #include "ClientConnection.h"
 #include "WorldManager.h"
 
+#include "TelnetProtocol.h"
+
 // Telnet Constants for GMCP
-const char IAC = static_cast<char>(255);
-const char SB = static_cast<char>(250);
-const char SE = static_cast<char>(240);
-const char GMCP = static_cast<char>(201);
+const char IAC = static_cast<char>(Telnet::IAC);
+const char SB = static_cast<char>(Telnet::SB);
+const char SE = static_cast<char>(Telnet::SE);
+const char GMCP = static_cast<char>(Telnet::OPT_GMCP);
 
 void NetworkSystem::SetupListeners() 
 {
@@ -28,8 +30,8 @@ void NetworkSystem::SetupListeners()
             GameMessage msg;
             msg.type = "room_enter";
             msg.consoleText = "&w" + room->Name + "&w\r\n" + room->Description + "\r\n";
-            msg.jsonData = jsonData.dump();
-            client->QueueGameMessage(msg);
+            msg.uiData = std::move(jsonData);
+            client->QueueGameMessage(std::move(msg));
         }
     });
 }
@@ -44,9 +46,9 @@ void NetworkSystem::FlushQueues()
         
         for (const GameMessage& msg : clientComp->messageQueue) {
             if (clientComp->isWebClient) {
-                SendToWebClient(clientComp->client, msg);
+                SendToWebClient(clientComp->client, msg, clientComp->wireFormat);
             } else {
-                SendToTerminalClient(clientComp->client, msg, clientComp->hasSideBar);
+                SendToTerminalClient(clientComp->client, msg, clientComp->WantsGmcp());
             }
         }
         
@@ -54,10 +56,9 @@ void NetworkSystem::FlushQueues()
     }
 }
 
-void NetworkSystem::SendToWebClient(ClientConnection* client, const GameMessage& msg)
+void NetworkSystem::SendToWebClient(ClientConnection* client, const GameMessage& msg, WireFormat format)
 {
-    std::string jsonEnvelope = BuildJSONEnvelope(msg);
-    client->QueueMessage(jsonEnvelope);
+    client->QueueMessage(BuildWebEnvelope(msg, format));
 }
 
 void NetworkSystem::SendToTerminalClient(ClientConnection* client, const GameMessage& msg, bool hasSideBar)
@@ -66,30 +67,42 @@ void NetworkSystem::SendToTerminalClient(ClientConnection* client, const GameMes
     client->QueueMessage(TextHelperFunctions::Colorize(msg.consoleText));
     
     // Optionally send GMCP data for clients that support it (e.g., Mudlet)
-    if (hasSideBar && !msg.jsonData.empty() && msg.jsonData != "{}") {
-        std::string gmcpPacket = BuildGMCPSession(msg.type, msg.jsonData);
+    if (hasSideBar && msg.HasUiData()) {
+        std::string gmcpPacket = BuildGMCPSession(msg.type, msg.uiData.dump());
         client->SendPacket(gmcpPacket);
     }
 }
 
+json NetworkSystem::MakeEnvelope(const GameMessage& msg)
+{
+    return json{
+        {"type", msg.type},
+        {"console_text", msg.consoleText},
+        {"ui_data", msg.uiData.is_null() ? json::object() : msg.uiData}
+    };
+}
+
 std::string NetworkSystem::BuildJSONEnvelope(const GameMessage& msg)
 {
-    json envelope;
-    envelope["type"] = msg.type;
-    envelope["console_text"] = msg.consoleText;
-    
-    // Parse the stored JSON string back into a json object
-    if (!msg.jsonData.empty()) {
-        try {
-            envelope["ui_data"] = json::parse(msg.jsonData);
-        } catch (...) {
-            envelope["ui_data"] = json::object();
-        }
-    } else {
-        envelope["ui_data"] = json::object();
+    return MakeEnvelope(msg).dump() + "\n";
+}
+
+std::string NetworkSystem::BuildWebEnvelope(const GameMessage& msg, WireFormat format)
+{
+    // Binary envelopes are encoded straight from the tree: no JSON text is
+    // produced or parsed. Each one goes out as a single binary WebSocket message.
+    std::vector<uint8_t> bytes;
+    switch (format) {
+    case WireFormat::MsgPack:
+        json::to_msgpack(MakeEnvelope(msg), bytes);
+        break;
+    case WireFormat::Cbor:
+        json::to_cbor(MakeEnvelope(msg), bytes);
+        break;
+    default:
+        return BuildJSONEnvelope(msg);
     }
-    
-    return envelope.dump() + "\n";
+    return std::string(bytes.begin(), bytes.end());
 }
 
 std::string NetworkSystem::BuildGMCPSession(const std::string& module, const std::string& jsonDataStr)
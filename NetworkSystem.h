@@ -19,10 +19,15 @@ public:
 	NetworkSystem(GameContext& gc) : ctx(gc){};
 	void SetupListeners();
 	void FlushQueues();
-	
+
+	// Wire formats, shared with SharedMessage so broadcasts render identically.
+	static std::string BuildJSONEnvelope(const GameMessage& msg);
+	// The same envelope in the client's negotiated encoding (JSON text, MessagePack or CBOR).
+	static std::string BuildWebEnvelope(const GameMessage& msg, WireFormat format);
+	static std::string BuildGMCPSession(const std::string& moduleName, const std::string& jsonDataStr);
+
 private:
-	void SendToWebClient(ClientConnection* client, const GameMessage& msg);
+	static json MakeEnvelope(const GameMessage& msg);
+	void SendToWebClient(ClientConnection* client, const GameMessage& msg, WireFormat format);
 	void SendToTerminalClient(ClientConnection* client, const GameMessage& msg, bool hasSideBar);
-	std::string BuildJSONEnvelope(const GameMessage& msg);
-	std::string BuildGMCPSession(const std::string& moduleName, const std::string& jsonDataStr);
 };
@@ -0,0 +1,94 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// One immutable, ref-counted piece of outbound text. Several connections can
+// hold the same segment, and it is never copied again once it is queued.
+using OutboundSegment = std::shared_ptr<const std::string>;
+
+inline OutboundSegment MakeSegment(std::string text) {
+    return std::make_shared<const std::string>(std::move(text));
+}
+
+/**
+ * @class OutboundChain
+ * @brief FIFO of outbound segments plus how far into the front one the socket got.
+ *
+ * Gather() hands out (pointer, length) slices for writev/sendmsg/WSASend or a
+ * linked io_uring chain. Consume() drops whatever the kernel accepted, so a
+ * partial send resumes from the exact byte it stopped at. Not thread-safe.
+ */
+class OutboundChain {
+public:
+    void Push(OutboundSegment segment) {
+        if (!segment || segment->empty()) return;
+        queuedBytes += segment->size();
+        segments.push_back(std::move(segment));
+    }
+
+    bool Empty() const { return segments.empty(); }
+    size_t Bytes() const { return queuedBytes; }
+    size_t SegmentCount() const { return segments.size(); }
+
+    // Calls emit(const char* data, size_t length) for up to maxSlices unsent slices,
+    // starting with the unsent tail of the front segment. Returns the number emitted.
+    template<typename Fn>
+    size_t Gather(size_t maxSlices, Fn&& emit) const {
+        size_t count = 0;
+        for (size_t i = 0; i < segments.size() && count < maxSlices; i++, count++) {
+            size_t offset = (i == 0) ? frontOffset : 0;
+            emit(segments[i]->data() + offset, segments[i]->size() - offset);
+        }
+        return count;
+    }
+
+    // Releases 'bytes' from the front of the chain after the kernel accepted them.
+    void Consume(size_t bytes) {
+        queuedBytes -= (bytes < queuedBytes) ? bytes : queuedBytes;
+        while (bytes > 0 && !segments.empty()) {
+            size_t remaining = segments.front()->size() - frontOffset;
+            if (bytes < remaining) {
+                frontOffset += bytes;
+                return;
+            }
+            bytes -= remaining;
+            segments.pop_front();
+            frontOffset = 0;
+        }
+    }
+
+    void Clear() {
+        segments.clear();
+        frontOffset = 0;
+        queuedBytes = 0;
+    }
+
+private:
+    std::deque<OutboundSegment> segments;
+    size_t frontOffset = 0;   // Bytes of segments.front() already sent
+    size_t queuedBytes = 0;   // Unsent bytes across all segments
+};
+
+// Output that a newer copy fully replaces, so a congested client only needs the latest.
+enum class SupersededOutput {
+    MapRender,
+    Vitals,
+    Count
+};
+
+// Per-connection output thresholds, in bytes queued but not yet accepted by the kernel.
+struct BackpressureLimits {
+    size_t lowWater = 16 * 1024;      // Congestion ends once below this
+    size_t highWater = 64 * 1024;     // Congestion starts above this
+    size_t hardCap = 512 * 1024;      // Staying above this gets the client evicted
+    int evictAfterTicks = 150;        // ~5 seconds at 30 ticks/s
+};
+
+struct BackpressureCounters {
+    uint64_t congestionEpisodes = 0;
+    uint64_t congestedTicks = 0;
+    uint64_t coalescedFrames = 0;     // Superseded frames dropped while congested
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "JobSystem.h"
+#include "Registry.h"
+
+/**
+ * @class CommandBuffer
+ * @brief Structural changes recorded by one thread during a parallel loop.
+ *
+ * Adding or removing components would reshuffle the dense arrays other threads
+ * are still walking, so loop bodies record those changes here instead. Each
+ * command is tagged with the index of the item that issued it. They are merged
+ * in item order afterwards, so the result doesn't depend on which thread ran
+ * which chunk.
+ */
+class CommandBuffer {
+public:
+    template<typename T>
+    void RemoveComponent(EntityID entity) {
+        commands.push_back({ order, entity, &RemoveThunk<T>, nullptr });
+    }
+    template<typename T>
+    void AddComponent(EntityID entity, T component) {
+        commands.push_back({ order, entity, nullptr,
+            [entity, component = std::move(component)](Registry& registry) mutable {
+                registry.AddComponent<T>(entity, std::move(component));
+            } });
+    }
+    // Anything else that must run single-threaded, e.g. a Lua hook or a factory call.
+    void Defer(std::function<void(Registry&)> fn) {
+        commands.push_back({ order, -1, nullptr, std::move(fn) });
+    }
+
+private:
+    friend class DeferredCommands;
+    template<typename T, typename Fn> friend struct ParallelLoop;
+
+    struct Command {
+        size_t order;
+        EntityID entity;
+        void (*remove)(Registry&, EntityID);
+        std::function<void(Registry&)> deferred;
+    };
+
+    template<typename T>
+    static void RemoveThunk(Registry& registry, EntityID entity) { registry.RemoveComponent<T>(entity); }
+
+    size_t order = 0;
+    std::vector<Command> commands;
+};
+
+/**
+ * @class DeferredCommands
+ * @brief The per-thread CommandBuffers of one parallel loop.
+ *
+ * Owned by the system that runs the loop and reused every tick, so the buffers
+ * keep their capacity. Two loops that may run at the same time need separate
+ * instances.
+ */
+class DeferredCommands {
+public:
+    CommandBuffer& ForSlot(int slot) { return buffers[slot]; }
+
+    void Prepare(size_t slots) {
+        if (buffers.size() < slots) buffers.resize(slots);
+    }
+
+    // Calling thread, after the loop has joined: applies every command in item order.
+    void Apply(Registry& registry) {
+        merged.clear();
+        for (CommandBuffer& buffer : buffers) {
+            for (CommandBuffer::Command& command : buffer.commands) {
+                merged.push_back(&command);
+            }
+        }
+        std::stable_sort(merged.begin(), merged.end(),
+            [](const CommandBuffer::Command* a, const CommandBuffer::Command* b) { return a->order < b->order; });
+        for (CommandBuffer::Command* command : merged) {
+            if (command->remove) command->remove(registry, command->entity);
+            else command->deferred(registry);
+        }
+        Discard();
+    }
+
+    void Discard() {
+        for (CommandBuffer& buffer : buffers) {
+            buffer.commands.clear();
+        }
+    }
+
+private:
+    std::vector<CommandBuffer> buffers;
+    std::vector<CommandBuffer::Command*> merged;
+};
+
+// Shared state of one ParallelForEach call; each chunk job gets a pointer to it.
+template<typename T, typename Fn>
+struct ParallelLoop {
+    Fn* fn;
+    EntityID* entities;
+    T* components;
+    DeferredCommands* commands;
+
+    static void RunChunk(void* data, size_t begin, size_t end) {
+        ParallelLoop& loop = *static_cast<ParallelLoop*>(data);
+        CommandBuffer& buffer = loop.commands->ForSlot(JobSystem::CurrentSlot());
+        for (size_t i = begin; i < end; i++) {
+            buffer.order = i;
+            (*loop.fn)(loop.entities[i], loop.components[i], buffer);
+        }
+    }
+};
+
+/**
+ * @brief Calls fn(EntityID, T&, CommandBuffer&) for every T, split into chunks across the job system.
+ *
+ * The body may change its own T. It may also read other components, once
+ * their pools exist (Registry::EnsurePool) and as long as nothing else is
+ * writing them, which the system's SystemAccess ensures. Adding or removing
+ * components goes through the CommandBuffer. Those changes are
+ * applied on the calling thread before this returns. Pools smaller than one
+ * chunk run inline. Call from the game thread or from a job.
+ */
+template<typename T, typename Fn>
+void ParallelForEach(JobSystem& jobs, Registry& registry, DeferredCommands& commands, Fn&& fn, size_t grain = 256) {
+    std::vector<EntityID>& entities = registry.view<T>();
+    std::vector<T>& components = registry.GetAllComponents<T>();
+    size_t count = entities.size();
+    if (count == 0) return;
+
+    commands.Prepare(jobs.Slots());
+    using Body = std::remove_reference_t<Fn>;
+    ParallelLoop<T, Body> loop{ &fn, entities.data(), components.data(), &commands };
+
+    // Enough chunks for every thread to steal a few, none smaller than the grain
+    size_t chunks = (std::min)((count + grain - 1) / grain, jobs.Slots() * 4);
+    if (chunks <= 1 || jobs.WorkerThreads() == 0) {
+        ParallelLoop<T, Body>::RunChunk(&loop, 0, count);
+    }
+    else {
+        JobGroup group;
+        size_t chunkSize = (count + chunks - 1) / chunks;
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            Job job;
+            job.run = &ParallelLoop<T, Body>::RunChunk;
+            job.data = &loop;
+            job.begin = begin;
+            job.end = (std::min)(count, begin + chunkSize);
+            job.group = &group;
+            jobs.Submit(job);
+        }
+        try {
+            jobs.Wait(group);
+        }
+        catch (...) {
+            commands.Discard();
+            throw;
+        }
+    }
+    commands.Apply(registry);
+}
@@ -4,8 +4,7 @@
 #include "GameEngine.h"
 #include "GameContext.h"
 #include "SQLiteDatabase.h"
-#include "picosha2.h"
-#include <random>
+#include "AuthService.h"
 
 class PasswordResetState : public GameState
 {
@@ -14,7 +13,8 @@ public:
 		USERNAME,
 		OLD_PASSWORD,
 		NEW_PASSWORD,
-		CONFIRM_PASSWORD
+		CONFIRM_PASSWORD,
+		WAITING         // An AuthService request is running; input is held off
 	};
 
 	PasswordResetState() : step(ResetStep::USERNAME) {}
@@ -24,7 +24,7 @@ public:
 		client->QueueMessage("Enter your username:\r\n");
 	}
 
-	void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+	void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
 		if (p.empty()) return;
 
 		GameEngine* engine = client->GetEngine();
@@ -32,26 +32,13 @@ public:
 		switch (step) {
 		case ResetStep::USERNAME:
 			tempUsername = p[0];
-			
-			if (!engine->gameContext.db->PlayerExists(tempUsername)) {
-				client->QueueMessage("User not found. Returning to main menu...\r\n");
-				client->PopState();
-				return;
-			}
-
-			step = ResetStep::OLD_PASSWORD;
-			client->QueueMessage("Enter your current password:\r\n");
+			step = ResetStep::WAITING;
+			ticket = engine->gameContext.auth->Submit(AuthRequestKind::NameExists, client->clientID, tempUsername);
 			break;
 
 		case ResetStep::OLD_PASSWORD:
-			if (!engine->gameContext.db->VerifyPassword(tempUsername, p[0])) {
-				client->QueueMessage("Incorrect password. Returning to main menu...\r\n");
-				client->PopState();
-				return;
-			}
-
-			step = ResetStep::NEW_PASSWORD;
-			client->QueueMessage("Enter your new password:\r\n");
+			step = ResetStep::WAITING;
+			ticket = engine->gameContext.auth->Submit(AuthRequestKind::VerifyPassword, client->clientID, tempUsername, p[0]);
 			break;
 
 		case ResetStep::NEW_PASSWORD:
@@ -72,12 +59,44 @@ public:
 				return;
 			}
 
-			// Generate new salt and hash
-			std::string salt = GenerateSalt();
-			std::string combined = newPassword + salt;
-			std::string hash = picosha2::hash256_hex_string(combined);
+			// New salt and hash are generated on the auth worker
+			step = ResetStep::WAITING;
+			ticket = engine->gameContext.auth->Submit(AuthRequestKind::ChangePassword, client->clientID, tempUsername, newPassword);
+			newPassword.clear();
+			break;
+
+		case ResetStep::WAITING:
+			client->QueueMessage("Please wait...\r\n");
+			break;
+		}
+	}
+
+	void OnAuthResult(ClientConnection* client, const AuthResult& result) override {
+		if (step != ResetStep::WAITING || result.ticket != ticket) return;
+
+		switch (result.kind) {
+		case AuthRequestKind::NameExists:
+			if (result.status != AuthStatus::Ok) {
+				client->QueueMessage("User not found. Returning to main menu...\r\n");
+				client->PopState();
+				return;
+			}
+			step = ResetStep::OLD_PASSWORD;
+			client->QueueMessage("Enter your current password:\r\n");
+			break;
+
+		case AuthRequestKind::VerifyPassword:
+			if (result.status != AuthStatus::Ok) {
+				client->QueueMessage("Incorrect password. Returning to main menu...\r\n");
+				client->PopState();
+				return;
+			}
+			step = ResetStep::NEW_PASSWORD;
+			client->QueueMessage("Enter your new password:\r\n");
+			break;
 
-			if (engine->gameContext.db->UpdatePassword(tempUsername, hash, salt)) {
+		default:
+			if (result.status == AuthStatus::Ok) {
 				client->QueueMessage("Password updated successfully! Returning to main menu...\r\n");
 			} else {
 				client->QueueMessage("Failed to update password. Please try again later.\r\n");
@@ -91,16 +110,5 @@ private:
 	ResetStep step;
 	std::string tempUsername;
 	std::string newPassword;
-
-	std::string GenerateSalt(int length = 16) {
-		const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!@#$%^&*";
-		std::default_random_engine rng(std::random_device{}());
-		std::uniform_int_distribution<> dist(0, sizeof(charset) - 2);
-
-		std::string salt;
-		for (int i = 0; i < length; ++i) {
-			salt += charset[dist(rng)];
-		}
-		return salt;
-	}
+	uint64_t ticket = 0;
 };
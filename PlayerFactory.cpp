@@ -30,15 +30,25 @@ EntityID PlayerFactory::LoadPlayer(std::string username, ClientConnection* conne
         return -1;
     }
 
+    return SpawnPlayer(data, connection);
+}
+
+EntityID PlayerFactory::SpawnPlayer(const PlayerData& data, ClientConnection* connection) {
+    const std::string& username = data.name;
+
     // 3. Create ECS Entity
     EntityID player = ctx.registry->CreateEntity();
 
     // 4. Attach Components (Hydration)
-    ctx.registry->AddComponent(player, ClientComponent{ connection });
+    // WebSocket connections are web clients from the start; the hello packet
+    // only adds the optional features.
+    ClientComponent clientComponent{ connection };
+    clientComponent.isWebClient = connection && connection->IsWebSocket();
+    ctx.registry->AddComponent(player, clientComponent);
     ctx.registry->AddComponent(player, PlayerComponent{ data.id, username });
 
     // Stats from DB
-    auto& s = data.stats;
+    const auto& s = data.stats;
     StatComponent stats;
     stats.Health = s.value("hp", 100);
     stats.MaxHealth = s.value("max_hp", 100);
@@ -77,7 +87,7 @@ EntityID PlayerFactory::LoadPlayer(std::string username, ClientConnection* conne
     // 5. Hydrate Inventory
     auto* inv = ctx.registry->GetComponent<InventoryComponent>(player);
     auto* equip = ctx.registry->GetComponent<EquipmentComponent>(player);
-    for (auto& itemData : data.items) {
+    for (const auto& itemData : data.items) {
         EntityID item = ctx.factories->items.CreateItem(itemData.templateId);
         // Apply saved state (equipped, durability, etc)
         if (itemData.state.value("equipped", false)) {
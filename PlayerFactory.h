@@ -2,6 +2,7 @@
 #include <string>
 
 struct GameContext; 
+struct PlayerData;
 class ClientConnection;
 using EntityID = int;
 
@@ -10,6 +11,8 @@ public: // Move public to the top or specifically for the constructor
     PlayerFactory(GameContext& g) : ctx(g) {}
 
     EntityID LoadPlayer(std::string accountName, ClientConnection* connection);
+    // Builds the player entity from a row already read (e.g. by AuthService).
+    EntityID SpawnPlayer(const PlayerData& data, ClientConnection* connection);
 
 private:
     GameContext& ctx;
@@ -28,7 +28,7 @@ public:
     void OnEnter(ClientConnection* client) override {
     }
 
-    void HandleInput(ClientConnection* client, std::vector<std::string> p) override {
+    void HandleInput(ClientConnection* client, const std::vector<std::string>& p) override {
 
         currentCmd->ParseInput(p);
 
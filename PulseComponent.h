@@ -1,4 +0,0 @@
-#pragma once
-struct PulseComponent {
-	float timeSince = 0;
-};
\ No newline at end of file
@@ -93,6 +93,16 @@ public:
         return GetPool<T>()->GetComponents();
     }
     
+    /**
+     * @brief Creates the pool for T now if it doesn't exist yet.
+     * After this, lookups for T never modify the pool map, so systems that run
+     * concurrently may look T up (see SystemScheduler).
+     */
+    template<typename T>
+    void EnsurePool() {
+        GetPool<T>();
+    }
+
     // --- Views and Iteration ---
 
     /**
@@ -2,19 +2,18 @@
 #include "GameContext.h"
 #include "Registry.h"
 #include "RespawnComponent.h"
-#include "MobComponent.h"
 #include "PositionComponent.h"
-#include "HealthComponent.h"
 #include "MobFactory.h"
 #include "FactoryManager.h"
 #include "Tags.h"
+#include "RoomActivity.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <vector>
 
 using json = nlohmann::json;
 
-void RespawnSystem::Update(float deltaTime) {
+void RespawnSystem::Update() {
     // First: Process all entities marked as dead and notify their spawn points
     std::vector<int> deadEntities;
     for (EntityID entity : ctx.registry->view<DeadTag>()) {
@@ -30,7 +29,9 @@ void RespawnSystem::Update(float deltaTime) {
             if (spawnPoint->currentMobEntityId == deadEntity && spawnPoint->hasLivingMob) {
                 // Mark spawn point as ready to respawn
                 spawnPoint->hasLivingMob = false;
-                spawnPoint->timeRemaining = spawnPoint->respawnTimer;
+                ctx.timers->Cancel(spawnPoint->respawnTimerHandle);
+                spawnPoint->respawnTimerHandle = ctx.timers->Schedule(
+                    TimerWheel::SecondsToMs(spawnPoint->respawnTimer), &RespawnSystem::OnRespawnDue, this, spawnEntity);
                 std::cout << "Mob " << deadEntity << " died, spawn point " << spawnEntity 
                           << " will respawn in " << spawnPoint->respawnTimer << " seconds" << std::endl;
                 break;
@@ -41,65 +42,53 @@ void RespawnSystem::Update(float deltaTime) {
         ctx.registry->RemoveComponent<DeadTag>(deadEntity);
         ctx.registry->AddComponent<DestroyTag>(deadEntity, DestroyTag{});
     }
-    
-    // Second: Find all spawn points that need to respawn (no living mob and timer running)
-    std::vector<int> spawnPointsToRespawn;
-    
-    for (EntityID entity : ctx.registry->view<RespawnComponent>()) {
-        auto* spawnPoint = ctx.registry->GetComponent<RespawnComponent>(entity);
-        if (!spawnPoint) continue;
-        
-        // Only process spawn points that don't have a living mob
-        if (spawnPoint->hasLivingMob) {
-            // Check if the mob is still alive
-            auto* health = ctx.registry->GetComponent<HealthComponent>(spawnPoint->currentMobEntityId);
-            auto* mob = ctx.registry->GetComponent<MobComponent>(spawnPoint->currentMobEntityId);
-            
-            // If mob is dead or no longer exists, mark spawn point as ready to respawn
-            if (!health || !mob || health->health <= 0) {
-                spawnPoint->hasLivingMob = false;
-                spawnPoint->timeRemaining = spawnPoint->respawnTimer;
-                std::cout << "Mob died at spawn point " << entity << ", respawn in " 
-                          << spawnPoint->respawnTimer << " seconds" << std::endl;
-            }
-            continue;
-        }
-        
-        // Count down the respawn timer
-        if (spawnPoint->timeRemaining > 0.0f) {
-            spawnPoint->timeRemaining -= deltaTime;
-            
-            // Time to respawn!
-            if (spawnPoint->timeRemaining <= 0.0f) {
-                spawnPointsToRespawn.push_back(entity);
-            }
-        }
+}
+
+void RespawnSystem::OnRespawnDue(void* context, int spawnPointId, TimerHandle handle) {
+    RespawnSystem& self = *static_cast<RespawnSystem*>(context);
+    auto* spawnPoint = self.ctx.registry->GetComponent<RespawnComponent>(spawnPointId);
+    if (!spawnPoint || spawnPoint->respawnTimerHandle != handle) return;
+
+    spawnPoint->respawnTimerHandle = TimerHandle();
+    if (!self.ctx.activity->IsRoomAwake(spawnPoint->spawnRoomId)) {
+        // Nobody is there to see it; spawn when a player comes back
+        self.ctx.activity->DeferUntilAwake(spawnPoint->spawnRoomId, &RespawnSystem::OnRoomWoke, &self, spawnPointId);
+        return;
     }
+
+    // Time to respawn!
+    self.Respawn(spawnPointId);
+}
+
+void RespawnSystem::OnRoomWoke(void* context, int spawnPointId, double) {
+    RespawnSystem& self = *static_cast<RespawnSystem*>(context);
+    auto* spawnPoint = self.ctx.registry->GetComponent<RespawnComponent>(spawnPointId);
+    // The respawn fell due while the room slept, so it is simply complete now
+    if (!spawnPoint || spawnPoint->hasLivingMob || spawnPoint->respawnTimerHandle.IsValid()) return;
+    self.Respawn(spawnPointId);
+}
+
+void RespawnSystem::Respawn(int spawnPointId) {
+    auto* spawnPoint = ctx.registry->GetComponent<RespawnComponent>(spawnPointId);
+    if (!spawnPoint) return;
+
+    // Spawn the new mob
+    int newMobId = ctx.factories->mobs.CreateMob(
+        spawnPoint->templateId,
+        nlohmann::json::object(),
+        spawnPoint->spawnX,
+        spawnPoint->spawnY,
+        spawnPoint->spawnRoomId
+    );
     
-    // Process respawns
-    for (int spawnPointId : spawnPointsToRespawn) {
-        auto* spawnPoint = ctx.registry->GetComponent<RespawnComponent>(spawnPointId);
-        if (!spawnPoint) continue;
-        
-        // Spawn the new mob
-        int newMobId = ctx.factories->mobs.CreateMob(
-            spawnPoint->templateId,
-            nlohmann::json::object(),
-            spawnPoint->spawnX,
-            spawnPoint->spawnY,
-            spawnPoint->spawnRoomId
-        );
+    if (newMobId != -1) {
+        // Update spawn point to track the new mob
+        spawnPoint->currentMobEntityId = newMobId;
+        spawnPoint->hasLivingMob = true;
         
-        if (newMobId != -1) {
-            // Update spawn point to track the new mob
-            spawnPoint->currentMobEntityId = newMobId;
-            spawnPoint->hasLivingMob = true;
-            spawnPoint->timeRemaining = 0.0f;
-            
-            std::cout << "Mob respawned: " << spawnPoint->templateId << " at (" 
-                      << spawnPoint->spawnX << ", " << spawnPoint->spawnY << ") in room " 
-                      << spawnPoint->spawnRoomId << " (spawn point " << spawnPointId << ")" << std::endl;
-        }
+        std::cout << "Mob respawned: " << spawnPoint->templateId << " at (" 
+                  << spawnPoint->spawnX << ", " << spawnPoint->spawnY << ") in room " 
+                  << spawnPoint->spawnRoomId << " (spawn point " << spawnPointId << ")" << std::endl;
     }
 }
 
@@ -111,7 +100,6 @@ int RespawnSystem::CreateSpawnPoint(const std::string& templateId, float respawn
     RespawnComponent spawnComp;
     spawnComp.templateId = templateId;
     spawnComp.respawnTimer = respawnTime;
-    spawnComp.timeRemaining = 0.0f;
     spawnComp.spawnX = x;
     spawnComp.spawnY = y;
     spawnComp.spawnRoomId = roomId;
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "TimerWheel.h"
 
 struct GameContext;
 
@@ -9,11 +10,15 @@ public:
     RespawnSystem(GameContext& g) : ctx(g) {}
     ~RespawnSystem() = default;
     
-    // Call every frame with deltaTime
-    // Processes DeadTag entities and respawns mobs
-    void Update(float deltaTime);
+    // Processes DeadTag entities and starts their spawn points' respawn timers
+    void Update();
     
     // Create a spawn point that will automatically spawn and respawn mobs
     // Returns the spawn point entity ID
     int CreateSpawnPoint(const std::string& templateId, float respawnTime, int x, int y, int roomId);
+
+private:
+    void Respawn(int spawnPointId);
+    static void OnRespawnDue(void* context, int spawnPointId, TimerHandle handle);
+    static void OnRoomWoke(void* context, int spawnPointId, double dormantSeconds);
 };
@@ -0,0 +1,99 @@
+#include "RoomActivity.h"
+#include "GameContext.h"
+#include "Registry.h"
+#include "TimeData.h"
+#include "PlayerComponent.h"
+#include "PositionComponent.h"
+#include <cstdio>
+
+RoomActivity::RoomActivity(GameContext& gc, double sleepDelay) : ctx(gc), sleepDelay(sleepDelay) {}
+
+void RoomActivity::Update() {
+    double now = ctx.time->globalTime;
+    Registry& registry = *ctx.registry;
+
+    for (int roomId : awakeRooms) {
+        rooms[roomId].players = 0;
+    }
+
+    // Wake after counting: parked callbacks can create entities
+    std::vector<int> waking;
+    for (EntityID player : registry.view<PlayerComponent>()) {
+        auto* position = registry.GetComponent<PositionComponent>(player);
+        if (position && position->roomId >= 0) {
+            RoomState& room = rooms[position->roomId];
+            room.players++;
+            room.lastOccupied = now;
+            if (!room.awake && room.players == 1) waking.push_back(position->roomId);
+        }
+    }
+
+    // Rooms nobody has been in for a while go to sleep
+    for (size_t i = 0; i < awakeRooms.size();) {
+        RoomState& room = rooms[awakeRooms[i]];
+        if (room.players == 0 && now - room.lastOccupied >= sleepDelay) {
+            room.awake = false;
+            sleeps++;
+            awakeRooms[i] = awakeRooms.back();
+            awakeRooms.pop_back();
+        }
+        else {
+            i++;
+        }
+    }
+
+    for (int roomId : waking) {
+        Wake(roomId, rooms[roomId]);
+    }
+
+    LogStatsIfDue();
+}
+
+void RoomActivity::Wake(int roomId, RoomState& room) {
+    room.awake = true;
+    awakeRooms.push_back(roomId);
+    wakes++;
+    if (room.parked.empty()) return;
+
+    double now = ctx.time->globalTime;
+    std::vector<Parked> parked;
+    parked.swap(room.parked);
+    parkedCount -= parked.size();
+    for (const Parked& work : parked) {
+        resumed++;
+        work.callback(work.context, work.entity, now - work.since);
+    }
+}
+
+bool RoomActivity::IsRoomAwake(int roomId) const {
+    if (roomId < 0) return true;
+    auto it = rooms.find(roomId);
+    return it != rooms.end() && it->second.awake;
+}
+
+void RoomActivity::DeferUntilAwake(int roomId, WakeCallback callback, void* context, int entity) {
+    rooms[roomId].parked.push_back(Parked{ callback, context, entity, ctx.time->globalTime });
+    parkedCount++;
+}
+
+RoomActivity::Stats RoomActivity::GetStats() const {
+    Stats stats;
+    stats.awakeRooms = awakeRooms.size();
+    stats.dormantRooms = rooms.size() - awakeRooms.size();
+    stats.parked = parkedCount;
+    stats.wakes = wakes;
+    stats.sleeps = sleeps;
+    stats.resumed = resumed;
+    return stats;
+}
+
+void RoomActivity::LogStatsIfDue() {
+    double now = ctx.time->globalTime;
+    if (now - lastLog < 60.0) return;
+    lastLog = now;
+
+    Stats stats = GetStats();
+    printf("[Activity] %zu rooms awake, %zu dormant, %zu callbacks parked, %llu wakes, %llu sleeps, %llu resumed\n",
+        stats.awakeRooms, stats.dormantRooms, stats.parked,
+        (unsigned long long)stats.wakes, (unsigned long long)stats.sleeps, (unsigned long long)stats.resumed);
+}
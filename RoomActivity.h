@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct GameContext;
+
+/**
+ * @class RoomActivity
+ * @brief Tracks which rooms have players nearby, so work in empty ones can wait.
+ *
+ * A room is awake while a player is in it and for 'sleepDelay' seconds after
+ * the last one leaves; every other room is dormant. Update recounts players
+ * each tick, which costs as much as the players and awake rooms, not the world.
+ *
+ * Rooms start dormant until a player first walks in. Timer callbacks for work
+ * in a dormant room park themselves here instead of running. When a player
+ * walks in, the room wakes and each parked callback runs once with how long it
+ * was held, so it can catch up analytically: a pending respawn simply happens.
+ * Game thread only.
+ */
+class RoomActivity {
+public:
+    // 'dormantSeconds' is how long the work was held while the room slept.
+    using WakeCallback = void (*)(void* context, int entity, double dormantSeconds);
+
+    struct Stats {
+        size_t awakeRooms = 0;
+        size_t dormantRooms = 0;   // Rooms that have been awake at least once
+        size_t parked = 0;
+        uint64_t wakes = 0;
+        uint64_t sleeps = 0;
+        uint64_t resumed = 0;      // Parked callbacks run on wake
+    };
+
+    explicit RoomActivity(GameContext& ctx, double sleepDelay = 30.0);
+
+    // Recounts players per room, and wakes or puts rooms to sleep.
+    void Update();
+
+    // Room -1 (outside any room) is always awake.
+    bool IsRoomAwake(int roomId) const;
+
+    // Holds work for a dormant room until it wakes. Use only when !IsRoomAwake(roomId).
+    void DeferUntilAwake(int roomId, WakeCallback callback, void* context, int entity);
+
+    Stats GetStats() const;
+
+private:
+    struct Parked {
+        WakeCallback callback;
+        void* context;
+        int entity;
+        double since;
+    };
+
+    struct RoomState {
+        int players = 0;
+        bool awake = false;
+        double lastOccupied = 0.0;
+        std::vector<Parked> parked;
+    };
+
+    void Wake(int roomId, RoomState& room);
+    void LogStatsIfDue();
+
+    GameContext& ctx;
+    double sleepDelay;
+    std::unordered_map<int, RoomState> rooms;
+    std::vector<int> awakeRooms;
+    size_t parkedCount = 0;
+    uint64_t wakes = 0;
+    uint64_t sleeps = 0;
+    uint64_t resumed = 0;
+    double lastLog = 0.0;
+};
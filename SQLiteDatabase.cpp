@@ -11,6 +11,7 @@
 #include "ItemComponent.h"
 #include "BodyComponent.h"
 #include "RegionComponent.h"
+#include "TickProfiler.h"
 
 SQLiteDatabase::~SQLiteDatabase() {
     Disconnect();
@@ -23,6 +24,10 @@ bool SQLiteDatabase::Connect(const std::string& filepath) {
         return false;
     }
     printf("[Database] Connected to %s\n", filepath.c_str());
+    // The game thread and the auth workers each hold a connection. WAL lets
+    // their reads run while a save is writing; the timeout covers writer overlap.
+    sqlite3_busy_timeout(db, 5000);
+    sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
     InitializeSchema();
     return true;
 }
@@ -74,15 +79,36 @@ void SQLiteDatabase::LogError(const char* message)
 {
 }
 
+void SQLiteDatabase::SetProfiler(TickProfiler* profiler) {
+    static const char* const names[CallCount] = {
+        "db:EndTransaction",
+        "db:SavePlayer",
+        "db:SaveStats",
+        "db:SaveBodyMods",
+        "db:CreatePlayerRow",
+        "db:SaveInventory",
+        "db:LoadPlayer",
+        "db:GetSavedItems",
+        "db:PlayerExists",
+        "db:UpdatePassword",
+        "db:VerifyPassword"
+    };
+    this->profiler = profiler;
+    if (!profiler) return;
+    for (int i = 0; i < CallCount; i++) profileIds[i] = profiler->Intern(names[i]);
+}
+
 void SQLiteDatabase::BeginTransaction() {
     sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
 }
 
 void SQLiteDatabase::EndTransaction() {
+    ProfileScope scope(profiler, profileIds[CallEndTransaction]);
     sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL);
 }
 
 bool SQLiteDatabase::SavePlayer(EntityID playerEnt, GameContext& ctx) {
+    ProfileScope scope(profiler, profileIds[CallSavePlayer]);
     auto* stats = ctx.registry->GetComponent<StatComponent>(playerEnt);
     auto* pos = ctx.registry->GetComponent<PositionComponent>(playerEnt);
     auto* playerComp = ctx.registry->GetComponent<PlayerComponent>(playerEnt);
@@ -131,6 +157,7 @@ bool SQLiteDatabase::SavePlayer(EntityID playerEnt, GameContext& ctx) {
     return true;
 }
 bool SQLiteDatabase::SaveStats(EntityID playerEnt, GameContext& ctx) {
+    ProfileScope scope(profiler, profileIds[CallSaveStats]);
     auto* stats = ctx.registry->GetComponent<StatComponent>(playerEnt);
     auto* playerComp = ctx.registry->GetComponent<PlayerComponent>(playerEnt);
     auto* pos = ctx.registry->GetComponent<PositionComponent>(playerEnt);
@@ -165,6 +192,7 @@ bool SQLiteDatabase::SaveStats(EntityID playerEnt, GameContext& ctx) {
 }
 
 bool SQLiteDatabase::SaveBodyMods(EntityID playerEnt, GameContext& ctx) {
+    ProfileScope scope(profiler, profileIds[CallSaveBodyMods]);
     // Assuming you created a BodyModComponent or similar
     auto* body = ctx.registry->GetComponent<BodyComponent>(playerEnt);
     auto* playerComp = ctx.registry->GetComponent<PlayerComponent>(playerEnt);
@@ -191,7 +219,8 @@ bool SQLiteDatabase::SaveBodyMods(EntityID playerEnt, GameContext& ctx) {
     return true;
 }
 int SQLiteDatabase::CreatePlayerRow(const std::string& name, const std::string& password, const std::string& salt) {
-    const char* sql = "INSERT INTO players (region_id,name, password_hash, salt, room_id, stats) VALUES (?, ?, ?);";
+    ProfileScope scope(profiler, profileIds[CallCreatePlayerRow]);
+    const char* sql = "INSERT INTO players (region_id,name, password_hash, salt, room_id, stats) VALUES (?, ?, ?, ?, ?, ?);";
     sqlite3_stmt* stmt;
     int newId = -1;
 
@@ -216,6 +245,7 @@ int SQLiteDatabase::CreatePlayerRow(const std::string& name, const std::string&
 }
 
 void SQLiteDatabase::SaveInventory(EntityID playerEnt, GameContext& ctx) {
+    ProfileScope scope(profiler, profileIds[CallSaveInventory]);
     auto playerComp = ctx.registry->GetComponent<PlayerComponent>(playerEnt);
     if (!playerComp) return;
 
@@ -268,6 +298,7 @@ void SQLiteDatabase::SaveInventory(EntityID playerEnt, GameContext& ctx) {
 }
 
 bool SQLiteDatabase::LoadPlayer(const std::string& name, PlayerData& outData) {
+    ProfileScope scope(profiler, profileIds[CallLoadPlayer]);
     const char* sql = "SELECT id, region_id,room_id, stats FROM players WHERE name = ?;";
     sqlite3_stmt* stmt;
 
@@ -296,6 +327,7 @@ bool SQLiteDatabase::LoadPlayer(const std::string& name, PlayerData& outData) {
 }
 
 std::vector<SavedItemData> SQLiteDatabase::GetSavedItems(int dbId) {
+    ProfileScope scope(profiler, profileIds[CallGetSavedItems]);
     std::vector<SavedItemData> items;
     const char* sql = "SELECT template_id, item_state FROM player_items WHERE owner_id = ?;";
     sqlite3_stmt* stmt;
@@ -315,21 +347,20 @@ std::vector<SavedItemData> SQLiteDatabase::GetSavedItems(int dbId) {
 
 bool SQLiteDatabase::PlayerExists(const std::string& name)
 {
+    ProfileScope scope(profiler, profileIds[CallPlayerExists]);
     const char* sql = "SELECT * FROM players WHERE name = ?;";
     sqlite3_stmt* stmt;
 
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, 0) != SQLITE_OK) return false;
     sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
 
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        return true;
-    }
-
-    else return false;
-
+    bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return exists;
 }
 
 bool SQLiteDatabase::UpdatePassword(const std::string& name, const std::string& passwordHash, const std::string& salt) {
+    ProfileScope scope(profiler, profileIds[CallUpdatePassword]);
     const char* sql = "UPDATE players SET password_hash = ?, salt = ? WHERE name = ?;";
     sqlite3_stmt* stmt;
 
@@ -345,6 +376,7 @@ bool SQLiteDatabase::UpdatePassword(const std::string& name, const std::string&
 }
 
 bool SQLiteDatabase::VerifyPassword(const std::string& name, const std::string& password) {
+    ProfileScope scope(profiler, profileIds[CallVerifyPassword]);
     const char* sql = "SELECT password_hash, salt FROM players WHERE name = ?;";
     sqlite3_stmt* stmt;
 
@@ -1,15 +1,35 @@
 #pragma once
 #include "IDatabase.h"
 #include <sqlite3.h>
+#include <cstdint>
 
 using EntityID = int;
 struct GameContext;
 class PlayerData;
 class SaveItemData;
+class TickProfiler;
 
 class SQLiteDatabase : public IDatabase {
 private:
     sqlite3* db = nullptr;
+    TickProfiler* profiler = nullptr;
+
+    // Profiler ids of the timed calls, interned once by SetProfiler
+    enum ProfiledCall {
+        CallEndTransaction,
+        CallSavePlayer,
+        CallSaveStats,
+        CallSaveBodyMods,
+        CallCreatePlayerRow,
+        CallSaveInventory,
+        CallLoadPlayer,
+        CallGetSavedItems,
+        CallPlayerExists,
+        CallUpdatePassword,
+        CallVerifyPassword,
+        CallCount
+    };
+    uint16_t profileIds[CallCount] = {};
 
 public:
     ~SQLiteDatabase();
@@ -18,6 +38,9 @@ public:
     bool Connect(const std::string& filepath) override;
     void Disconnect() override;
 
+    // Times every call on this connection (the game thread's; auth workers leave it unset)
+    void SetProfiler(TickProfiler* profiler);
+
     // Interface Implementation
     void SaveInventory(EntityID playerEnt, GameContext& ctx);
     bool LoadPlayer(const std::string& name, PlayerData& outData) override;
@@ -1,9 +1,11 @@
 #pragma once
 #include <string>
+#include "TimerWheel.h"
 struct ScheduledEventComponent {
-    float timeLeft;
+    float timeLeft;         // Delay it was scheduled with; the wheel counts down
 
     //EventType type;         // Enum: CombatAttack, CraftFinish, Teleport
     std::string actionID;   // "heavy_slam" or "potion_brew"
     int targetID;           // The victim or the crafting table
-};
\ No newline at end of file
+    TimerHandle timer;
+};
@@ -2,6 +2,7 @@
 #include "Registry.h"
 #include "Component.h"
 #include "ClientConnection.h"
+#include "SessionTable.h"
 #include "InteractableContext.h"
 #include "SkillContext.h"      
 #include <iostream>
@@ -11,7 +12,7 @@
 namespace fs = std::filesystem;
 
 
-ScriptManager::ScriptManager(Registry& r) : registry(r) {
+ScriptManager::ScriptManager(Registry& r, SessionTable& s) : registry(r), sessions(s) {
 	// Initialize lua state in constructor
 	lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::table);
 
@@ -70,12 +71,14 @@ void ScriptManager::init() {
 template<typename... Args>
 void ScriptManager::BroadcastEvent(const std::string& eventName, Args&&... args) {
 	if (lua["Events"][eventName].valid()) {
+		ProfileScope scope(profiler, eventNames, eventName);
 		lua["Events"][eventName](std::forward<Args>(args)...);
 	}
 }
 
 void ScriptManager::dispatch_event(const std::string& event_name, sol::table data) {
 	if (event_listeners.count(event_name)) {
+		ProfileScope scope(profiler, eventNames, event_name);
 		for (auto& func : event_listeners[event_name]) {
 			auto result = func(data);
 			if (!result.valid()) {
@@ -87,6 +90,7 @@ void ScriptManager::dispatch_event(const std::string& event_name, sol::table dat
 }
 
 SkillResult ScriptManager::ExecuteSkillScript(const std::string& scriptPath, const SkillContext& ctx) {
+	ProfileScope scope(profiler, hookNames, scriptPath);
 	// 1. Load Script
 	sol::load_result script = lua.load_file(scriptPath);
 	if (!script.valid()) {
@@ -166,6 +170,8 @@ void ScriptManager::load_all_scripts(const std::string& root_path) {
 }
 
 InteractableResult ScriptManager::ExecuteInteractableScript(const std::string& scriptPath, const std::string& functionName, const InteractableContext& context) {
+	// Timed under the script path, which already names the interactable
+	ProfileScope scope(profiler, hookNames, scriptPath);
 	// 1. Load Script
 	sol::load_result script = lua.load_file(scriptPath);
 	if (!script.valid()) {
@@ -233,6 +239,25 @@ InteractableResult ScriptManager::ExecuteInteractableScript(const std::string& s
 }
 
 ClientConnection* ScriptManager::GetPlayer(int player_id) {
-	auto* comp = registry.GetComponent<ClientComponent>(player_id);
-	return comp ? comp->client : nullptr;
-}
\ No newline at end of file
+	// Resolved through the session, so a player who just disconnected yields nullptr.
+	return sessions.FindByEntity(player_id);
+}
+
+uint16_t ScriptManager::FunctionProfileId(const sol::protected_function& func) {
+	lua_State* L = lua.lua_state();
+	func.push();
+	const void* key = lua_topointer(L, -1);
+	auto it = functionProfileIds.find(key);
+	if (it != functionProfileIds.end()) {
+		lua_pop(L, 1);
+		return it->second;
+	}
+
+	// Pops the function; a collected function's address can be reused, which
+	// at worst files a later hook under the older one's name.
+	lua_Debug ar;
+	lua_getinfo(L, ">S", &ar);
+	uint16_t id = profiler->Intern(std::string("lua:") + ar.short_src + ":" + std::to_string(ar.linedefined));
+	functionProfileIds.emplace(key, id);
+	return id;
+}
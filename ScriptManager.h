@@ -2,11 +2,14 @@
 #include <sol/sol.hpp>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <iostream> 
+#include "TickProfiler.h"
 
 
 class Registry;
+class SessionTable;
 class ClientConnection;
 struct StatComponent;
 struct SkillResult;        
@@ -21,9 +24,15 @@ class ScriptManager {
 public:
 	sol::state lua;
 	Registry& registry;
+	SessionTable& sessions;
 	std::map<std::string, std::vector<sol::function>> event_listeners;
+	TickProfiler* profiler = nullptr;   // Times every hook, event and script run when set
+	ProfileNames hookNames{ "lua:" };
+	ProfileNames eventNames{ "lua event:" };
+	// Function-object hooks, keyed by the Lua function and named after where it was defined
+	std::unordered_map<const void*, uint16_t> functionProfileIds;
 
-	ScriptManager(Registry& r);
+	ScriptManager(Registry& r, SessionTable& s);
 	~ScriptManager() = default;
 
 	void init();
@@ -40,6 +49,7 @@ public:
 			return;
 		}
 
+		ProfileScope scope(profiler, hookNames, func_name);
 		auto result = func(std::forward<Args>(args)...);
 
 		if (!result.valid()) {
@@ -54,6 +64,7 @@ public:
 			return;
 		}
 
+		ProfileScope scope(profiler, profiler && profiler->Enabled() ? FunctionProfileId(func) : (uint16_t)0);
 		auto result = func(std::forward<Args>(args)...);
 
 		if (!result.valid()) {
@@ -65,6 +76,8 @@ public:
 	SkillResult ExecuteSkillScript(const std::string& scriptPath, const SkillContext& ctx);
 	InteractableResult ExecuteInteractableScript(const std::string& scriptPath, const std::string& functionName, const InteractableContext& context);
 	ClientConnection* GetPlayer(int player_id);
+	// "lua:<source>:<line>" for a function-object hook, interned on first call
+	uint16_t FunctionProfileId(const sol::protected_function& func);
 	template<typename ...Args>
 	void BroadcastEvent(const std::string& eventName, Args && ...args);
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "SelectReactor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+SelectReactor::SelectReactor() {
+    // A UDP socket connected to itself: send() on it makes it readable.
+    wakeSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (wakeSocket == INVALID_SOCKET) return;
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+
+    if (bind(wakeSocket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR
+        || getsockname(wakeSocket, (sockaddr*)&addr, &len) == SOCKET_ERROR
+        || connect(wakeSocket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR
+        || !SocketPlatform::SetNonBlocking(wakeSocket)) {
+        printf("select wake socket failed with error: %d, polling instead\n", SocketPlatform::LastError());
+        closesocket(wakeSocket);
+        wakeSocket = INVALID_SOCKET;
+    }
+}
+
+SelectReactor::~SelectReactor() {
+    if (wakeSocket != INVALID_SOCKET) {
+        closesocket(wakeSocket);
+    }
+}
+
+void SelectReactor::Wake() {
+    // One datagram per wakeup is enough; later calls before Wait() are no-ops.
+    if (!woken.exchange(true) && wakeSocket != INVALID_SOCKET) {
+        char byte = 1;
+        send(wakeSocket, &byte, 1, SocketPlatform::SEND_FLAGS);
+    }
+}
+
+void SelectReactor::DrainWakeSocket() {
+    char buf[64];
+    while (recv(wakeSocket, buf, sizeof(buf), 0) > 0) {}
+}
+
+bool SelectReactor::Add(SOCKET socket, void* userData) {
+    if (registrations.size() >= FD_SETSIZE) {
+        printf("select backend is full (FD_SETSIZE = %d)\n", FD_SETSIZE);
+        return false;
+    }
+    registrations.push_back({ socket, userData });
+    return true;
+}
+
+void SelectReactor::Remove(SOCKET socket) {
+    registrations.erase(
+        std::remove_if(registrations.begin(), registrations.end(),
+            [socket](const Registration& r) { return r.socket == socket; }),
+        registrations.end());
+}
+
+int SelectReactor::Wait(std::vector<ReactorEvent>& out, int timeoutMs) {
+    out.clear();
+
+    fd_set read_fd;
+    FD_ZERO(&read_fd);
+    SOCKET max_fd = 0;
+
+    for (const Registration& reg : registrations) {
+        FD_SET(reg.socket, &read_fd);
+        if (reg.socket > max_fd) {
+            max_fd = reg.socket;
+        }
+    }
+
+    int waitMs = timeoutMs;
+    bool wasWoken = woken.exchange(false);
+    if (wakeSocket != INVALID_SOCKET) {
+        // Cleared before blocking, so any Wake() from here on sends a fresh datagram.
+        FD_SET(wakeSocket, &read_fd);
+        if (wakeSocket > max_fd) {
+            max_fd = wakeSocket;
+        }
+    }
+    else {
+        // No way to interrupt select() from Wake(), so never sleep longer than the poll interval.
+        waitMs = (timeoutMs < 0 || timeoutMs > POLL_INTERVAL_MS) ? POLL_INTERVAL_MS : timeoutMs;
+        if (wasWoken) {
+            waitMs = 0;
+        }
+
+        // Winsock rejects select() with empty sets; an I/O shard may have no sockets yet.
+        if (registrations.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+            return 0;
+        }
+    }
+
+    struct timeval timeout;
+    timeout.tv_sec = waitMs / 1000;
+    timeout.tv_usec = (waitMs % 1000) * 1000;
+
+    int ready = select(static_cast<int>(max_fd + 1), &read_fd, NULL, NULL, waitMs < 0 ? NULL : &timeout);
+    if (ready == SOCKET_ERROR) {
+        return SocketPlatform::Interrupted(SocketPlatform::LastError()) ? 0 : -1;
+    }
+
+    if (wakeSocket != INVALID_SOCKET && ready > 0 && FD_ISSET(wakeSocket, &read_fd)) {
+        DrainWakeSocket();
+        ready--;
+    }
+
+    for (const Registration& reg : registrations) {
+        if (ready == 0) break;
+        if (FD_ISSET(reg.socket, &read_fd)) {
+            ReactorEvent ev;
+            ev.socket = reg.socket;
+            ev.userData = reg.userData;
+            ev.readable = true;
+            out.push_back(ev);
+            ready--;
+        }
+    }
+
+    return static_cast<int>(out.size());
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "IEventReactor.h"
+#include <atomic>
+
+/**
+ * @class SelectReactor
+ * @brief Portable level-triggered fallback built on select().
+ *
+ * Used on platforms without epoll (Windows). It is still bound by FD_SETSIZE.
+ * Wake() sends one byte to a loopback UDP socket that sits in the read set.
+ * (select() on Windows only accepts sockets, so a pipe won't do.) Wait() can
+ * therefore block until I/O arrives or the tick's output is ready. If that
+ * socket can't be created, it falls back to polling every 1 ms.
+ * Write readiness is never reported; the server flushes pending output after
+ * every Wait() instead.
+ */
+class SelectReactor : public IEventReactor {
+public:
+    SelectReactor();
+    ~SelectReactor() override;
+
+    bool Add(SOCKET socket, void* userData) override;
+    void Remove(SOCKET socket) override;
+    int Wait(std::vector<ReactorEvent>& out, int timeoutMs) override;
+    void Wake() override;
+    bool IsEdgeTriggered() const override { return false; }
+
+private:
+    struct Registration {
+        SOCKET socket;
+        void* userData;
+    };
+
+    static const int POLL_INTERVAL_MS = 1;
+
+    void DrainWakeSocket();
+
+    std::vector<Registration> registrations;
+    std::atomic<bool> woken{ false };
+    SOCKET wakeSocket = INVALID_SOCKET;
+};
@@ -3,225 +3,735 @@
 #include <chrono>
 #include "ClientComponent.h"
 #include "ClientInput.h"
-#include "MainMenuState.h"
+#include "ConnectionLimiter.h"
 #include "GameContext.h"
-#include "ThreadSafeQueue.h"
-Server::Server(GameContext& context, GameEngine* engine, ThreadSafeQueue<ClientInput>& queue) : gameContext(context), engine(engine), inputQueue(queue) {
+#include "SessionTable.h"
+#include "MpscQueue.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+Server::Server(GameContext& context, GameEngine* engine, MpscQueue<ClientInput>& queue) : gameContext(context), engine(engine), inputQueue(queue) {
 }
 
 Server::~Server() {
 
 }
 
-void Server::HandleReceive(int clientID, std::string& buffer) {
-    size_t pos = 0;
-    while ((pos = buffer.find('\n')) != std::string::npos) {
-        // 1. Extract raw string
-        std::string line = buffer.substr(0, pos);
-        // ... trim \r ...
+bool Server::QueueLine(ClientConnection* client, std::string_view line) {
+    if (line.empty()) return true;
 
-        // 2. Push to Queue (No parsing, no logic)
-        ClientInput input;
-        input.clientID = clientID;
-        input.rawText = line; // Just the string!
+    // Flood protection: lines beyond the per-tick allowance never reach the game
+    // thread, and a client far past it is cut off.
+    if (++client->linesThisTick > MAX_LINES_PER_TICK) {
+        client->linesDropped++;
+        if (client->linesThisTick > FLOOD_DISCONNECT_LINES) {
+            printf("Client %d is flooding (%d lines this tick), disconnecting\n", client->clientID, client->linesThisTick);
+            return false;
+        }
+        return true;
+    }
 
-        this->inputQueue.Push(input); // Thread-safe push
+    // Push to Queue (No parsing, no logic)
+    ClientInput input;
+    input.clientID = client->clientID;
+    input.rawText.assign(line.data(), line.size());
 
-        buffer.erase(0, pos + 1);
+    // Lock-free push; if the game thread has fallen a whole ring behind the
+    // line is dropped (and counted) rather than stalling the network thread.
+    this->inputQueue.TryPush(std::move(input));
+    return true;
+}
+
+bool Server::IsAbusive(ClientConnection* client) {
+    if (client->OverlongLines() > MAX_OVERLONG_LINES) {
+        printf("Client %d sent %llu overlong lines, disconnecting\n", client->clientID, (unsigned long long)client->OverlongLines());
+        return true;
     }
+    return false;
 }
 void Server::Run() {
-    printf("Running server....");
-    while (true) {
-        fd_set read_fd;
-        fd_set write_fd; // Use a single write set
-        FD_ZERO(&read_fd);
-        FD_ZERO(&write_fd);
+    if (!HasBackend()) {
+        printf("Shard %d has no network backend; not running\n", shardIndex);
+        return;
+    }
+    printf("Running server (%s)....", NetworkBackendName(backend));
+    nextStatsLog = std::chrono::steady_clock::now() + std::chrono::seconds(STATS_INTERVAL_SECONDS);
 
-        FD_SET(ListenSocket, &read_fd);
-        SOCKET max_fd = ListenSocket;
+#ifdef MUD_HAS_IO_URING
+    if (uring) {
+        RunIoUring();
+        return;
+    }
+#endif
 
-        // Populate the read_fd and write_fd sets
-        for (ClientConnection* client : activeClients) {
-            SOCKET client_socket = client->tcpSocket;
+    std::vector<ReactorEvent> events;
 
-            // ALWAYS check for reading
-            FD_SET(client_socket, &read_fd);
+    while (true) {
+        // Block until a socket is ready or the game thread wakes us with output.
+        int count = reactor->Wait(events, STATS_INTERVAL_SECONDS * 1000);
+        netStats.wakeups++;
+        netStats.kernelCalls++;
 
-            // ONLY check for writing if the client has queued data
-            if (!client->OutboundMessages.empty()) {
-                FD_SET(client_socket, &write_fd);
-            }
+        // SOCKET ERROR 
+        if (count < 0) {
+            printf("reactor wait failed with error: %d\n", SocketPlatform::LastError());
+            break; // Exit the loop
+        }
 
-            if (client_socket > max_fd) {
-                max_fd = client_socket;
+        // Only the sockets that actually changed state are visited here.
+        for (const ReactorEvent& ev : events) {
+            if (ev.userData == nullptr) {
+                // A listen socket: drain the whole accept backlog (required when edge-triggered).
+                while (AcceptClient(ev.socket)) {}
+                continue;
             }
+            HandleClientEvent(ev);
         }
 
-        struct timeval timeout;
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 1000; // 1ms timeout (1000 times per second tick)
+        DrainHandoffs();
 
-        // **CALL SELECT ONLY ONCE**
-        int sockets_ready = select(
-            max_fd + 1,
-            &read_fd,   // Check for reading
-            &write_fd,  // Check for writing
-            NULL,       // Check for errors
-            &timeout
-        );
+        // Output queued by the tick since the last wakeup.
+        bool newTick = outputPending.exchange(false);
+        if (newTick || !reactor->IsEdgeTriggered()) {
+            FlushPendingOutput(newTick);
+        }
 
-        // SOCKET ERROR 
-        if (sockets_ready == SOCKET_ERROR) {
-            printf("select failed with error: %d\n", WSAGetLastError());
-            break; // Exit the loop
+        LogStatsIfDue();
+    }
+}
+
+void Server::HandleClientEvent(const ReactorEvent& ev) {
+    ClientConnection* client = static_cast<ClientConnection*>(ev.userData);
+    // A quitting client takes no more input but keeps sending until its
+    // goodbye text is out, same as in FlushPendingOutput.
+    bool quitting = client->needsCleanup;
+    bool disconnected = false;
+
+    // 1. Process READ activity
+    if (!quitting && (ev.readable || ev.hangup)) {
+        // Complete lines go straight onto the game thread's queue
+        int bytes_processed = client->RecieveData([this, client](std::string_view line) {
+            return QueueLine(client, line);
+        });
+        if (bytes_processed > 0) {
+            netStats.bytesIn += bytes_processed;
         }
+        if (bytes_processed < 0 || IsAbusive(client)) {
+            disconnected = true;
+        }
+    }
 
-        // SOCKET Timeout
-        //if (sockets_ready == 0) {
-        //    // Run non-I/O game logic here (GameWorld::Tick())
-        //    continue;
-        //}
+    // 2. Process WRITE activity (the socket drained; resume any unsent tail)
+    if (!disconnected && ev.writable && client->HasPendingOutput()) {
+        int sent = client->SendData();
+        if (sent < 0) {
+            disconnected = true;
+        }
+        else {
+            netStats.bytesOut += sent;
+        }
+    }
+    if (quitting && !client->HasPendingOutput()) {
+        disconnected = true;
+    }
 
-        if (FD_ISSET(ListenSocket, &read_fd)) {
-            AcceptClient();
-            sockets_ready--; // because listen socket is used here
+    CollectIoCalls(client);
+
+    // 3. Handle Disconnection
+    if (disconnected) {
+        DisconnectClient(client);
+    }
+}
+
+void Server::FlushPendingOutput(bool newTick) {
+    std::vector<ClientConnection*> disconnected;
+
+    for (ClientConnection* client : activeClients) {
+        if (newTick) {
+            client->linesThisTick = 0;
+        }
+        // Too far behind to catch up: drop it without waiting for the backlog.
+        if (client->evicted) {
+            disconnected.push_back(client);
+            continue;
+        }
+        int sent = 0;
+        if (client->HasPendingOutput()) {
+            netStats.flushes++;
+            sent = client->SendData();
         }
+        CollectIoCalls(client);
+        if (sent < 0) {
+            disconnected.push_back(client);
+            continue;
+        }
+        netStats.bytesOut += sent;
+        // A graceful quit waits until the goodbye text has gone out.
+        if (client->needsCleanup && !client->HasPendingOutput()) {
+            disconnected.push_back(client);
+        }
+    }
 
-        //std::vector<ClientConnection> tempClients = activeClients;
-        // check if clients sent data and recieve it
-        for (auto it = activeClients.begin(); it != activeClients.end() && sockets_ready > 0;) {
-            ClientConnection* client = *it;
-            bool disconnected = false;
-            SOCKET socket = client->tcpSocket;
+    for (ClientConnection* client : disconnected) {
+        DisconnectClient(client);
+    }
+}
 
-            if (client->needsCleanup) {
-                disconnected = true;
-            }
+void Server::DisconnectClient(ClientConnection* client) {
+    printf("Client Disconnected\n");
 
-            // 1. Process READ activity
-            if (!disconnected && FD_ISSET(socket, &read_fd)) {
-                int bytes_processed = client->RecieveData();
-                if (bytes_processed <= 0) {
-                    disconnected = true;
-                }
-                else {
-                    // Process the input that was received
-                    HandleReceive(client->clientID, client->recvBuffer);
-                    client->ProcessInput();  // Then process it
-                }
-            }
+    reactor->Remove(client->tcpSocket);
+    activeClients.erase(std::find(activeClients.begin(), activeClients.end(), client));
+    RetireClient(client);
+}
 
-            // 2. Process WRITE activity
-            if (!disconnected && FD_ISSET(socket, &write_fd)) {
-                int bytes_sent = client->SendData();
-                if (bytes_sent < 0) {
-                    disconnected = true;
-                }
-            }
+void Server::RetireClient(ClientConnection* client) {
+    closesocket(client->tcpSocket);
+    client->tcpSocket = INVALID_SOCKET;
 
-            // 3. Handle Disconnection
-            if (disconnected) {
-                printf("Client Disconnected\n");
+    // The game thread still holds this connection through its session; it
+    // removes the ClientComponent and deletes it at the start of the next tick.
+    gameContext.sessions->Retire(client);
+}
 
-                if (client->playerEntityID != -1) {
-                    gameContext.registry->RemoveComponent<ClientComponent>(client->playerEntityID);
-                }
+void Server::Wake() {
+    outputPending = true;
+    WakeBackend();
+}
 
-                delete client;
-                it = activeClients.erase(it);
-            }
-            else {
-                ++it;
-            }
+void Server::WakeBackend() {
+#ifdef MUD_HAS_IO_URING
+    if (uring) {
+        uring->Wake();
+        return;
+    }
+#endif
+    if (reactor) {
+        reactor->Wake();
+    }
+}
+
+void Server::CollectIoCalls(ClientConnection* client) {
+    netStats.kernelCalls += client->ioCalls;
+    netStats.flushSends += client->sendCalls;
+    client->ioCalls = 0;
+    client->sendCalls = 0;
+    client->CollectCompressionStats(netStats.uncompressedBytes, netStats.compressedBytes);
+}
 
+void Server::LogStatsIfDue() {
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextStatsLog) return;
+    nextStatsLog = now + std::chrono::seconds(STATS_INTERVAL_SECONDS);
+
+#ifdef MUD_HAS_IO_URING
+    if (uring) {
+        const IoUringBackend::Stats& u = uring->GetStats();
+        netStats.kernelCalls = u.enterCalls;
+        netStats.bytesIn = u.bytesReceived;
+        netStats.bytesOut = u.bytesSent;
+    }
+#endif
+
+    // Same counters for every backend, so runs with --net=select/epoll/uring compare directly.
+    printf("[Net] shard %d %s: %zu clients, %llu wakeups, %llu kernel calls, %llu bytes in, %llu bytes out, input depth %zu, dropped %llu\n",
+        shardIndex, NetworkBackendName(backend), activeClients.size(),
+        (unsigned long long)netStats.wakeups, (unsigned long long)netStats.kernelCalls,
+        (unsigned long long)netStats.bytesIn, (unsigned long long)netStats.bytesOut,
+        inputQueue.Depth(), (unsigned long long)inputQueue.Dropped());
+    if (netStats.refused > 0) {
+        printf("[Net] shard %d connections: %llu accepted, %llu refused by rate limit\n",
+            shardIndex, (unsigned long long)netStats.accepted, (unsigned long long)netStats.refused);
+    }
+    // The limiter is shared, so one shard reports its totals for the whole server.
+    if (connectionLimiter && shardIndex == 0) {
+        uint64_t perIp = connectionLimiter->RefusedPerIp();
+        uint64_t global = connectionLimiter->RefusedGlobal();
+        uint64_t evicted = connectionLimiter->Evicted();
+        if (perIp + global + evicted > 0) {
+            printf("[Net] rate limit: %llu refused per address, %llu refused server-wide, %llu buckets evicted\n",
+                (unsigned long long)perIp, (unsigned long long)global, (unsigned long long)evicted);
         }
     }
+    // How many wire segments each tick's flush turned into; sampled here, once a
+    // minute, rather than with an extra syscall per flush.
+    for (ClientConnection* client : activeClients) {
+        uint64_t segments;
+        if (SocketPlatform::DataSegmentsSent(client->tcpSocket, segments)) {
+            netStats.tcpSegments += segments - client->lastSegmentsSent;
+            client->lastSegmentsSent = segments;
+        }
+    }
+    if (netStats.flushes > 0) {
+        double flushes = (double)netStats.flushes;
+        printf("[Net] shard %d flushes: %llu, per flush %.0f bytes, %.2f sends, %.2f TCP segments\n",
+            shardIndex, (unsigned long long)netStats.flushes, (double)netStats.bytesOut / flushes,
+            (double)netStats.flushSends / flushes, (double)netStats.tcpSegments / flushes);
+    }
+
+    if (netStats.uncompressedBytes > 0) {
+        printf("[Net] shard %d compression: %llu bytes sent as %llu (%.1f%%)\n",
+            shardIndex, (unsigned long long)netStats.uncompressedBytes, (unsigned long long)netStats.compressedBytes,
+            100.0 * (double)netStats.compressedBytes / (double)netStats.uncompressedBytes);
+    }
 }
 
-bool Server::Start(const char* DEFAULT_PORT) {
-    WSADATA wsaData;
-    int iResult;
+bool Server::Start(const char* DEFAULT_PORT, NetworkBackend requested, bool reusePort) {
+    // Initialize Winsock (no-op on BSD sockets)
+    if (!SocketPlatform::Startup()) {
+        printf("Socket startup failed with error: %d\n", SocketPlatform::LastError());
+        return false;
+    }
 
-    ListenSocket = INVALID_SOCKET;
-    SOCKET ClientSocket = INVALID_SOCKET;
-    struct addrinfo* result = NULL;
-    struct addrinfo hints;
+    ListenSocket = OpenListenSocket(DEFAULT_PORT, reusePort);
+    if (ListenSocket == INVALID_SOCKET) {
+        SocketPlatform::Cleanup();
+        return false;
+    }
 
-    // Initialize Winsock
-    iResult = WSAStartup(MAKEWORD(2, 2), &wsaData);
-    if (iResult != 0) {
-        printf("WSAStartup failed with error: %d\n", iResult);
-        return 1;
+    if (!InitBackend(requested)) {
+        closesocket(ListenSocket);
+        ListenSocket = INVALID_SOCKET;
+        SocketPlatform::Cleanup();
+        return false;
     }
 
-    ZeroMemory(&hints, sizeof(hints));
+    printf("Server Started");
+    return true;
+}
+
+bool Server::ListenWebSocket(const char* port, bool reusePort) {
+    // Start failed, so there is no event loop to add the listener to
+    if (!HasBackend()) {
+        return false;
+    }
+
+    WebSocketListenSocket = OpenListenSocket(port, reusePort);
+    if (WebSocketListenSocket == INVALID_SOCKET) {
+        return false;
+    }
+
+    // Same event loop as the telnet listener; only the accepted connections differ.
+    bool armed;
+#ifdef MUD_HAS_IO_URING
+    if (uring) {
+        armed = uring->ArmAccept(WebSocketListenSocket);
+    }
+    else
+#endif
+    {
+        armed = reactor->Add(WebSocketListenSocket, nullptr);
+    }
+    if (!armed) {
+        closesocket(WebSocketListenSocket);
+        WebSocketListenSocket = INVALID_SOCKET;
+        return false;
+    }
+
+    printf("WebSocket listener on port %s\n", port);
+    return true;
+}
+
+SOCKET Server::OpenListenSocket(const char* port, bool reusePort) {
+    int iResult;
+    struct addrinfo* result = NULL;
+    struct addrinfo hints;
+
+    memset(&hints, 0, sizeof(hints));
     hints.ai_family = AF_INET;
     hints.ai_socktype = SOCK_STREAM;
     hints.ai_protocol = IPPROTO_TCP;
     hints.ai_flags = AI_PASSIVE;
 
     // Resolve the server address and port
-    iResult = getaddrinfo(NULL, DEFAULT_PORT, &hints, &result);
+    iResult = getaddrinfo(NULL, port, &hints, &result);
     if (iResult != 0) {
         printf("getaddrinfo failed with error: %d\n", iResult);
-        WSACleanup();
-        return 1;
+        return INVALID_SOCKET;
     }
 
     // Create a SOCKET for the server to listen for client connections.
-    ListenSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
-    if (ListenSocket == INVALID_SOCKET) {
-        printf("socket failed with error: %ld\n", WSAGetLastError());
+    SOCKET listenSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (listenSocket == INVALID_SOCKET) {
+        printf("socket failed with error: %d\n", SocketPlatform::LastError());
         freeaddrinfo(result);
-        WSACleanup();
-        return 1;
+        return INVALID_SOCKET;
+    }
+
+#ifndef _WIN32
+    // Let a restarted server rebind while old connections sit in TIME_WAIT.
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+    if (reusePort && !SocketPlatform::SetReusePort(listenSocket)) {
+        printf("SO_REUSEPORT failed with error: %d\n", SocketPlatform::LastError());
     }
 
     // Setup the TCP listening socket
-    iResult = bind(ListenSocket, result->ai_addr, (int)result->ai_addrlen);
+    iResult = bind(listenSocket, result->ai_addr, (int)result->ai_addrlen);
     if (iResult == SOCKET_ERROR) {
-        printf("bind failed with error: %d\n", WSAGetLastError());
+        printf("bind failed with error: %d\n", SocketPlatform::LastError());
         freeaddrinfo(result);
-        closesocket(ListenSocket);
-        WSACleanup();
-        return 1;
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
     }
 
     freeaddrinfo(result);
 
-    iResult = listen(ListenSocket, SOMAXCONN);
+    iResult = listen(listenSocket, SOMAXCONN);
     if (iResult == SOCKET_ERROR) {
-        printf("listen failed with error: %d\n", WSAGetLastError());
-        closesocket(ListenSocket);
-        WSACleanup();
-        return 1;
+        printf("listen failed with error: %d\n", SocketPlatform::LastError());
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
     }
 
-    printf("Server Started");
-    return 0;
+    // The listen socket is drained until it would block, so it must not block.
+    SocketPlatform::SetNonBlocking(listenSocket);
+    return listenSocket;
+}
+
+bool Server::StartWorker(NetworkBackend requested) {
+    ListenSocket = INVALID_SOCKET;
+    if (!InitBackend(requested)) {
+        return false;
+    }
+    printf("I/O shard %d started\n", shardIndex);
+    return true;
+}
+
+bool Server::InitBackend(NetworkBackend requested) {
+#ifdef MUD_HAS_IO_URING
+    if (requested == NetworkBackend::IoUring) {
+        uring = std::make_unique<IoUringBackend>();
+        if (uring->Init() && (ListenSocket == INVALID_SOCKET || uring->ArmAccept(ListenSocket))) {
+            backend = NetworkBackend::IoUring;
+            return true;
+        }
+        // Kernel too old or io_uring disabled (e.g. by seccomp): fall back to readiness.
+        printf("io_uring unavailable, falling back to epoll\n");
+        uring.reset();
+    }
+#endif
+
+    reactor = CreateEventReactor(requested);
+    if (!reactor) {
+        return false;
+    }
+    backend = reactor->IsEdgeTriggered() ? NetworkBackend::Epoll : NetworkBackend::Select;
+    if (ListenSocket != INVALID_SOCKET && !reactor->Add(ListenSocket, nullptr)) {
+        reactor.reset();
+        return false;
+    }
+    return true;
 }
 
 bool Server::Stop() {
     return 1;
 }
 
-bool Server::AcceptClient() {
-    SOCKET newSocket = accept(ListenSocket, NULL, NULL);
-    if (newSocket != INVALID_SOCKET) {
-        ClientConnection* newClient = new ClientConnection(newSocket);
+bool Server::AcceptClient(SOCKET listener) {
+    // The socket comes back non-blocking already, so a burst of connects costs
+    // one syscall each; the caller keeps accepting until the backlog is empty.
+    sockaddr_storage peer;
+    SOCKET newSocket = SocketPlatform::Accept(listener, peer);
+    netStats.kernelCalls++;
+    if (newSocket == INVALID_SOCKET) {
+        return false;
+    }
+    ConnectionKind kind = ListenerKind(listener);
+    if (Admit(newSocket, peer, kind)) {
+        DispatchAccepted(newSocket, kind);
+    }
+    return true;
+}
+
+bool Server::Admit(SOCKET newSocket, const sockaddr_storage& peer, ConnectionKind kind) {
+    netStats.accepted++;
+    if (!connectionLimiter || connectionLimiter->Admit(peer)) {
+        return true;
+    }
 
-        // Set a unique client ID (you can use the socket number or a counter)
-        newClient->clientID = static_cast<int>(newSocket); 
+    // Refused before anything is allocated for it. A telnet user gets a reason;
+    // a WebSocket client hasn't sent its handshake yet, so it just sees the close.
+    netStats.refused++;
+    if (kind == ConnectionKind::Telnet) {
+        static const char notice[] = "Too many connections, try again shortly.\r\n";
+        send(newSocket, notice, sizeof(notice) - 1, SocketPlatform::SEND_FLAGS);
+    }
+    closesocket(newSocket);
+    return false;
+}
 
-        newClient->SetEngine(engine);
-        newClient->PushState(new MainMenuState());
-        activeClients.push_back(newClient);
+ConnectionKind Server::ListenerKind(SOCKET listener) const {
+    return listener != INVALID_SOCKET && listener == WebSocketListenSocket ? ConnectionKind::WebSocket : ConnectionKind::Telnet;
+}
 
-        printf("New client connected with ID: %d\n", newClient->clientID);
-        return true;
+void Server::DispatchAccepted(SOCKET newSocket, ConnectionKind kind) {
+    // Without SO_REUSEPORT one shard accepts for everyone and deals clients out in turn.
+    if (acceptPeers.size() > 1) {
+        Server* target = acceptPeers[nextPeer++ % acceptPeers.size()];
+        if (target != this) {
+            target->AdoptClient(newSocket, kind);
+            return;
+        }
+    }
+    AttachClient(newSocket, kind);
+}
+
+void Server::AdoptClient(SOCKET socket, ConnectionKind kind) {
+    {
+        std::lock_guard<std::mutex> lock(handoffMutex);
+        handoffSockets.push_back({ socket, kind });
+    }
+    handoffPending = true;
+    WakeBackend();
+}
+
+void Server::DrainHandoffs() {
+    if (!handoffPending.exchange(false)) return;
+
+    std::vector<std::pair<SOCKET, ConnectionKind>> adopted;
+    {
+        std::lock_guard<std::mutex> lock(handoffMutex);
+        adopted.swap(handoffSockets);
+    }
+    for (const auto& handoff : adopted) {
+        AttachClient(handoff.first, handoff.second);
+    }
+}
+
+void Server::AttachClient(SOCKET newSocket, ConnectionKind kind) {
+    ClientConnection* newClient = RegisterClient(newSocket, kind);
+    if (!newClient) return;
+
+#ifdef MUD_HAS_IO_URING
+    if (uring) {
+        if (uring->ArmRecv(newClient->tcpSocket, newClient)) {
+            newClient->uring.opsInFlight++;
+        }
+        else {
+            BeginUringClose(newClient);
+        }
+        return;
+    }
+#endif
+
+    if (!reactor->Add(newSocket, newClient)) {
+        // Refused (e.g. the select backend is full)
+        activeClients.pop_back();
+        RetireClient(newClient);
+    }
+}
+
+ClientConnection* Server::RegisterClient(SOCKET newSocket, ConnectionKind kind) {
+    SocketPlatform::SetNoDelay(newSocket);
+    ClientConnection* newClient = new ClientConnection(newSocket);
+
+    // Telnet option offers go out ahead of the menu text; a WebSocket client
+    // gets the menu once its handshake is done.
+    if (kind == ConnectionKind::WebSocket) {
+        newClient->EnableWebSocket(webSocketConfig);
     }
     else {
-        return false;
+        newClient->EnableTelnet(telnetConfig);
+    }
+    newClient->SetEngine(engine);
+
+    // The session handle is the client ID; unlike the socket number it is never reused.
+    // Opening it publishes the connection, so it must be fully set up first. The
+    // game thread pushes the main menu on its next tick and the menu text goes
+    // out with that tick's flush, like any other output.
+    newClient->clientID = gameContext.sessions->Open(newClient);
+    if (newClient->clientID == INVALID_SESSION) {
+        printf("Session table full, refusing connection\n");
+        delete newClient;
+        return nullptr;
+    }
+    activeClients.push_back(newClient);
+    return newClient;
+}
+
+#ifdef MUD_HAS_IO_URING
+void Server::RunIoUring() {
+    std::vector<UringCompletion> completions;
+    if (!uring->Enable()) {
+        return;
+    }
+
+    while (true) {
+        // One io_uring_enter submits everything queued last round and reaps this round.
+        int count = uring->Wait(completions, STATS_INTERVAL_SECONDS * 1000);
+        netStats.wakeups++;
+
+        if (count < 0) {
+            printf("io_uring wait failed with error: %d (%s)\n", errno, strerror(errno));
+            break;
+        }
+
+        for (const UringCompletion& c : completions) {
+            switch (c.kind) {
+            case UringCompletion::Kind::Accept:
+                if (c.result >= 0) {
+                    SOCKET newSocket = static_cast<SOCKET>(c.result);
+                    ConnectionKind kind = ListenerKind(c.listenSocket);
+                    sockaddr_storage peer;
+                    if (!SocketPlatform::PeerAddress(newSocket, peer)) {
+                        closesocket(newSocket);
+                    }
+                    else if (Admit(newSocket, peer, kind)) {
+                        DispatchAccepted(newSocket, kind);
+                    }
+                }
+                if (!c.more) {
+                    uring->ArmAccept(c.listenSocket);
+                }
+                break;
+            case UringCompletion::Kind::Recv:
+                HandleUringRecv(c);
+                break;
+            case UringCompletion::Kind::Send:
+                HandleUringSend(c);
+                break;
+            default:
+                break;
+            }
+        }
+
+        DrainHandoffs();
+
+        if (outputPending.exchange(false)) {
+            FlushPendingOutputUring();
+        }
+        ReapClosedUringClients();
+        LogStatsIfDue();
+    }
+}
+
+void Server::HandleUringRecv(const UringCompletion& c) {
+    ClientConnection* client = static_cast<ClientConnection*>(c.userData);
+
+    if (c.result > 0) {
+        bool keep = client->uring.closing || client->FeedInput(c.data, c.length, [this, client](std::string_view line) {
+            return QueueLine(client, line);
+        });
+        uring->RecycleBuffer(c.bufferId);
+
+        if (!keep || (!client->uring.closing && IsAbusive(client))) {
+            BeginUringClose(client);
+        }
+    }
+
+    if (c.more) return;
+
+    // The multishot recv has terminated; the kernel no longer owns it.
+    client->uring.opsInFlight--;
+    if (client->uring.closing) return;
+
+    if (c.result > 0 || c.result == -ENOBUFS) {
+        // Terminated because the buffer pool ran dry (or the kernel chose to stop): re-arm.
+        if (uring->ArmRecv(client->tcpSocket, client)) {
+            client->uring.opsInFlight++;
+            return;
+        }
+    }
+
+    // Orderly shutdown (0) or a real error.
+    client->needsCleanup = true;
+    BeginUringClose(client);
+}
+
+void Server::HandleUringSend(const UringCompletion& c) {
+    ClientConnection* client = static_cast<ClientConnection*>(c.userData);
+    UringConnectionState& state = client->uring;
+    state.opsInFlight--;
+    state.sendsInFlight--;
+
+    if (c.result > 0) {
+        // Completions of a link chain arrive in order, so bytes always come off the front.
+        client->ConsumeOutput(static_cast<size_t>(c.result));
+    }
+    else if (c.result < 0 && c.result != -ECANCELED && !state.closing) {
+        printf("send failed with error: %d\n", -c.result);
+        BeginUringClose(client);
+        return;
+    }
+
+    // A send that comes up short even with MSG_WAITALL fails the link, and the
+    // rest of the chain completes with -ECANCELED; resubmit from the first unsent byte.
+    if (state.sendsInFlight == 0 && !state.closing) {
+        SubmitUringSends(client);
+    }
+}
+
+void Server::SubmitUringSends(ClientConnection* client) {
+    UringConnectionState& state = client->uring;
+
+    // Only one chain per socket at a time, otherwise the kernel may interleave them.
+    if (state.sendsInFlight > 0) return;
+
+    // The queued segments themselves are submitted; they stay in the chain until consumed.
+    std::vector<std::pair<const char*, size_t>> chunks;
+    client->GatherOutput(MAX_LINKED_SENDS, [&chunks](const char* data, size_t length) {
+        chunks.push_back({ data, length });
+    });
+    client->CollectCompressionStats(netStats.uncompressedBytes, netStats.compressedBytes);
+
+    if (chunks.empty()) {
+        // A graceful quit waits until the goodbye text has gone out.
+        if (client->needsCleanup) {
+            BeginUringClose(client);
+        }
+        return;
+    }
+
+    if (!uring->SubmitSends(client->tcpSocket, client, chunks)) {
+        // Submission queue full: the next wakeup tries again.
+        outputPending = true;
+        return;
+    }
+    netStats.flushSends += chunks.size();
+    state.sendsInFlight += static_cast<int>(chunks.size());
+    state.opsInFlight += static_cast<int>(chunks.size());
+}
+
+void Server::FlushPendingOutputUring() {
+    // Copy: SubmitUringSends may close (and unlist) a client that finished quitting.
+    std::vector<ClientConnection*> clients = activeClients;
+    for (ClientConnection* client : clients) {
+        client->linesThisTick = 0;
+        if (client->evicted) {
+            BeginUringClose(client);
+            continue;
+        }
+        if (client->HasPendingOutput() || client->needsCleanup) {
+            netStats.flushes++;
+            SubmitUringSends(client);
+        }
+    }
+}
+
+void Server::BeginUringClose(ClientConnection* client) {
+    if (client->uring.closing) return;
+    client->uring.closing = true;
+    printf("Client Disconnected\n");
+
+    // Buffers in flight stay owned by the kernel until every CQE is back,
+    // so the connection is parked rather than deleted here.
+    uring->CancelAll(client->tcpSocket);
+    activeClients.erase(std::find(activeClients.begin(), activeClients.end(), client));
+    closingClients.push_back(client);
+}
+
+void Server::ReapClosedUringClients() {
+    for (size_t i = 0; i < closingClients.size();) {
+        ClientConnection* client = closingClients[i];
+        if (client->uring.opsInFlight > 0) {
+            i++;
+            continue;
+        }
+        closingClients[i] = closingClients.back();
+        closingClients.pop_back();
+        RetireClient(client);
     }
 }
+#endif
@@ -1,37 +1,120 @@
 #pragma once
-#undef UNICODE
-
-#define WIN32_LEAN_AND_MEAN
-
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
 #include "ClientConnection.h"
-#include <windows.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include "ThreadSafeQueue.h"  // Include the full template
+#include "SocketPlatform.h"
+#include "IEventReactor.h"
+#include "IoUringBackend.h"
+#include "NetworkBackend.h"
+#include "MpscQueue.h"
 
 struct GameContext;
 struct GameContext;
 struct ClientInput;
 class GameEngine;
+class ConnectionLimiter;
 
 //#include <sol/sol.hpp>
 class Server {
 public:
 	GameContext& gameContext;
 	GameEngine* engine;
-	ThreadSafeQueue<ClientInput>& inputQueue; // Change to reference
+	MpscQueue<ClientInput>& inputQueue; // Change to reference
 
-	Server(GameContext& context, GameEngine* engine, ThreadSafeQueue<ClientInput>& inputqueue);
+	Server(GameContext& context, GameEngine* engine, MpscQueue<ClientInput>& inputqueue);
 	~Server();
 	void Init();
-	bool Start(const char* port);
-	void HandleReceive(int clientID, std::string& buffer);
+	// Index of this I/O shard; each shard runs its own Run() loop on its own thread.
+	int shardIndex = 0;
+
+	// reusePort: bind with SO_REUSEPORT so several shards can each own a listen socket.
+	bool Start(const char* port, NetworkBackend backend = NetworkBackend::Auto, bool reusePort = false);
+	// Adds an RFC 6455 listener to this shard's event loop (call after Start).
+	bool ListenWebSocket(const char* port, bool reusePort = false);
+	// A shard without a listen socket; it only serves clients handed over by an acceptor.
+	bool StartWorker(NetworkBackend backend = NetworkBackend::Auto);
+	// Spread accepted clients round-robin over these shards (may include this one).
+	void SetAcceptPeers(const std::vector<Server*>& peers) { acceptPeers = peers; }
+	// Thread-safe: give this shard ownership of an accepted socket.
+	void AdoptClient(SOCKET socket, ConnectionKind kind = ConnectionKind::Telnet);
+	// False until Start/StartWorker succeeds; Run() returns at once without one.
+	bool HasBackend() const {
+#ifdef MUD_HAS_IO_URING
+		if (uring) return true;
+#endif
+		return reactor != nullptr;
+	}
 	void Run();
 	bool Stop();
-	bool AcceptClient();
+	bool AcceptClient(SOCKET listener);
+	// Called from the game thread once a tick's output has been queued.
+	void Wake();
+	const NetworkStats& GetStats() const { return netStats; }
+	// Telnet/MCCP2 settings applied to every connection accepted afterwards.
+	void SetTelnetConfig(const TelnetConfig& config) { telnetConfig = config; }
+	void SetWebSocketConfig(const WebSocketConfig& config) { webSocketConfig = config; }
+	// Shared by all shards; consulted for every accepted socket. nullptr admits everyone.
+	void SetConnectionLimiter(ConnectionLimiter* limiter) { connectionLimiter = limiter; }
 private:
+	bool InitBackend(NetworkBackend requested);
+	SOCKET OpenListenSocket(const char* port, bool reusePort);
+	ConnectionKind ListenerKind(SOCKET listener) const;
+	void WakeBackend();
+	bool Admit(SOCKET newSocket, const sockaddr_storage& peer, ConnectionKind kind);
+	void DispatchAccepted(SOCKET newSocket, ConnectionKind kind);
+	void AttachClient(SOCKET newSocket, ConnectionKind kind);
+	void DrainHandoffs();
+	ClientConnection* RegisterClient(SOCKET newSocket, ConnectionKind kind);
+	void HandleClientEvent(const ReactorEvent& ev);
+	bool QueueLine(ClientConnection* client, std::string_view line);
+	bool IsAbusive(ClientConnection* client);
+	void FlushPendingOutput(bool newTick);
+	void DisconnectClient(ClientConnection* client);
+	void RetireClient(ClientConnection* client);
+	void CollectIoCalls(ClientConnection* client);
+	void LogStatsIfDue();
+
+#ifdef MUD_HAS_IO_URING
+	void RunIoUring();
+	void HandleUringRecv(const UringCompletion& c);
+	void HandleUringSend(const UringCompletion& c);
+	void SubmitUringSends(ClientConnection* client);
+	void FlushPendingOutputUring();
+	void BeginUringClose(ClientConnection* client);
+	void ReapClosedUringClients();
+
+	static const size_t MAX_LINKED_SENDS = 64;
+	std::unique_ptr<IoUringBackend> uring;
+	std::vector<ClientConnection*> closingClients;
+#endif
+
 	std::vector<ClientConnection*> activeClients;
-	SOCKET ListenSocket;
+	SOCKET ListenSocket = INVALID_SOCKET;
+	SOCKET WebSocketListenSocket = INVALID_SOCKET;
+	NetworkBackend backend = NetworkBackend::Auto;
+	std::unique_ptr<IEventReactor> reactor;
+	std::atomic<bool> outputPending{ false };
+	TelnetConfig telnetConfig;
+	WebSocketConfig webSocketConfig;
+	ConnectionLimiter* connectionLimiter = nullptr;
+
+	std::vector<Server*> acceptPeers;
+	size_t nextPeer = 0;
+	std::mutex handoffMutex;
+	std::vector<std::pair<SOCKET, ConnectionKind>> handoffSockets;
+	std::atomic<bool> handoffPending{ false };
+
+	// Input flood limits, applied on the network thread
+	static const int MAX_LINES_PER_TICK = 20;
+	static const int FLOOD_DISCONNECT_LINES = 200;
+	static const uint64_t MAX_OVERLONG_LINES = 8;
+
+	static const int STATS_INTERVAL_SECONDS = 60;
+	NetworkStats netStats;
+	std::chrono::steady_clock::time_point nextStatsLog;
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "SessionTable.h"
+#include "ClientConnection.h"
+
+SessionTable::~SessionTable() {
+    for (uint32_t i = 0; i < MAX_CHUNKS; i++) {
+        delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+SessionID SessionTable::Open(ClientConnection* connection) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        if (slotCount > INDEX_MASK) {
+            return INVALID_SESSION;
+        }
+        index = slotCount++;
+        uint32_t chunk = index / CHUNK_SIZE;
+        if (!chunks[chunk].load(std::memory_order_relaxed)) {
+            chunks[chunk].store(new Slot[CHUNK_SIZE], std::memory_order_release);
+        }
+    }
+
+    Slot& slot = chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed)[index % CHUNK_SIZE];
+    uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+    slot.connection.store(connection, std::memory_order_release);
+    liveCount.fetch_add(1, std::memory_order_relaxed);
+
+    SessionID id = static_cast<SessionID>((generation << INDEX_BITS) | index);
+    opened.push_back(id);
+    return id;
+}
+
+void SessionTable::TakeOpened(std::vector<SessionID>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (opened.empty()) return;
+    out.insert(out.end(), opened.begin(), opened.end());
+    opened.clear();
+}
+
+void SessionTable::Retire(ClientConnection* connection) {
+    std::lock_guard<std::mutex> lock(mutex);
+    retired.push_back(connection);
+}
+
+SessionTable::Slot* SessionTable::SlotFor(SessionID id) const {
+    if (id < 0) return nullptr;
+
+    uint32_t index = static_cast<uint32_t>(id) & INDEX_MASK;
+    Slot* chunk = chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+    if (!chunk) return nullptr;
+
+    Slot* slot = &chunk[index % CHUNK_SIZE];
+    uint32_t generation = static_cast<uint32_t>(id) >> INDEX_BITS;
+    return slot->generation.load(std::memory_order_acquire) == generation ? slot : nullptr;
+}
+
+ClientConnection* SessionTable::Get(SessionID id) const {
+    Slot* slot = SlotFor(id);
+    return slot ? slot->connection.load(std::memory_order_acquire) : nullptr;
+}
+
+void SessionTable::BindEntity(SessionID id, int entityID) {
+    Slot* slot = SlotFor(id);
+    if (!slot) return;
+
+    if (slot->entityID != -1) {
+        entitySessions.erase(slot->entityID);
+    }
+    slot->entityID = entityID;
+    if (entityID != -1) {
+        entitySessions[entityID] = id;
+    }
+}
+
+int SessionTable::GetEntity(SessionID id) const {
+    Slot* slot = SlotFor(id);
+    return slot ? slot->entityID : -1;
+}
+
+ClientConnection* SessionTable::FindByEntity(int entityID) const {
+    auto it = entitySessions.find(entityID);
+    return it != entitySessions.end() ? Get(it->second) : nullptr;
+}
+
+void SessionTable::TakeRetired(std::vector<ClientConnection*>& out) {
+    size_t first = out.size();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (retired.empty()) return;
+        out.insert(out.end(), retired.begin(), retired.end());
+        retired.clear();
+    }
+
+    for (size_t i = first; i < out.size(); i++) {
+        Close(out[i]->clientID);
+    }
+}
+
+void SessionTable::Close(SessionID id) {
+    Slot* slot = SlotFor(id);
+    if (!slot) return;
+
+    if (slot->entityID != -1) {
+        entitySessions.erase(slot->entityID);
+        slot->entityID = -1;
+    }
+
+    // Bumping the generation invalidates every outstanding copy of the handle.
+    slot->connection.store(nullptr, std::memory_order_release);
+    slot->generation.store((slot->generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK, std::memory_order_release);
+    liveCount.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    freeSlots.push_back(static_cast<uint32_t>(id) & INDEX_MASK);
+}
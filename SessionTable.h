@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class ClientConnection;
+
+// Generational connection handle: slot index in the low bits, the slot's
+// generation above it. A handle kept after its connection closed no longer
+// matches the slot, even once the slot (or the socket number) is reused.
+using SessionID = int;
+const SessionID INVALID_SESSION = -1;
+
+/**
+ * @class SessionTable
+ * @brief Slab of live connections, looked up in O(1) by SessionID or player entity.
+ *
+ * Threads:
+ * - Network threads Open a session on accept and Retire it when the socket
+ *   goes away. Both take a short mutex; they only happen on connect/disconnect.
+ * - The game thread resolves handles lock-free with Get. It also owns the
+ *   entity binding and reaps retired sessions once per tick, so a
+ *   ClientConnection is only ever deleted on the thread that uses it.
+ * Slots live in fixed chunks that are never moved or freed while the table
+ * exists, so a lookup can race an Open safely.
+ */
+class SessionTable {
+public:
+    SessionTable() = default;
+    ~SessionTable();
+
+    // Network thread: returns INVALID_SESSION when the table is full.
+    SessionID Open(ClientConnection* connection);
+    // Game thread: the sessions opened since the last call, so their first
+    // game state is pushed (and its output queued) on the game thread.
+    void TakeOpened(std::vector<SessionID>& out);
+    // Network thread: the connection is off the network; hand it to the game thread.
+    void Retire(ClientConnection* connection);
+
+    // Game thread: the connection for a handle, or nullptr if it has closed.
+    ClientConnection* Get(SessionID id) const;
+
+    // Game thread: link a logged-in player entity to its session.
+    void BindEntity(SessionID id, int entityID);
+    int GetEntity(SessionID id) const;
+    ClientConnection* FindByEntity(int entityID) const;
+
+    // Game thread: takes the connections retired since the last call and frees
+    // their slots. The caller finishes tearing them down and deletes them.
+    void TakeRetired(std::vector<ClientConnection*>& out);
+
+    // Game thread: calls fn(ClientConnection*) for every session not yet reaped.
+    template<typename Fn>
+    void ForEach(Fn&& fn) {
+        uint32_t count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            count = slotCount;
+        }
+        for (uint32_t index = 0; index < count; index++) {
+            Slot* chunk = chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+            ClientConnection* connection = chunk[index % CHUNK_SIZE].connection.load(std::memory_order_acquire);
+            if (connection) fn(connection);
+        }
+    }
+
+    size_t Count() const { return liveCount.load(std::memory_order_relaxed); }
+
+private:
+    static const int INDEX_BITS = 18;
+    static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const uint32_t GENERATION_MASK = (1u << (31 - INDEX_BITS)) - 1;
+    static const uint32_t CHUNK_SIZE = 1024;
+    static const uint32_t MAX_CHUNKS = (INDEX_MASK + 1) / CHUNK_SIZE;
+
+    struct Slot {
+        std::atomic<uint32_t> generation{ 0 };
+        std::atomic<ClientConnection*> connection{ nullptr };
+        int entityID = -1;   // Game thread only
+    };
+
+    Slot* SlotFor(SessionID id) const;
+    void Close(SessionID id);
+
+    std::atomic<Slot*> chunks[MAX_CHUNKS] = {};
+    std::mutex mutex;                       // Guards the allocation state below
+    std::vector<uint32_t> freeSlots;
+    uint32_t slotCount = 0;
+    std::vector<ClientConnection*> retired;
+    std::vector<SessionID> opened;
+    std::atomic<size_t> liveCount{ 0 };
+
+    std::unordered_map<int, SessionID> entitySessions;   // Game thread only
+};
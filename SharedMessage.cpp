@@ -0,0 +1,39 @@
+#include "SharedMessage.h"
+#include "NetworkSystem.h"
+#include "TextHelperFunctions.h"
+
+void SharedMessage::DeliverTo(const ClientComponent& client) {
+    if (!client.client) return;
+
+    if (client.isWebClient) {
+        client.client->QueueSegment(Web(client.wireFormat));
+        return;
+    }
+
+    client.client->QueueSegment(Ansi());
+    if (client.WantsGmcp() && message.HasUiData()) {
+        client.client->QueueSegment(Gmcp());
+    }
+}
+
+const OutboundSegment& SharedMessage::Ansi() {
+    if (!ansi) {
+        ansi = MakeSegment(TextHelperFunctions::Colorize(message.consoleText));
+    }
+    return ansi;
+}
+
+const OutboundSegment& SharedMessage::Web(WireFormat format) {
+    OutboundSegment& segment = web[static_cast<size_t>(format)];
+    if (!segment) {
+        segment = MakeSegment(NetworkSystem::BuildWebEnvelope(message, format));
+    }
+    return segment;
+}
+
+const OutboundSegment& SharedMessage::Gmcp() {
+    if (!gmcp) {
+        gmcp = MakeSegment(NetworkSystem::BuildGMCPSession(message.type, message.uiData.dump()));
+    }
+    return gmcp;
+}
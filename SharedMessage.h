@@ -0,0 +1,30 @@
+#pragma once
+#include "ClientComponent.h"
+#include "OutboundBuffer.h"
+
+/**
+ * @class SharedMessage
+ * @brief A broadcast GameMessage rendered at most once per output flavour.
+ *
+ * The ANSI console text, the web envelope (per negotiated encoding) and the GMCP
+ * packet are each built the first time a recipient needs them. After that, the same
+ * immutable segment is queued on every recipient's outbound chain, so a crowded
+ * room costs one render, not one per player.
+ */
+class SharedMessage {
+public:
+    explicit SharedMessage(GameMessage msg) : message(std::move(msg)) {}
+
+    // Queues the flavour(s) this client understands, like NetworkSystem::FlushQueues.
+    void DeliverTo(const ClientComponent& client);
+
+private:
+    const OutboundSegment& Ansi();
+    const OutboundSegment& Web(WireFormat format);
+    const OutboundSegment& Gmcp();
+
+    GameMessage message;
+    OutboundSegment ansi;
+    OutboundSegment web[static_cast<size_t>(WireFormat::Count)];
+    OutboundSegment gmcp;
+};
@@ -0,0 +1,576 @@
+// Headless simulation: the real GameEngine, world data and Lua scripts, driven
+// by synthetic clients instead of a Server. No sockets or network threads are
+// involved; each tick the clients' scripted commands go straight into the input
+// queue and their output is drained from memory. Ticks run back to back with a
+// fixed step and a fixed RNG seed, so two runs of the same build produce the same
+// output (checked with a digest) and the timings can be compared between builds.
+// With --replay it runs a recording of real traffic (GameEngine::StartRecording)
+// instead of scripted clients.
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "GameEngine.h"
+#include "GameContext.h"
+#include "ClientInput.h"
+#include "ClientConnection.h"
+#include "SessionTable.h"
+#include "PlayerData.h"
+#include "PlayingState.h"
+#include "DirtyFlagComponents.h"
+#include "Registry.h"
+#include "TickProfiler.h"
+#include "TickScheduler.h"
+#include "LatencyHistogram.h"
+#include "AuthService.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+
+// Every heap allocation made by the process is counted here, so the report can
+// show allocations per tick. Aligned overloads are left to the runtime.
+static std::atomic<uint64_t> allocationCount{ 0 };
+static std::atomic<uint64_t> allocatedBytes{ 0 };
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, size_t) noexcept { std::free(block); }
+void operator delete[](void* block, size_t) noexcept { std::free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { std::free(block); }
+
+// Used when no --script is given: a walk around the start of floor1 with some
+// talking and fighting on the way.
+static const char* DEFAULT_SCRIPT[] = {
+    "say hello",
+    "north",
+    "attack goblin grunt",
+    "south",
+    "east",
+    "say anyone here?",
+    "west",
+    "attack goblin grunt",
+};
+
+struct SimClient {
+    ClientConnection* connection = nullptr;
+    size_t nextCommand = 0;
+    bool open = true;
+};
+
+// FNV-1a over everything the clients received, in client order each tick.
+static uint64_t HashBytes(uint64_t hash, const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool LoadScript(const std::string& path, std::vector<std::string>& commands) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        // Blank lines and # comments are skipped
+        if (line.empty() || line[0] == '#') continue;
+        commands.push_back(line);
+    }
+    return !commands.empty();
+}
+
+struct SimOptions {
+    int clientCount = 50;
+    int tickCount = 3000;
+    int warmupTicks = 100;
+    int tickRate = 30;
+    int commandInterval = 5;
+    int systemThreads = 0;
+    uint32_t seed = 1;
+    std::string region = "floor1";
+    int roomId = 1;
+    std::string sourceDatabase = "mud.db";
+    std::string databasePath = "sim.db";
+    std::string scriptPath;
+    std::string replayPath;
+    bool pacedReplay = false;
+    std::string timingsPath;
+    std::string comparePath;
+    double maxRegression = 0;     // Percent the p99 tick may grow against --compare
+    std::string tracePath;
+    std::string expectDigest;
+    double minTicksPerSecond = 0;
+    bool showProfile = false;
+};
+
+struct SimResult {
+    int ticks = 0;
+    double seconds = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t commands = 0;
+    uint64_t outputBytes = 0;
+    uint64_t digest = 14695981039346656037ull;
+};
+
+// Stand-in for the network thread: takes everything released this tick.
+static void DrainOutput(ClientConnection* connection, SimResult& result) {
+    size_t drained;
+    do {
+        drained = 0;
+        connection->GatherOutput(64, [&](const char* data, size_t length) {
+            result.digest = HashBytes(result.digest, data, length);
+            drained += length;
+            });
+        connection->ConsumeOutput(drained);
+        result.outputBytes += drained;
+    } while (drained > 0);
+}
+
+static void StartMeasuring(SimResult& result, std::chrono::steady_clock::time_point& start) {
+    result.allocations = allocationCount.load(std::memory_order_relaxed);
+    result.allocatedBytes = allocatedBytes.load(std::memory_order_relaxed);
+    start = std::chrono::steady_clock::now();
+}
+
+static void StopMeasuring(SimResult& result, std::chrono::steady_clock::time_point start) {
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = allocationCount.load(std::memory_order_relaxed) - result.allocations;
+    result.allocatedBytes = allocatedBytes.load(std::memory_order_relaxed) - result.allocatedBytes;
+}
+
+// N synthetic players running the command script.
+static bool RunScripted(GameContext& ctx, GameEngine& engine, MpscQueue<ClientInput>& inputQueue,
+    const SimOptions& options, SimResult& result) {
+    std::vector<std::string> script;
+    if (options.scriptPath.empty()) {
+        script.assign(std::begin(DEFAULT_SCRIPT), std::end(DEFAULT_SCRIPT));
+    }
+    else if (!LoadScript(options.scriptPath, script)) {
+        printf("[Sim] Could not read any commands from %s\n", options.scriptPath.c_str());
+        return false;
+    }
+
+    // Synthetic clients skip the menu and AuthService and enter the world the way
+    // a finished login does. Negative account ids match no row, so the periodic
+    // saves write nothing even in the copied database.
+    std::vector<SimClient> clients(options.clientCount);
+    for (int i = 0; i < options.clientCount; i++) {
+        ClientConnection* connection = new ClientConnection(INVALID_SOCKET);
+        connection->SetEngine(&engine);
+        connection->clientID = ctx.sessions->Open(connection);
+
+        PlayerData data;
+        data.id = -(i + 1);
+        data.name = "Sim" + std::to_string(i + 1);
+        data.region = options.region;
+        data.room_id = options.roomId;
+        data.x = 0;
+        data.y = 0;
+        data.stats = nlohmann::json::object();
+        connection->playerEntityID = engine.SpawnPlayer(connection, data);
+        ctx.registry->AddComponent<PlayerLoginComponent>(connection->playerEntityID);
+        connection->PushState(new PlayingState(ctx));
+
+        clients[i].connection = connection;
+        clients[i].nextCommand = i % script.size();
+    }
+
+    float step = 1.0f / options.tickRate;
+    auto start = std::chrono::steady_clock::now();
+    int totalTicks = options.warmupTicks + options.tickCount;
+    for (int tick = 0; tick < totalTicks && engine.IsRunning(); tick++) {
+        if (tick == options.warmupTicks) {
+            StartMeasuring(result, start);
+        }
+
+        // Clients take turns by index, so only 1/K of them send on any one tick
+        for (int i = 0; i < options.clientCount; i++) {
+            SimClient& client = clients[i];
+            if (!client.open || (tick + i) % options.commandInterval != 0) continue;
+            inputQueue.TryPush(ClientInput{ client.connection->clientID, script[client.nextCommand] });
+            client.nextCommand = (client.nextCommand + 1) % script.size();
+            result.commands++;
+        }
+
+        engine.ProcessInputs();
+        engine.Update(step);
+        if (tick >= options.warmupTicks) result.ticks++;
+
+        for (SimClient& client : clients) {
+            if (!client.open) continue;
+            DrainOutput(client.connection, result);
+            // "quit" in a script ends that client's session
+            if (client.connection->needsCleanup || client.connection->evicted) {
+                ctx.sessions->Retire(client.connection);
+                client.open = false;
+            }
+        }
+    }
+    StopMeasuring(result, start);
+
+    // Let the engine tear the sessions down on its own thread, as it does for real disconnects
+    for (SimClient& client : clients) {
+        if (client.open) ctx.sessions->Retire(client.connection);
+    }
+    engine.ProcessInputs();
+    return true;
+}
+
+// Feeds an InputRecorder file back through the engine, tick for tick. Recorded
+// sessions become synthetic connections that start at the main menu, so logins
+// and character creation run again against the copied database.
+static bool RunReplay(GameContext& ctx, GameEngine& engine, MpscQueue<ClientInput>& inputQueue,
+    const SimOptions& options, SimResult& result, std::vector<uint32_t>& tickMicros) {
+    InputRecordingReader reader;
+    if (!reader.Open(options.replayPath)) {
+        printf("[Replay] %s is not an input recording\n", options.replayPath.c_str());
+        return false;
+    }
+    const InputRecord* first = reader.Peek();
+    if (!first) {
+        printf("[Replay] %s has no records\n", options.replayPath.c_str());
+        return false;
+    }
+
+    // Logins go through AuthService as they did live. The replay waits for it
+    // after every tick, so a result always lands on the following tick.
+    ctx.auth->Start(1);
+
+    // Ordered, so output is drained (and hashed) in the same order every run
+    std::map<uint32_t, ClientConnection*> sessions;
+    TickScheduler scheduler(reader.TickRate());
+    float step = scheduler.StepSeconds();
+    uint64_t dropped = 0;
+    InputRecord record;
+
+    auto start = std::chrono::steady_clock::now();
+    StartMeasuring(result, start);
+    for (uint64_t tick = first->tick; reader.Peek() && engine.IsRunning(); tick++) {
+        while (const InputRecord* next = reader.Peek()) {
+            if (next->tick != tick) break;
+            reader.Next(record);
+
+            auto it = sessions.find(record.session);
+            switch (record.type) {
+            case InputRecord::Type::Open: {
+                ClientConnection* connection = new ClientConnection(INVALID_SOCKET);
+                connection->SetEngine(&engine);
+                connection->clientID = ctx.sessions->Open(connection);
+                sessions[record.session] = connection;
+                break;
+            }
+            case InputRecord::Type::Close:
+                if (it != sessions.end()) {
+                    ctx.sessions->Retire(it->second);
+                    sessions.erase(it);
+                }
+                break;
+            case InputRecord::Type::Input:
+                // Input for a session that already closed is dropped by the engine, as it was live
+                if (!inputQueue.TryPush(ClientInput{ it != sessions.end() ? it->second->clientID : INVALID_SESSION, record.text })) {
+                    dropped++;
+                }
+                result.commands++;
+                break;
+            }
+        }
+
+        if (options.pacedReplay) {
+            scheduler.WaitForNextTick();
+            scheduler.BeginTick();
+        }
+        auto tickStart = std::chrono::steady_clock::now();
+        engine.ProcessInputs();
+        engine.Update(step);
+        tickMicros.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count()));
+        if (options.pacedReplay) {
+            scheduler.EndTick();
+        }
+        result.ticks++;
+
+        for (auto session = sessions.begin(); session != sessions.end();) {
+            ClientConnection* connection = session->second;
+            DrainOutput(connection, result);
+            // A replayed "quit" closes the session here; the recorded close that follows is ignored
+            if (connection->needsCleanup || connection->evicted) {
+                ctx.sessions->Retire(connection);
+                session = sessions.erase(session);
+            }
+            else {
+                ++session;
+            }
+        }
+        ctx.auth->WaitIdle();
+    }
+    StopMeasuring(result, start);
+
+    if (dropped > 0) {
+        printf("[Replay] %llu inputs did not fit the input queue\n", (unsigned long long)dropped);
+    }
+    for (auto& session : sessions) {
+        ctx.sessions->Retire(session.second);
+    }
+    engine.ProcessInputs();
+    return true;
+}
+
+// One line per replayed tick: "<tick> <microseconds>", ticks counted from the
+// first recorded one, so files from two builds line up.
+static bool WriteTimings(const std::string& path, const std::vector<uint32_t>& tickMicros) {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << "# tick micros\n";
+    for (size_t i = 0; i < tickMicros.size(); i++) {
+        file << i << ' ' << tickMicros[i] << '\n';
+    }
+    return file.good();
+}
+
+static bool ReadTimings(const std::string& path, std::vector<uint32_t>& tickMicros) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        size_t tick = 0;
+        uint32_t micros = 0;
+        if (!(fields >> tick >> micros)) continue;
+        if (tick >= tickMicros.size()) tickMicros.resize(tick + 1, 0);
+        tickMicros[tick] = micros;
+    }
+    return true;
+}
+
+// Prints how this run's ticks compare with a baseline timings file from another
+// build. Returns false if the p99 grew by more than maxRegression percent.
+static bool CompareTimings(const std::string& path, const std::vector<uint32_t>& current, double maxRegression) {
+    std::vector<uint32_t> baseline;
+    if (!ReadTimings(path, baseline)) {
+        printf("[Replay] Could not read baseline timings %s\n", path.c_str());
+        return false;
+    }
+
+    size_t common = std::min(baseline.size(), current.size());
+    if (common != baseline.size() || common != current.size()) {
+        printf("[Replay] Baseline has %zu ticks, this run %zu; comparing the first %zu\n", baseline.size(), current.size(), common);
+    }
+    LatencyHistogram before, after;
+    std::vector<std::pair<int64_t, size_t>> deltas;
+    deltas.reserve(common);
+    for (size_t i = 0; i < common; i++) {
+        before.Record(baseline[i]);
+        after.Record(current[i]);
+        deltas.emplace_back((int64_t)current[i] - (int64_t)baseline[i], i);
+    }
+
+    printf("[Replay] %-9s %10s %10s %10s %10s\n", "us", "mean", "p50", "p99", "max");
+    printf("[Replay] %-9s %10.1f %10llu %10llu %10llu\n", "baseline", before.MeanMicros(),
+        (unsigned long long)before.Percentile(50), (unsigned long long)before.Percentile(99), (unsigned long long)before.MaxMicros());
+    printf("[Replay] %-9s %10.1f %10llu %10llu %10llu\n", "this run", after.MeanMicros(),
+        (unsigned long long)after.Percentile(50), (unsigned long long)after.Percentile(99), (unsigned long long)after.MaxMicros());
+
+    // The ticks that got slower by the most, for looking up in the profiler trace
+    size_t shown = std::min<size_t>(10, deltas.size());
+    std::partial_sort(deltas.begin(), deltas.begin() + shown, deltas.end(),
+        [](const std::pair<int64_t, size_t>& a, const std::pair<int64_t, size_t>& b) { return a.first > b.first; });
+    for (size_t i = 0; i < shown && deltas[i].first > 0; i++) {
+        size_t tick = deltas[i].second;
+        printf("[Replay] tick %zu: %u us -> %u us (+%lld)\n", tick, baseline[tick], current[tick], (long long)deltas[i].first);
+    }
+
+    double before99 = (double)before.Percentile(99);
+    double growth = before99 > 0 ? ((double)after.Percentile(99) - before99) * 100.0 / before99 : 0.0;
+    printf("[Replay] p99 %+.1f%% against the baseline\n", growth);
+    if (maxRegression > 0 && growth > maxRegression) {
+        printf("[Replay] FAIL: p99 grew more than %.1f%%\n", maxRegression);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SimOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        // --clients=N logs N synthetic players in (default 50)
+        if (arg.rfind("--clients=", 0) == 0) {
+            options.clientCount = std::max(0, std::atoi(arg.substr(10).c_str()));
+        }
+        // --ticks=M measures M ticks after the warm-up (default 3000)
+        else if (arg.rfind("--ticks=", 0) == 0) {
+            options.tickCount = std::max(1, std::atoi(arg.substr(8).c_str()));
+        }
+        // --warmup=N runs N ticks first that are left out of the numbers (default 100)
+        else if (arg.rfind("--warmup=", 0) == 0) {
+            options.warmupTicks = std::max(0, std::atoi(arg.substr(9).c_str()));
+        }
+        // --tick-rate=N sets the game time each tick advances (1/N s, default 30)
+        else if (arg.rfind("--tick-rate=", 0) == 0) {
+            options.tickRate = std::min(1000, std::max(1, std::atoi(arg.substr(12).c_str())));
+        }
+        // --command-every=K sends each client its next command every K ticks (default 5)
+        else if (arg.rfind("--command-every=", 0) == 0) {
+            options.commandInterval = std::max(1, std::atoi(arg.substr(16).c_str()));
+        }
+        // --system-threads=N runs independent systems on N workers (default 0, in order)
+        else if (arg.rfind("--system-threads=", 0) == 0) {
+            options.systemThreads = std::max(0, std::atoi(arg.substr(17).c_str()));
+        }
+        // --seed=S seeds loot rolls and Lua's math.random (default 1)
+        else if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(arg.substr(7).c_str(), nullptr, 10));
+        }
+        // --region=NAME and --room=ID set where the clients spawn (default floor1, room 1)
+        else if (arg.rfind("--region=", 0) == 0) {
+            options.region = arg.substr(9);
+        }
+        else if (arg.rfind("--room=", 0) == 0) {
+            options.roomId = std::atoi(arg.substr(7).c_str());
+        }
+        // --database=FILE is copied to sim.db before the run, so saves never touch it (default mud.db)
+        else if (arg.rfind("--database=", 0) == 0) {
+            options.sourceDatabase = arg.substr(11);
+        }
+        // --script=FILE: one command per line; client i starts at line i so they spread out
+        else if (arg.rfind("--script=", 0) == 0) {
+            options.scriptPath = arg.substr(9);
+        }
+        // --replay=FILE runs a recording from the server's --record instead of
+        // scripted clients, as fast as possible or, with --paced, at its tick rate
+        else if (arg.rfind("--replay=", 0) == 0) {
+            options.replayPath = arg.substr(9);
+        }
+        else if (arg == "--paced") {
+            options.pacedReplay = true;
+        }
+        // --timings=FILE saves the replay's per-tick times; --compare=FILE diffs
+        // them against another build's, and --max-regression=PCT fails on a slower p99
+        else if (arg.rfind("--timings=", 0) == 0) {
+            options.timingsPath = arg.substr(10);
+        }
+        else if (arg.rfind("--compare=", 0) == 0) {
+            options.comparePath = arg.substr(10);
+        }
+        else if (arg.rfind("--max-regression=", 0) == 0) {
+            options.maxRegression = std::atof(arg.substr(17).c_str());
+        }
+        // --profile prints the TickProfiler table; --trace=FILE writes its Chrome trace
+        else if (arg == "--profile") {
+            options.showProfile = true;
+        }
+        else if (arg.rfind("--trace=", 0) == 0) {
+            options.tracePath = arg.substr(8);
+        }
+        // Regression gates: a different output digest or fewer ticks/sec exits with 1
+        else if (arg.rfind("--expect-digest=", 0) == 0) {
+            options.expectDigest = arg.substr(16);
+        }
+        else if (arg.rfind("--min-tps=", 0) == 0) {
+            options.minTicksPerSecond = std::atof(arg.substr(10).c_str());
+        }
+        else {
+            printf("[Sim] Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+    bool replay = !options.replayPath.empty();
+
+    std::error_code copyError;
+    std::filesystem::copy_file(options.sourceDatabase, options.databasePath, std::filesystem::copy_options::overwrite_existing, copyError);
+    if (copyError) {
+        printf("[Sim] Could not copy %s to %s: %s\n", options.sourceDatabase.c_str(), options.databasePath.c_str(), copyError.message().c_str());
+        return 2;
+    }
+
+    GameContext ctx;
+    // Scripted clients queue at most one command each per tick; a recording
+    // can hold a whole busy tick of input
+    MpscQueue<ClientInput> inputQueue(replay ? 65536 : std::max(4096, options.clientCount * 2));
+    GameEngine engine(ctx, inputQueue, options.databasePath);
+    engine.SetSystemThreads(options.systemThreads);
+    engine.SeedRandom(options.seed);
+
+    SimResult result;
+    std::vector<uint32_t> tickMicros;
+    bool ran = replay
+        ? RunReplay(ctx, engine, inputQueue, options, result, tickMicros)
+        : RunScripted(ctx, engine, inputQueue, options, result);
+    if (!ran || result.ticks == 0) return 2;
+
+    double ticksPerSecond = result.seconds > 0 ? result.ticks / result.seconds : 0;
+    char digestText[17];
+    snprintf(digestText, sizeof(digestText), "%016llx", (unsigned long long)result.digest);
+
+    if (replay) {
+        printf("[Sim] Replayed %s: %d ticks%s, seed %u, %d system threads\n", options.replayPath.c_str(),
+            result.ticks, options.pacedReplay ? " at recorded pace" : "", options.seed, options.systemThreads);
+    }
+    else {
+        printf("[Sim] %d clients, %d ticks (+%d warm-up), seed %u, %d system threads\n",
+            options.clientCount, result.ticks, options.warmupTicks, options.seed, options.systemThreads);
+    }
+    printf("[Sim] %.3f s: %.1f ticks/s, %.3f ms/tick\n", result.seconds, ticksPerSecond, result.seconds * 1000.0 / result.ticks);
+    printf("[Sim] %.1f allocations/tick (%.0f bytes/tick)\n",
+        (double)result.allocations / result.ticks, (double)result.allocatedBytes / result.ticks);
+    printf("[Sim] %llu commands, %llu bytes of output, digest %s\n",
+        (unsigned long long)result.commands, (unsigned long long)result.outputBytes, digestText);
+    if (ctx.jobs->WorkerThreads() > 0) {
+        // Systems plus the chunks of parallel loops, warm-up included
+        JobSystem::Stats jobs = ctx.jobs->GetStats();
+        printf("[Sim] %llu jobs, %llu stolen by another thread\n", (unsigned long long)jobs.executed, (unsigned long long)jobs.stolen);
+    }
+    if (options.showProfile) {
+        printf("%s", ctx.profiler->Report().c_str());
+    }
+    if (!options.tracePath.empty() && ctx.profiler->WriteChromeTrace(options.tracePath)) {
+        printf("[Sim] Wrote trace to %s\n", options.tracePath.c_str());
+    }
+
+    int exitCode = 0;
+    if (!options.timingsPath.empty()) {
+        if (WriteTimings(options.timingsPath, tickMicros)) {
+            printf("[Replay] Wrote per-tick timings to %s\n", options.timingsPath.c_str());
+        }
+        else {
+            printf("[Replay] Could not write %s\n", options.timingsPath.c_str());
+        }
+    }
+    if (!options.comparePath.empty() && !CompareTimings(options.comparePath, tickMicros, options.maxRegression)) {
+        exitCode = 1;
+    }
+    if (!options.expectDigest.empty() && options.expectDigest != digestText) {
+        printf("[Sim] FAIL: digest %s, expected %s\n", digestText, options.expectDigest.c_str());
+        exitCode = 1;
+    }
+    if (options.minTicksPerSecond > 0 && ticksPerSecond < options.minTicksPerSecond) {
+        printf("[Sim] FAIL: %.1f ticks/s is under the %.1f minimum\n", ticksPerSecond, options.minTicksPerSecond);
+        exitCode = 1;
+    }
+    return exitCode;
+}
@@ -6,26 +6,11 @@
 #include "SkillContext.h"
 #include "ScriptManager.h"
 #include "CombatIntentComponent.h"
+#include "TimerWheel.h"
 
 
-void SkillSystem::Run(float dt)
+void SkillSystem::Run()
 {
-    // Process all entities with a skill windup.
-    // The view provides a list of entities, which is then used to get the component.
-    for (EntityID entity : ctx.registry->view<SkillWindupComponent>()) {
-        auto* windup = ctx.registry->GetComponent<SkillWindupComponent>(entity);
-        if (!windup) continue;
-
-        windup->timeLeft -= dt;
-
-        if (windup->timeLeft <= 0) {
-            // Windup finished, execute the skill.
-            ExecuteScriptAndDispatch(entity, windup->skillID, windup->targetID);
-            // Remove the component immediately after processing.
-            ctx.registry->RemoveComponent<SkillWindupComponent>(entity);
-        }
-    }
-
     // Process all entities with a skill intent.
     for (EntityID entity : ctx.registry->view<SkillIntentComponent>()) {
         auto* intent = ctx.registry->GetComponent<SkillIntentComponent>(entity);
@@ -49,10 +34,18 @@ void SkillSystem::Run(float dt)
 
             if (windupTime > 0.0f) {
                 // Skill has a windup time, so add the windup component.
-                // The loop above will handle it in subsequent frames.
-                ctx.registry->AddComponent<SkillWindupComponent>(entity, {
-                    windupTime, intent->skillId, intent->targetId
-                });
+                // The timer wheel runs the skill once it is over. A new skill
+                // replaces a windup in progress and cancels its timer.
+                SkillWindupComponent windup{ windupTime, intent->skillId, intent->targetId, TimerHandle() };
+                SkillWindupComponent* pending = ctx.registry->GetComponent<SkillWindupComponent>(entity);
+                if (pending) {
+                    ctx.timers->Cancel(pending->timer);
+                    *pending = windup;
+                }
+                else {
+                    pending = &ctx.registry->AddComponent<SkillWindupComponent>(entity, windup);
+                }
+                pending->timer = ctx.timers->Schedule(TimerWheel::SecondsToMs(windupTime), &SkillSystem::OnWindupDone, this, entity);
             } else {
                 // Instant cast skill.
                 ExecuteScriptAndDispatch(entity, intent->skillId, intent->targetId);
@@ -66,6 +59,19 @@ void SkillSystem::Run(float dt)
     }
 }
 
+void SkillSystem::OnWindupDone(void* context, int entity, TimerHandle handle)
+{
+    SkillSystem& self = *static_cast<SkillSystem*>(context);
+    auto* windup = self.ctx.registry->GetComponent<SkillWindupComponent>(entity);
+    if (!windup || windup->timer != handle) return;
+
+    // Windup finished, execute the skill.
+    int skillID = windup->skillID;
+    int targetID = windup->targetID;
+    // Remove the component before the script runs, which may start another windup.
+    self.ctx.registry->RemoveComponent<SkillWindupComponent>(entity);
+    self.ExecuteScriptAndDispatch(entity, skillID, targetID);
+}
 
 void SkillSystem::ExecuteScriptAndDispatch(int entityID, int skillID, int targetID) {
         auto* scriptComp = ctx.registry->GetComponent<ScriptComponent>(skillID);
@@ -1,6 +1,7 @@
 #pragma once
 #include "GameContext.h"
 #include "SkillContext.h"
+#include "TimerWheel.h"
 
 class SkillSystem
 {
@@ -10,7 +11,7 @@ public:
 	SkillSystem(GameContext& g) : ctx(g) {};
 	~SkillSystem() = default;
 
-	void Run(float dt);
+	void Run();
 
 private:
 
@@ -22,5 +23,7 @@ private:
     void GrantXP(int entityID, int skillID, float amount);
     // The Core Logic
     void ExecuteScriptAndDispatch(int entityID, int skillID, int targetID);
+    // Timer wheel callback for a finished windup.
+    static void OnWindupDone(void* context, int entity, TimerHandle handle);
 
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
+#include "TimerWheel.h"
 struct SkillWindupComponent {
         float timeLeft;
         int skillID;   // The script knows what to do
         int targetID;  // The script knows who to hit/heal
-};
\ No newline at end of file
+        TimerHandle timer;
+};
@@ -0,0 +1,219 @@
+#pragma once
+
+// Thin shim so the networking code can be written once against the Winsock
+// names (SOCKET, INVALID_SOCKET, closesocket) and still build with BSD sockets.
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#undef UNICODE
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+
+using SOCKET = int;
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (-1)
+#endif
+#ifndef SOCKET_ERROR
+#define SOCKET_ERROR (-1)
+#endif
+#ifndef SD_SEND
+#define SD_SEND SHUT_WR
+#endif
+
+inline int closesocket(SOCKET s) { return close(s); }
+#endif
+
+namespace SocketPlatform {
+
+    // Flags for every send(): never let a dead peer raise SIGPIPE on Linux.
+#ifdef _WIN32
+    const int SEND_FLAGS = 0;
+#else
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+    // Call once before any socket is created / after the last one is closed.
+    inline bool Startup() {
+#ifdef _WIN32
+        WSADATA wsaData;
+        return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+#else
+        return true;
+#endif
+    }
+
+    inline void Cleanup() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    inline int LastError() {
+#ifdef _WIN32
+        return WSAGetLastError();
+#else
+        return errno;
+#endif
+    }
+
+    // True if the last failed call only means "try again once the socket is ready".
+    inline bool WouldBlock(int err) {
+#ifdef _WIN32
+        return err == WSAEWOULDBLOCK;
+#else
+        return err == EAGAIN || err == EWOULDBLOCK;
+#endif
+    }
+
+    inline bool Interrupted(int err) {
+#ifdef _WIN32
+        return err == WSAEINTR;
+#else
+        return err == EINTR;
+#endif
+    }
+
+    inline bool SetNonBlocking(SOCKET s) {
+#ifdef _WIN32
+        u_long mode = 1;
+        return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+        int flags = fcntl(s, F_GETFL, 0);
+        if (flags == -1) return false;
+        return fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    }
+
+    // One scatter-gather slice: WSABUF on Winsock, iovec on BSD sockets.
+#ifdef _WIN32
+    using IoSlice = WSABUF;
+#else
+    using IoSlice = struct iovec;
+#endif
+    const int MAX_SEND_SLICES = 64;
+
+    inline void SetSlice(IoSlice& slice, const char* data, size_t length) {
+#ifdef _WIN32
+        slice.buf = const_cast<char*>(data);
+        slice.len = static_cast<ULONG>(length);
+#else
+        slice.iov_base = const_cast<char*>(data);
+        slice.iov_len = length;
+#endif
+    }
+
+    // Writes the slices with a single call. Returns bytes sent or SOCKET_ERROR.
+    inline int SendSlices(SOCKET s, IoSlice* slices, int count) {
+#ifdef _WIN32
+        DWORD sent = 0;
+        if (WSASend(s, slices, static_cast<DWORD>(count), &sent, 0, NULL, NULL) == SOCKET_ERROR) {
+            return SOCKET_ERROR;
+        }
+        return static_cast<int>(sent);
+#else
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = slices;
+        msg.msg_iovlen = static_cast<size_t>(count);
+        return static_cast<int>(sendmsg(s, &msg, SEND_FLAGS));
+#endif
+    }
+
+    // Lets several listen sockets share one port, with the kernel spreading new
+    // connections across them. Returns false where SO_REUSEPORT does not exist.
+    inline bool SetReusePort(SOCKET s) {
+#ifdef SO_REUSEPORT
+        int reuse = 1;
+        return setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) == 0;
+#else
+        (void)s;
+        return false;
+#endif
+    }
+
+    // accept() that hands back an already non-blocking socket. On Linux accept4
+    // sets the flag in the same call; elsewhere it costs one more call.
+    inline SOCKET Accept(SOCKET listener, sockaddr_storage& peer) {
+        socklen_t length = sizeof(peer);
+#ifdef __linux__
+        return accept4(listener, reinterpret_cast<sockaddr*>(&peer), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        SOCKET s = accept(listener, reinterpret_cast<sockaddr*>(&peer), &length);
+        if (s != INVALID_SOCKET) SetNonBlocking(s);
+        return s;
+#endif
+    }
+
+    inline bool PeerAddress(SOCKET s, sockaddr_storage& peer) {
+        socklen_t length = sizeof(peer);
+        return getpeername(s, reinterpret_cast<sockaddr*>(&peer), &length) == 0;
+    }
+
+    inline bool HasReusePort() {
+#ifdef SO_REUSEPORT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Turns Nagle off. Output is already batched into one flush per tick, so
+    // holding back its last partial segment would only add latency.
+    inline bool SetNoDelay(SOCKET s) {
+        int on = 1;
+        return setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on)) == 0;
+    }
+
+    // While corked the kernel only sends full segments, and uncorking sends the
+    // remainder. Used around flushes that need more than one send call. Where
+    // TCP_CORK doesn't exist this returns false and the single gathered send per
+    // call has to do.
+    inline bool SetCork(SOCKET s, bool on) {
+#ifdef TCP_CORK
+        int value = on ? 1 : 0;
+        return setsockopt(s, IPPROTO_TCP, TCP_CORK, &value, sizeof(value)) == 0;
+#else
+        (void)s;
+        (void)on;
+        return false;
+#endif
+    }
+
+    // Data-carrying TCP segments sent on this socket so far (Linux 4.6+ TCP_INFO).
+    // glibc's tcp_info stops before this field, so the kernel layout is spelled out.
+    inline bool DataSegmentsSent(SOCKET s, uint64_t& segments) {
+#ifdef __linux__
+        struct KernelTcpInfo {
+            struct tcp_info base;
+            uint64_t pacingRate, maxPacingRate, bytesAcked, bytesReceived;
+            uint32_t segsOut, segsIn, notsentBytes, minRtt, dataSegsIn, dataSegsOut;
+        } info;
+        socklen_t length = sizeof(info);
+        memset(&info, 0, sizeof(info));
+        if (getsockopt(s, IPPROTO_TCP, TCP_INFO, &info, &length) != 0) return false;
+        if (length < offsetof(KernelTcpInfo, dataSegsOut) + sizeof(uint32_t)) return false;
+        segments = info.dataSegsOut;
+        return true;
+#else
+        (void)s;
+        (void)segments;
+        return false;
+#endif
+    }
+}
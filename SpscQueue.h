@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief Lock-free single-producer / single-consumer queue made of fixed ring blocks.
+ *
+ * One thread calls Push, one other thread calls TryPop/IsEmpty. Items are
+ * written into a block of BlockSize slots. When a block fills, the producer
+ * links a fresh one instead of blocking or dropping, so a burst bigger than one
+ * block (a long room render) is never lost. The consumer frees a block once it
+ * has read past it. Neither side ever takes a lock.
+ */
+template<typename T, size_t BlockSize = 64>
+class SpscQueue {
+public:
+    SpscQueue() {
+        producerBlock = consumerBlock = new Block();
+    }
+
+    ~SpscQueue() {
+        Block* block = consumerBlock;
+        while (block) {
+            Block* next = block->next.load(std::memory_order_relaxed);
+            delete block;
+            block = next;
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer thread only.
+    void Push(T item) {
+        size_t tail = producerBlock->tail.load(std::memory_order_relaxed);
+        if (tail == BlockSize) {
+            Block* fresh = new Block();
+            producerBlock->next.store(fresh, std::memory_order_release);
+            producerBlock = fresh;
+            tail = 0;
+        }
+        producerBlock->items[tail] = std::move(item);
+        producerBlock->tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // Consumer thread only.
+    bool TryPop(T& out) {
+        while (true) {
+            if (consumerBlock->head < consumerBlock->tail.load(std::memory_order_acquire)) {
+                out = std::move(consumerBlock->items[consumerBlock->head++]);
+                return true;
+            }
+            if (consumerBlock->head < BlockSize) {
+                return false;
+            }
+            // Block fully read; move on once the producer has linked the next one.
+            Block* next = consumerBlock->next.load(std::memory_order_acquire);
+            if (!next) {
+                return false;
+            }
+            delete consumerBlock;
+            consumerBlock = next;
+        }
+    }
+
+    // Consumer thread only.
+    bool IsEmpty() const {
+        const Block* block = consumerBlock;
+        if (block->head < block->tail.load(std::memory_order_acquire)) return false;
+        const Block* next = block->head == BlockSize ? block->next.load(std::memory_order_acquire) : nullptr;
+        return next == nullptr || next->tail.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    struct Block {
+        T items[BlockSize];
+        std::atomic<size_t> tail{ 0 };      // Written by the producer
+        size_t head = 0;                    // Consumer only
+        std::atomic<Block*> next{ nullptr };
+    };
+
+    alignas(64) Block* producerBlock;
+    alignas(64) Block* consumerBlock;
+};
@@ -0,0 +1,138 @@
+#include "SystemScheduler.h"
+#include "TickProfiler.h"
+#include <algorithm>
+#include <cstdio>
+
+static const uint32_t RUNS_ALONE_RESOURCES = static_cast<uint32_t>(SystemResource::Entities)
+    | static_cast<uint32_t>(SystemResource::Events)
+    | static_cast<uint32_t>(SystemResource::Scripts);
+
+static bool Intersects(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b) {
+    for (const std::type_index& type : a) {
+        if (std::find(b.begin(), b.end(), type) != b.end()) return true;
+    }
+    return false;
+}
+
+bool SystemAccess::RunsAlone() const {
+    return (resources & RUNS_ALONE_RESOURCES) != 0;
+}
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const {
+    if (RunsAlone() || other.RunsAlone()) return true;
+    if (resources & other.resources) return true;
+    // Reading alongside a read is fine; anything involving a write is not.
+    return Intersects(writes, other.writes) || Intersects(writes, other.reads) || Intersects(reads, other.writes);
+}
+
+void SystemAccess::PreparePools(Registry& registry) const {
+    for (void (*prepare)(Registry&) : preparers) {
+        prepare(registry);
+    }
+}
+
+SystemScheduler::SystemScheduler(Registry& registry, JobSystem& jobs) : registry(registry), jobs(jobs) {
+}
+
+void SystemScheduler::Add(const std::string& name, const SystemAccess& access, std::function<void(float)> run) {
+    access.PreparePools(registry);
+    Node node;
+    node.name = name;
+    node.access = access;
+    node.run = std::move(run);
+    if (profiler) node.profileName = profiler->Intern(name);
+    nodes.push_back(std::move(node));
+    graphDirty = true;
+}
+
+void SystemScheduler::BuildGraph() {
+    graphDirty = false;
+    for (Node& node : nodes) {
+        node.dependents.clear();
+        node.dependencies = 0;
+        node.stage = 0;
+    }
+    // Added order is the reference order: a later system waits for every
+    // earlier one it conflicts with.
+    for (size_t later = 0; later < nodes.size(); later++) {
+        for (size_t earlier = 0; earlier < later; earlier++) {
+            if (nodes[later].access.ConflictsWith(nodes[earlier].access)) {
+                nodes[earlier].dependents.push_back(later);
+                nodes[later].dependencies++;
+                nodes[later].stage = (std::max)(nodes[later].stage, nodes[earlier].stage + 1);
+            }
+        }
+    }
+    waitingOn = std::vector<std::atomic<int>>(nodes.size());
+}
+
+void SystemScheduler::Run(float deltaTime) {
+    if (graphDirty) BuildGraph();
+
+    if (jobs.WorkerThreads() == 0) {
+        for (Node& node : nodes) {
+            ProfileScope scope(profiler, node.profileName);
+            node.run(deltaTime);
+        }
+        return;
+    }
+
+    tickDelta = deltaTime;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        waitingOn[i].store(nodes[i].dependencies, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].dependencies == 0) SubmitNode(i);
+    }
+    jobs.Wait(tick);
+}
+
+void SystemScheduler::SubmitNode(size_t index) {
+    Job job;
+    job.run = &SystemScheduler::RunNode;
+    job.data = this;
+    job.begin = index;
+    job.group = &tick;
+    jobs.Submit(job);
+}
+
+void SystemScheduler::RunNode(void* data, size_t index, size_t) {
+    SystemScheduler& scheduler = *static_cast<SystemScheduler*>(data);
+    Node& node = scheduler.nodes[index];
+
+    // Dependents are released even if the system threw, so the tick still
+    // finishes and Wait can report the exception.
+    struct Release {
+        SystemScheduler& scheduler;
+        Node& node;
+        ~Release() {
+            for (size_t dependent : node.dependents) {
+                if (scheduler.waitingOn[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    scheduler.SubmitNode(dependent);
+                }
+            }
+        }
+    } release{ scheduler, node };
+
+    ProfileScope scope(scheduler.profiler, node.profileName);
+    node.run(scheduler.tickDelta);
+}
+
+void SystemScheduler::LogGraph() {
+    if (graphDirty) BuildGraph();
+
+    int stages = 0;
+    for (const Node& node : nodes) {
+        stages = (std::max)(stages, node.stage + 1);
+    }
+    printf("[Systems] %zu systems in %d stages, %d worker threads\n", nodes.size(), stages, jobs.WorkerThreads());
+    for (int stage = 0; stage < stages; stage++) {
+        std::string line;
+        for (const Node& node : nodes) {
+            if (node.stage != stage) continue;
+            if (!line.empty()) line += ", ";
+            line += node.name;
+        }
+        printf("[Systems]   %d: %s\n", stage, line.c_str());
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include "JobSystem.h"
+#include "Registry.h"
+
+class TickProfiler;
+
+// State outside the component pools that a system may touch. Two systems that
+// use the same resource never run at the same time.
+enum class SystemResource : uint32_t {
+    World = 1 << 0,      // WorldManager rooms and exits
+    Output = 1 << 1,     // Client output queues (one producer per connection) and MessageSystem's room/channel lists
+    Database = 1 << 2,   // The game thread's SQLite connection
+    Timers = 1 << 6,     // Schedules or cancels on the timer wheel
+    // The resources below can reach any state, so a system using one runs alone.
+    Entities = 1 << 3,   // Creates or destroys entities (including through factories)
+    Events = 1 << 4,     // Publishes on the EventBus; subscribers run synchronously
+    Scripts = 1 << 5     // Runs Lua
+};
+
+/**
+ * @class SystemAccess
+ * @brief What one system reads and writes, declared up front.
+ *
+ * Writes<T> covers changing a T and adding or removing T components; Reads<T>
+ * is lookups and iteration only. Declaring a type also creates its pool, since
+ * pools can only be looked up concurrently once they exist.
+ */
+class SystemAccess {
+public:
+    template<typename... T>
+    SystemAccess& Reads() { (Declare<T>(reads), ...); return *this; }
+    template<typename... T>
+    SystemAccess& Writes() { (Declare<T>(writes), ...); return *this; }
+    SystemAccess& Uses(SystemResource resource) { resources |= static_cast<uint32_t>(resource); return *this; }
+
+    bool RunsAlone() const;
+    bool ConflictsWith(const SystemAccess& other) const;
+    void PreparePools(Registry& registry) const;
+
+private:
+    template<typename T>
+    static void PreparePool(Registry& registry) { registry.EnsurePool<T>(); }
+
+    template<typename T>
+    void Declare(std::vector<std::type_index>& set) {
+        set.push_back(std::type_index(typeid(T)));
+        preparers.push_back(&PreparePool<T>);
+    }
+
+    std::vector<std::type_index> reads;
+    std::vector<std::type_index> writes;
+    std::vector<void(*)(Registry&)> preparers;
+    uint32_t resources = 0;
+};
+
+/**
+ * @class SystemScheduler
+ * @brief Runs the tick's systems, overlapping those whose declared access doesn't conflict.
+ *
+ * Systems are added in their sequential order. Each one depends on every
+ * earlier system it conflicts with, so any two systems that share data still
+ * run in the order they were added. The result is the same as running the list
+ * one by one. The graph is rebuilt only when a system is added.
+ *
+ * Each tick, a system is submitted to the JobSystem as soon as everything it
+ * depends on has finished. The game thread helps run jobs while it waits for
+ * the tick. With no workers, the list runs in order on the game thread. That mode is deterministic and meant for debugging.
+ */
+class SystemScheduler {
+public:
+    SystemScheduler(Registry& registry, JobSystem& jobs);
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    void Add(const std::string& name, const SystemAccess& access, std::function<void(float)> run);
+
+    // Times each system under its name. Set before adding systems.
+    void SetProfiler(TickProfiler* profiler) { this->profiler = profiler; }
+
+    // Game thread. Rethrows the first exception a system threw, once all have finished.
+    void Run(float deltaTime);
+
+    // One line per stage: the systems that may overlap at that point of the tick.
+    void LogGraph();
+
+private:
+    struct Node {
+        std::string name;
+        SystemAccess access;
+        std::function<void(float)> run;
+        std::vector<size_t> dependents;
+        int dependencies = 0;
+        int stage = 0;            // Longest chain of dependencies before it
+        uint16_t profileName = 0;
+    };
+
+    void BuildGraph();
+    void SubmitNode(size_t index);
+    static void RunNode(void* data, size_t index, size_t);
+
+    Registry& registry;
+    JobSystem& jobs;
+    std::vector<Node> nodes;
+    bool graphDirty = false;
+    TickProfiler* profiler = nullptr;
+
+    // Per tick
+    JobGroup tick;
+    std::vector<std::atomic<int>> waitingOn;
+    float tickDelta = 0.0f;
+};
@@ -0,0 +1,151 @@
+#include "TelnetProtocol.h"
+
+using namespace Telnet;
+
+TelnetSession::TelnetSession(const TelnetConfig& config) : config(config) {
+}
+
+TelnetSession::~TelnetSession() {
+}
+
+std::string TelnetSession::InitialNegotiation() const {
+    std::string offers;
+    if (config.enableCompression) {
+        offers += { (char)IAC, (char)WILL, (char)OPT_MCCP2 };
+    }
+    offers += { (char)IAC, (char)WILL, (char)OPT_GMCP };
+    offers += { (char)IAC, (char)DO, (char)OPT_NAWS };
+    return offers;
+}
+
+size_t TelnetSession::FilterInput(char* data, size_t length, std::string& replies) {
+    size_t out = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+
+        switch (state) {
+        case State::Data:
+            if (c == IAC) {
+                state = State::Iac;
+            }
+            else if (c != 0) {  // Telnet pads CR with NUL; drop it
+                data[out++] = static_cast<char>(c);
+            }
+            break;
+
+        case State::Iac:
+            switch (c) {
+            case IAC: data[out++] = static_cast<char>(c); state = State::Data; break;  // Escaped 255
+            case WILL: state = State::Will; break;
+            case WONT: state = State::Wont; break;
+            case DO: state = State::Do; break;
+            case DONT: state = State::Dont; break;
+            case SB:
+                state = State::Sb;
+                subnegotiation.clear();
+                subnegotiationOverflow = false;
+                break;
+            default: state = State::Data; break;  // NOP, GA, AYT...: nothing to do
+            }
+            break;
+
+        case State::Will:
+        case State::Wont:
+        case State::Do:
+        case State::Dont: {
+            unsigned char command = state == State::Will ? WILL : state == State::Wont ? WONT : state == State::Do ? DO : DONT;
+            HandleNegotiation(command, c, replies);
+            state = State::Data;
+            break;
+        }
+
+        case State::Sb:
+        case State::SbData:
+            if (c == IAC) {
+                state = State::SbIac;
+            }
+            else if (subnegotiation.size() < MAX_SUBNEGOTIATION) {
+                subnegotiation.push_back(static_cast<char>(c));
+                state = State::SbData;
+            }
+            else {
+                subnegotiationOverflow = true;
+            }
+            break;
+
+        case State::SbIac:
+            if (c == SE) {
+                if (!subnegotiationOverflow) {
+                    HandleSubnegotiation();
+                }
+                state = State::Data;
+            }
+            else if (c == IAC) {
+                if (subnegotiation.size() < MAX_SUBNEGOTIATION) subnegotiation.push_back(static_cast<char>(c));
+                state = State::SbData;
+            }
+            else {
+                state = State::SbData;  // Malformed; keep looking for IAC SE
+            }
+            break;
+        }
+    }
+
+    return out;
+}
+
+void TelnetSession::HandleNegotiation(unsigned char command, unsigned char option, std::string& replies) {
+    // Options we offered answer with DO/DONT; options we asked for answer with
+    // WILL/WONT. Anything else is refused once, so negotiations can't loop.
+    switch (option) {
+    case OPT_MCCP2:
+        if (command == DO && config.enableCompression && !IsCompressing()) {
+            compressionStartRequested = true;
+        }
+        else if (command == DONT && IsCompressing()) {
+            compressionStopRequested = true;
+        }
+        else if (command == DO && !config.enableCompression) {
+            replies += { (char)IAC, (char)WONT, (char)option };
+        }
+        return;
+
+    case OPT_GMCP:
+        if (command == DO) gmcp = true;
+        else if (command == DONT) gmcp = false;
+        return;
+
+    case OPT_NAWS:
+        // WILL NAWS is followed by SB NAWS; WONT just means fixed 80x24.
+        return;
+
+    default:
+        if (command == DO) {
+            replies += { (char)IAC, (char)WONT, (char)option };
+        }
+        else if (command == WILL) {
+            replies += { (char)IAC, (char)DONT, (char)option };
+        }
+        return;
+    }
+}
+
+void TelnetSession::HandleSubnegotiation() {
+    if (subnegotiation.empty()) return;
+    unsigned char option = static_cast<unsigned char>(subnegotiation[0]);
+
+    if (option == OPT_NAWS && subnegotiation.size() >= 5) {
+        auto byteAt = [this](size_t i) { return static_cast<uint16_t>(static_cast<unsigned char>(subnegotiation[i])); };
+        width = static_cast<uint16_t>((byteAt(1) << 8) | byteAt(2));
+        height = static_cast<uint16_t>((byteAt(3) << 8) | byteAt(4));
+    }
+    else if (option == OPT_GMCP) {
+        // Client-to-server GMCP (Core.Hello, Core.Supports.Set) needs no reply yet.
+        gmcp = true;
+    }
+}
+
+bool TelnetSession::StartCompression() {
+    return compressor.Init(config.compressionLevel, config.compressionMemory);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "DeflateStream.h"
+
+// Telnet command and option bytes (RFC 854/855, plus the MUD extensions we speak)
+namespace Telnet {
+    const unsigned char IAC = 255;
+    const unsigned char DONT = 254;
+    const unsigned char DO = 253;
+    const unsigned char WONT = 252;
+    const unsigned char WILL = 251;
+    const unsigned char SB = 250;
+    const unsigned char SE = 240;
+
+    const unsigned char OPT_NAWS = 31;     // Window size (RFC 1073)
+    const unsigned char OPT_MCCP2 = 86;    // Compressed output stream
+    const unsigned char OPT_GMCP = 201;    // Generic MUD Communication Protocol
+}
+
+struct TelnetConfig {
+    bool enableCompression = true;
+    int compressionLevel = 6;                 // zlib level, 1 (fast) .. 9 (small)
+    size_t compressionMemory = 48 * 1024;     // deflate state budget per connection
+};
+
+/**
+ * @class TelnetSession
+ * @brief Per-connection telnet state: IAC parser, option negotiation, MCCP2.
+ *
+ * Runs on the network thread. FilterInput strips every telnet command from the
+ * received bytes before they reach the LineFramer and answers negotiations.
+ * It remembers NAWS window sizes and whether the client agreed to GMCP. Once
+ * the client accepts MCCP2, every byte sent afterwards goes through one
+ * DeflateStream, sized to the configured memory budget.
+ */
+class TelnetSession {
+public:
+    explicit TelnetSession(const TelnetConfig& config = TelnetConfig());
+    ~TelnetSession();
+
+    TelnetSession(const TelnetSession&) = delete;
+    TelnetSession& operator=(const TelnetSession&) = delete;
+
+    // The server's opening offers (WILL MCCP2, WILL GMCP, DO NAWS).
+    std::string InitialNegotiation() const;
+
+    // Removes telnet commands from data in place and returns the plain-text
+    // length left. Negotiation replies are appended to 'replies'.
+    size_t FilterInput(char* data, size_t length, std::string& replies);
+
+    // Set when the client just accepted (DO) or refused (DONT) MCCP2. The
+    // connection applies the switch at the right point in its output stream.
+    bool TakeCompressionStart() { bool v = compressionStartRequested; compressionStartRequested = false; return v; }
+    bool TakeCompressionStop() { bool v = compressionStopRequested; compressionStopRequested = false; return v; }
+
+    bool StartCompression();                      // False if zlib can't allocate
+    void StopCompression(std::string& out) { compressor.Finish(out); }
+    bool IsCompressing() const { return compressor.IsOpen(); }
+    // Flush at the end of a batch so the client can render everything sent so far.
+    bool Compress(const char* data, size_t length, bool flush, std::string& out) {
+        return compressor.Compress(data, length, flush, out);
+    }
+    DeflateStream& Compressor() { return compressor; }
+
+    // Read by the game thread
+    bool GmcpEnabled() const { return gmcp.load(std::memory_order_relaxed); }
+    uint16_t WindowWidth() const { return width.load(std::memory_order_relaxed); }
+    uint16_t WindowHeight() const { return height.load(std::memory_order_relaxed); }
+
+private:
+    enum class State { Data, Iac, Will, Wont, Do, Dont, Sb, SbData, SbIac };
+
+    void HandleNegotiation(unsigned char command, unsigned char option, std::string& replies);
+    void HandleSubnegotiation();
+
+    static const size_t MAX_SUBNEGOTIATION = 8192;
+
+    TelnetConfig config;
+    State state = State::Data;
+    std::string subnegotiation;
+    bool subnegotiationOverflow = false;
+
+    bool compressionStartRequested = false;
+    bool compressionStopRequested = false;
+    DeflateStream compressor;
+
+    std::atomic<bool> gmcp{ false };
+    std::atomic<uint16_t> width{ 80 };
+    std::atomic<uint16_t> height{ 24 };
+};
@@ -0,0 +1,152 @@
+#include "TickProfiler.h"
+#include "LatencyHistogram.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+
+namespace {
+    std::atomic<uint16_t> nextThreadId{ 0 };
+}
+
+TickProfiler::TickProfiler(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    ring = std::vector<Sample>(size);
+    mask = size - 1;
+    epochNs = NowNs();
+    Intern("(unnamed)");
+}
+
+int64_t TickProfiler::NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint16_t TickProfiler::ThreadId() {
+    // Small ids in order of first use; the game thread records first
+    thread_local uint16_t id = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+uint16_t TickProfiler::Intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    auto it = nameIds.find(name);
+    if (it != nameIds.end()) return it->second;
+    if (names.size() >= UINT16_MAX) return 0;
+    uint16_t id = (uint16_t)names.size();
+    names.push_back(name);
+    nameIds.emplace(name, id);
+    return id;
+}
+
+uint16_t ProfileNames::Get(TickProfiler& profiler, const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+    uint16_t id = profiler.Intern(prefix + name);
+    ids.emplace(name, id);
+    return id;
+}
+
+std::string TickProfiler::NameOf(uint16_t name) const {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    return name < names.size() ? names[name] : names[0];
+}
+
+void TickProfiler::BeginTick() {
+    tick.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TickProfiler::Record(uint16_t name, int64_t startNs, int64_t endNs) {
+    uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Sample& sample = ring[index & mask];
+    sample.sequence.store(0, std::memory_order_relaxed);
+    sample.data.tick = tick.load(std::memory_order_relaxed);
+    sample.data.startNs = startNs;
+    sample.data.durationNs = endNs - startNs;
+    sample.data.name = name;
+    sample.data.thread = ThreadId();
+    sample.sequence.store(index + 1, std::memory_order_release);
+}
+
+void TickProfiler::Snapshot(std::vector<SampleData>& out) const {
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > ring.size() ? end - ring.size() : 0;
+    out.clear();
+    out.reserve((size_t)(end - begin));
+    for (uint64_t index = begin; index < end; index++) {
+        const Sample& sample = ring[index & mask];
+        if (sample.sequence.load(std::memory_order_acquire) != index + 1) continue;
+        SampleData data = sample.data;
+        // Overwritten while copying
+        if (sample.sequence.load(std::memory_order_acquire) != index + 1) continue;
+        out.push_back(data);
+    }
+}
+
+std::string TickProfiler::Report() const {
+    std::vector<SampleData> samples;
+    Snapshot(samples);
+    if (samples.empty()) return "No samples recorded.\r\n";
+
+    std::unordered_map<uint16_t, LatencyHistogram> byName;
+    for (const SampleData& sample : samples) {
+        byName[sample.name].Record((uint64_t)(std::max)((int64_t)0, sample.durationNs / 1000));
+    }
+
+    std::vector<std::pair<uint16_t, const LatencyHistogram*>> rows;
+    for (const auto& [name, histogram] : byName) {
+        rows.emplace_back(name, &histogram);
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second->Percentile(99) > b.second->Percentile(99);
+    });
+
+    char line[160];
+    snprintf(line, sizeof(line), "Last %llu ticks, %zu samples (times in us)\r\n%-32s %8s %8s %8s %8s\r\n",
+        (unsigned long long)(samples.back().tick - samples.front().tick + 1), samples.size(),
+        "scope", "count", "p50", "p99", "max");
+    std::string out = line;
+    for (const auto& [name, histogram] : rows) {
+        snprintf(line, sizeof(line), "%-32.32s %8llu %8llu %8llu %8llu\r\n", NameOf(name).c_str(),
+            (unsigned long long)histogram->Count(), (unsigned long long)histogram->Percentile(50),
+            (unsigned long long)histogram->Percentile(99), (unsigned long long)histogram->MaxMicros());
+        out += line;
+    }
+    return out;
+}
+
+bool TickProfiler::WriteChromeTrace(const std::string& path, bool replaceExisting) const {
+    // "x" creates the file or fails if it exists, in one step
+    FILE* file = fopen(path.c_str(), replaceExisting ? "wb" : "wbx");
+    if (!file) return false;
+
+    std::ostringstream out;
+    WriteChromeTrace(out);
+    const std::string json = out.str();
+    bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+    return fclose(file) == 0 && written;
+}
+
+void TickProfiler::WriteChromeTrace(std::ostream& file) const {
+    std::vector<SampleData> samples;
+    Snapshot(samples);
+
+    // Complete ("X") events in microseconds; one pid, one tid per thread
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"game\"}}";
+    std::unordered_map<uint16_t, std::string> quoted;
+    char line[256];
+    for (const SampleData& sample : samples) {
+        auto it = quoted.find(sample.name);
+        if (it == quoted.end()) {
+            it = quoted.emplace(sample.name, nlohmann::json(NameOf(sample.name)).dump()).first;
+        }
+        snprintf(line, sizeof(line), ",\"cat\":\"tick\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"tick\":%llu}}",
+            (double)(sample.startNs - epochNs) / 1000.0, (double)sample.durationNs / 1000.0,
+            (unsigned)sample.thread, (unsigned long long)sample.tick);
+        file << ",\n{\"name\":" << it->second << line;
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TickProfiler
+ * @brief Scoped timings of systems, Lua hooks and DB calls, kept for the last few thousand ticks.
+ *
+ * Each ProfileScope costs two steady_clock reads and one slot in a fixed ring
+ * of samples. Any thread can write (systems and loops run on the job workers): a writer
+ * claims a slot with one fetch_add and publishes it with a sequence number,
+ * so there are no locks on the hot path and old samples are simply
+ * overwritten. Report and WriteChromeTrace read the ring between ticks. The
+ * ring is the rolling window for the percentiles.
+ */
+class TickProfiler {
+public:
+    explicit TickProfiler(size_t capacity = 1 << 16);
+
+    // Stable id for a scope name; interning takes a lock, so cache ids on hot paths.
+    uint16_t Intern(const std::string& name);
+
+    // Game thread, once per tick before any scopes.
+    void BeginTick();
+    uint64_t CurrentTick() const { return tick.load(std::memory_order_relaxed); }
+
+    void SetEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void Record(uint16_t name, int64_t startNs, int64_t endNs);
+    static int64_t NowNs();
+
+    // One line per scope name: samples, p50, p99 and max in microseconds, slowest p99 first.
+    std::string Report() const;
+    // Chrome trace-event JSON (chrome://tracing, Perfetto) of every sample in the ring.
+    // With replaceExisting false, fails rather than overwrite a file already at 'path'.
+    bool WriteChromeTrace(const std::string& path, bool replaceExisting = true) const;
+    void WriteChromeTrace(std::ostream& out) const;
+
+private:
+    struct SampleData {
+        uint64_t tick = 0;
+        int64_t startNs = 0;
+        int64_t durationNs = 0;
+        uint16_t name = 0;
+        uint16_t thread = 0;
+    };
+
+    struct Sample {
+        std::atomic<uint64_t> sequence{ 0 };   // Write index + 1 once 'data' is complete
+        SampleData data;
+    };
+
+    // Copies out every complete sample still in the ring, oldest first.
+    void Snapshot(std::vector<SampleData>& out) const;
+    std::string NameOf(uint16_t name) const;
+    static uint16_t ThreadId();
+
+    std::vector<Sample> ring;
+    uint64_t mask;
+    std::atomic<uint64_t> head{ 0 };
+    std::atomic<uint64_t> tick{ 0 };
+    std::atomic<bool> enabled{ true };
+    int64_t epochNs;
+
+    mutable std::mutex namesMutex;
+    std::unordered_map<std::string, uint16_t> nameIds;
+    std::vector<std::string> names;
+};
+
+// Ids for names under one prefix, interned on first use. A repeated name then
+// costs one hash lookup, with no string build and no names lock. Not
+// synchronized: each owner must only use it from one thread at a time.
+class ProfileNames {
+public:
+    explicit ProfileNames(const char* prefix) : prefix(prefix) {}
+    uint16_t Get(TickProfiler& profiler, const std::string& name);
+
+private:
+    const char* prefix;
+    std::unordered_map<std::string, uint16_t> ids;
+};
+
+// Times the enclosing block. A null profiler makes it a no-op.
+class ProfileScope {
+public:
+    ProfileScope(TickProfiler* profiler, uint16_t name)
+        : profiler(profiler && profiler->Enabled() ? profiler : nullptr), name(name),
+          start(this->profiler ? TickProfiler::NowNs() : 0) {}
+    // The name is only looked up while profiling is on.
+    ProfileScope(TickProfiler* profiler, ProfileNames& names, const std::string& name)
+        : ProfileScope(profiler, profiler && profiler->Enabled() ? names.Get(*profiler, name) : (uint16_t)0) {}
+    ~ProfileScope() {
+        if (profiler) profiler->Record(name, start, TickProfiler::NowNs());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    TickProfiler* profiler;
+    uint16_t name;
+    int64_t start;
+};
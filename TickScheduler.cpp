@@ -0,0 +1,77 @@
+#include "TickScheduler.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment (lib, "Winmm.lib")
+#endif
+
+TickScheduler::TickScheduler(int ticksPerSecond, int maxCatchUp)
+    : ticksPerSecond(std::max(1, ticksPerSecond)), maxCatchUp(std::max(1, maxCatchUp)) {
+    stepSeconds = 1.0f / (float)this->ticksPerSecond;
+    step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / this->ticksPerSecond));
+    nextTick = Clock::now();
+    nextStatsLog = nextTick + std::chrono::seconds(60);
+
+#ifdef _WIN32
+    // The default Windows timer resolution is ~15.6 ms, half a tick at 30 Hz.
+    timeBeginPeriod(1);
+#endif
+}
+
+TickScheduler::~TickScheduler() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+int TickScheduler::DueTicks() {
+    Clock::time_point now = Clock::now();
+    if (now < nextTick) return 0;
+
+    int due = 1 + (int)((now - nextTick) / step);
+    if (due > maxCatchUp) {
+        // Too far behind to catch up: run the cap and let the rest of the backlog go.
+        stats.droppedTicks += (uint64_t)(due - maxCatchUp);
+        nextTick += step * (due - maxCatchUp);
+        due = maxCatchUp;
+    }
+    stats.catchUpTicks += (uint64_t)(due - 1);
+    return due;
+}
+
+void TickScheduler::BeginTick() {
+    tickStart = Clock::now();
+    nextTick += step;
+}
+
+void TickScheduler::EndTick() {
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - tickStart).count();
+    stats.ticks++;
+    stats.totalTickMs += ms;
+    stats.worstTickMs = std::max(stats.worstTickMs, ms);
+    if (ms > stepSeconds * 1000.0) {
+        stats.overruns++;
+    }
+}
+
+void TickScheduler::WaitForNextTick() {
+    if (Clock::now() < nextTick) {
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void TickScheduler::LogStatsIfDue() {
+    Clock::time_point now = Clock::now();
+    if (now < nextStatsLog) return;
+    nextStatsLog = now + std::chrono::seconds(60);
+
+    double mean = stats.ticks > 0 ? stats.totalTickMs / (double)stats.ticks : 0.0;
+    printf("[Tick] %d Hz: %llu ticks, mean %.2f ms, worst %.2f ms, %llu overruns, %llu caught up, %llu dropped\n",
+        ticksPerSecond, (unsigned long long)stats.ticks, mean, stats.worstTickMs,
+        (unsigned long long)stats.overruns, (unsigned long long)stats.catchUpTicks, (unsigned long long)stats.droppedTicks);
+    stats = Stats();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class TickScheduler
+ * @brief Fixed-timestep clock for the game loop, on std::chrono::steady_clock.
+ *
+ * Every tick advances the world by exactly StepSeconds(). Real elapsed time is
+ * measured each frame. If a tick overran, the ticks that are due run back to
+ * back, so timers (BusyComponent, respawns, saves) keep pace with the wall
+ * clock. Catch-up is capped at maxCatchUp ticks per frame; time beyond that is
+ * dropped and counted, rather than letting a long stall snowball.
+ *
+ *   while (running) {
+ *       int ticks = scheduler.DueTicks();
+ *       for (int i = 0; i < ticks; i++) { scheduler.BeginTick(); ... ; scheduler.EndTick(); }
+ *       scheduler.WaitForNextTick();
+ *   }
+ */
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t ticks = 0;
+        uint64_t overruns = 0;        // Ticks whose work took longer than one step
+        uint64_t catchUpTicks = 0;    // Ticks run late, back to back, to make up time
+        uint64_t droppedTicks = 0;    // Steps skipped because catch-up was capped
+        double worstTickMs = 0.0;
+        double totalTickMs = 0.0;
+    };
+
+    explicit TickScheduler(int ticksPerSecond = 30, int maxCatchUp = 5);
+    ~TickScheduler();
+
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    float StepSeconds() const { return stepSeconds; }
+    int TicksPerSecond() const { return ticksPerSecond; }
+
+    // How many ticks are due now, from the real time elapsed (0 if the next isn't yet).
+    int DueTicks();
+    // Bracket the work of one tick so its duration and overruns are measured.
+    void BeginTick();
+    void EndTick();
+    // Sleeps until the next tick is due; returns at once if it already is.
+    void WaitForNextTick();
+
+    const Stats& GetStats() const { return stats; }
+    // Prints a [Tick] line and resets the counters once a minute.
+    void LogStatsIfDue();
+
+private:
+    int ticksPerSecond;
+    int maxCatchUp;
+    float stepSeconds;
+    Clock::duration step;
+    Clock::time_point nextTick;       // When the next step is due
+    Clock::time_point tickStart;
+    Clock::time_point nextStatsLog;
+    Stats stats;
+};
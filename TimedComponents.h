@@ -0,0 +1,35 @@
+#pragma once
+#include "Registry.h"
+#include "TimerWheel.h"
+
+// Helpers for components that only exist for a while (busy, scheduled events).
+// The component keeps its 'TimerHandle timer' so the countdown can be re-armed
+// or cancelled. The wheel removes the component when the timer fires.
+
+template<typename T>
+void RemoveTimedComponent(void* context, int entity, TimerHandle handle) {
+    Registry& registry = *static_cast<Registry*>(context);
+    T* component = registry.GetComponent<T>(entity);
+    // Destroyed or re-armed since: the handle no longer matches
+    if (component && component->timer == handle) {
+        registry.RemoveComponent<T>(entity);
+    }
+}
+
+/**
+ * @brief Adds (or replaces) a component that removes itself after 'seconds'.
+ * A component already present is overwritten and its old timer cancelled.
+ */
+template<typename T>
+T& AddTimedComponent(Registry& registry, TimerWheel& timers, EntityID entity, float seconds, T component) {
+    T* target = registry.GetComponent<T>(entity);
+    if (target) {
+        timers.Cancel(target->timer);
+        *target = std::move(component);
+    }
+    else {
+        target = &registry.AddComponent<T>(entity, std::move(component));
+    }
+    target->timer = timers.Schedule(TimerWheel::SecondsToMs(seconds), &RemoveTimedComponent<T>, &registry, entity);
+    return *target;
+}
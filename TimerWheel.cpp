@@ -0,0 +1,209 @@
+#include "TimerWheel.h"
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int LowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+TimerWheel::TimerWheel() {
+    for (int i = 0; i < LEVELS * SLOTS; i++) {
+        heads[i] = NONE;
+        tails[i] = NONE;
+    }
+}
+
+uint64_t TimerWheel::SecondsToMs(double seconds) {
+    if (seconds <= 0.0) return 0;
+    return (uint64_t)std::llround(seconds * 1000.0);
+}
+
+TimerHandle TimerWheel::Schedule(uint64_t delayMs, Callback callback, void* context, int entity) {
+    uint32_t index;
+    if (!freeNodes.empty()) {
+        index = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        index = (uint32_t)nodes.size();
+        nodes.emplace_back();
+    }
+
+    Node& node = nodes[index];
+    node.expiry = current + (delayMs > 0 ? delayMs : 1);
+    node.callback = callback;
+    node.context = context;
+    node.entity = entity;
+    Insert(index);
+    stats.scheduled++;
+    return TimerHandle{ index, node.generation };
+}
+
+const TimerWheel::Node* TimerWheel::Find(TimerHandle handle) const {
+    if (!handle.IsValid() || handle.index >= nodes.size()) return nullptr;
+    const Node& node = nodes[handle.index];
+    if (node.generation != handle.generation || node.slot == NONE) return nullptr;
+    return &node;
+}
+
+bool TimerWheel::Cancel(TimerHandle& handle) {
+    const Node* node = Find(handle);
+    TimerHandle cancelled = handle;
+    handle = TimerHandle();
+    if (!node) return false;
+
+    if (node->slot != FIRING) Unlink(cancelled.index);
+    Free(cancelled.index);
+    stats.cancelled++;
+    return true;
+}
+
+bool TimerWheel::IsPending(TimerHandle handle) const {
+    return Find(handle) != nullptr;
+}
+
+uint64_t TimerWheel::RemainingMs(TimerHandle handle) const {
+    const Node* node = Find(handle);
+    if (!node || node->expiry <= current) return 0;
+    return node->expiry - current;
+}
+
+void TimerWheel::Insert(uint32_t index) {
+    Node& node = nodes[index];
+    uint64_t delta = node.expiry - current;
+
+    int level = 0;
+    uint64_t expiry = node.expiry;
+    while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    if (delta >= (1ull << (SLOT_BITS * LEVELS))) {
+        // Beyond the wheel: park at the far edge, re-filed when that slot comes up
+        expiry = current + (1ull << (SLOT_BITS * LEVELS)) - 1;
+    }
+
+    int slot = level * SLOTS + (int)((expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+    node.slot = slot;
+    node.next = NONE;
+    node.prev = tails[slot];
+    if (tails[slot] != NONE) nodes[tails[slot]].next = (int32_t)index;
+    else heads[slot] = (int32_t)index;
+    tails[slot] = (int32_t)index;
+    occupied[level] |= 1ull << (slot & SLOT_MASK);
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+    Node& node = nodes[index];
+    int slot = node.slot;
+    if (node.prev != NONE) nodes[node.prev].next = node.next;
+    else heads[slot] = node.next;
+    if (node.next != NONE) nodes[node.next].prev = node.prev;
+    else tails[slot] = node.prev;
+    if (heads[slot] == NONE) {
+        occupied[slot / SLOTS] &= ~(1ull << (slot & SLOT_MASK));
+    }
+    node.prev = node.next = NONE;
+}
+
+void TimerWheel::Free(uint32_t index) {
+    Node& node = nodes[index];
+    node.slot = NONE;
+    node.callback = nullptr;
+    node.context = nullptr;
+    if (++node.generation == 0) node.generation = 1;
+    freeNodes.push_back(index);
+}
+
+void TimerWheel::TakeSlot(int slot, std::vector<uint32_t>& out) {
+    for (int32_t index = heads[slot]; index != NONE;) {
+        int32_t next = nodes[index].next;
+        nodes[index].prev = nodes[index].next = NONE;
+        nodes[index].slot = FIRING;
+        out.push_back((uint32_t)index);
+        index = next;
+    }
+    heads[slot] = tails[slot] = NONE;
+    occupied[slot / SLOTS] &= ~(1ull << (slot & SLOT_MASK));
+}
+
+void TimerWheel::Cascade() {
+    // 'current' just crossed a level-0 boundary. Coarser levels whose own
+    // index also wrapped are emptied first, since they may refill the finer ones.
+    int top = 1;
+    while (top < LEVELS - 1 && ((current >> (SLOT_BITS * top)) & SLOT_MASK) == 0) {
+        top++;
+    }
+    for (int level = top; level >= 1; level--) {
+        int slot = level * SLOTS + (int)((current >> (SLOT_BITS * level)) & SLOT_MASK);
+        if (heads[slot] == NONE) continue;
+        scratch.clear();
+        TakeSlot(slot, scratch);
+        for (uint32_t index : scratch) {
+            Insert(index);
+        }
+        stats.cascaded += scratch.size();
+    }
+}
+
+uint64_t TimerWheel::NextEventTime() const {
+    // Earliest time a slot on any level comes up holding timers: either they
+    // fire (level 0) or they move down a level. Nothing happens in between.
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < LEVELS; level++) {
+        if (!occupied[level]) continue;
+        int shift = SLOT_BITS * level;
+        uint64_t block = current >> shift;
+        // Rotate so the slot after the current one is bit 0
+        unsigned from = (unsigned)((block + 1) & SLOT_MASK);
+        uint64_t rotated = from ? (occupied[level] >> from) | (occupied[level] << (SLOTS - from)) : occupied[level];
+        uint64_t at = (block + 1 + LowestBit(rotated)) << shift;
+        if (at < next) next = at;
+    }
+    return next;
+}
+
+size_t TimerWheel::Advance(uint64_t nowMs) {
+    size_t fired = 0;
+    std::vector<uint32_t> due;
+
+    while (current < nowMs) {
+        uint64_t next = NextEventTime();
+        if (next > nowMs) {
+            current = nowMs;
+            break;
+        }
+
+        current = next;
+        if ((current & SLOT_MASK) == 0) {
+            Cascade();
+        }
+
+        int slot = (int)(current & SLOT_MASK);
+        if (heads[slot] == NONE) continue;
+
+        due.clear();
+        TakeSlot(slot, due);
+        for (uint32_t index : due) {
+            Node& node = nodes[index];
+            // A callback earlier in this batch may have cancelled it
+            if (node.slot != FIRING) continue;
+            TimerHandle handle{ index, node.generation };
+            Callback callback = node.callback;
+            void* context = node.context;
+            int entity = node.entity;
+            Free(index);
+            stats.fired++;
+            fired++;
+            callback(context, entity, handle);
+        }
+    }
+    return fired;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cancellable reference to a pending timer. Stale once the timer fires or is
+// cancelled, even if its slot is reused.
+struct TimerHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;    // 0 = no timer
+
+    bool IsValid() const { return generation != 0; }
+    bool operator==(const TimerHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const TimerHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel for every countdown in the game, at 1 ms resolution.
+ *
+ * Five levels of 64 slots each cover about 12 days; longer timers are parked
+ * in the top level and re-filed when it comes round. A timer is filed in the
+ * finest level that can hold it and moves down a level each time its slot
+ * comes up, so it is touched at most once per level. Advance uses per-level
+ * occupancy bitmaps to jump straight to the next slot that holds timers. Per
+ * tick, the wheel costs as much as the timers that actually fall due, however
+ * many are pending.
+ *
+ * Callbacks are a function pointer plus context and entity, so scheduling
+ * never allocates. They may schedule and cancel timers themselves. Game thread only.
+ */
+class TimerWheel {
+public:
+    using Callback = void (*)(void* context, int entity, TimerHandle handle);
+
+    struct Stats {
+        uint64_t scheduled = 0;
+        uint64_t fired = 0;
+        uint64_t cancelled = 0;
+        uint64_t cascaded = 0;      // Timers moved down a level
+    };
+
+    TimerWheel();
+
+    // Fires 'delayMs' after Now(), on the first Advance at or past that time (at least 1 ms later).
+    TimerHandle Schedule(uint64_t delayMs, Callback callback, void* context, int entity);
+    // Returns false if the timer already fired or was cancelled. Clears the handle either way.
+    bool Cancel(TimerHandle& handle);
+    bool IsPending(TimerHandle handle) const;
+    uint64_t RemainingMs(TimerHandle handle) const;
+
+    // Fires every timer due at or before nowMs, earliest first. Returns how many fired.
+    size_t Advance(uint64_t nowMs);
+    uint64_t Now() const { return current; }
+    size_t Pending() const { return nodes.size() - freeNodes.size(); }
+    const Stats& GetStats() const { return stats; }
+
+    static uint64_t SecondsToMs(double seconds);
+
+private:
+    static const int LEVELS = 5;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const uint32_t SLOT_MASK = SLOTS - 1;
+    static const int32_t NONE = -1;
+    static const int32_t FIRING = -2;   // Taken off the wheel by Advance, not yet run
+
+    struct Node {
+        uint64_t expiry = 0;
+        Callback callback = nullptr;
+        void* context = nullptr;
+        int entity = -1;
+        uint32_t generation = 1;
+        int32_t slot = NONE;            // level * SLOTS + index, NONE when free
+        int32_t prev = NONE;
+        int32_t next = NONE;
+    };
+
+    const Node* Find(TimerHandle handle) const;
+    void Insert(uint32_t index);
+    void Unlink(uint32_t index);
+    void Free(uint32_t index);
+    // Takes every timer out of a slot, in the order they were filed.
+    void TakeSlot(int slot, std::vector<uint32_t>& out);
+    void Cascade();
+    uint64_t NextEventTime() const;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    int32_t heads[LEVELS * SLOTS];
+    int32_t tails[LEVELS * SLOTS];
+    uint64_t occupied[LEVELS] = {};     // Bit per non-empty slot
+    uint64_t current = 0;               // Every timer due at or before this has fired
+    std::vector<uint32_t> scratch;
+    Stats stats;
+};
@@ -4,12 +4,13 @@
 class UpdateSystem
 {
 	GameContext& ctx;
-	float timeElapsed = 0;
+
 public:
 	UpdateSystem(GameContext& ctx);
 	~UpdateSystem();
-	void Run();
-	void Update(float dt);
+	// Advances the timer wheel to the current game time. Busy, scheduled events,
+	// windups and respawns all fire from here, and only when they are due.
+	void Update();
 
 private:
 
@@ -0,0 +1,522 @@
+#include "WebSocketProtocol.h"
+#include <zlib.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const uint8_t OP_CONTINUATION = 0x0;
+    const uint8_t OP_TEXT = 0x1;
+    const uint8_t OP_BINARY = 0x2;
+    const uint8_t OP_CLOSE = 0x8;
+    const uint8_t OP_PING = 0x9;
+    const uint8_t OP_PONG = 0xA;
+
+    const uint16_t CLOSE_PROTOCOL_ERROR = 1002;
+    const uint16_t CLOSE_INVALID_DATA = 1007;
+    const uint16_t CLOSE_TOO_BIG = 1009;
+
+    const char* ACCEPT_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    // RFC 3629: no overlong forms, no surrogates, nothing past U+10FFFF.
+    bool IsValidUtf8(const std::string& text) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+        const unsigned char* end = p + text.size();
+        while (p < end) {
+            unsigned char lead = *p++;
+            if (lead < 0x80) continue;
+
+            int extra;
+            unsigned char min = 0x80, max = 0xBF;   // Allowed range of the first continuation byte
+            if (lead >= 0xC2 && lead <= 0xDF) extra = 1;
+            else if (lead >= 0xE0 && lead <= 0xEF) {
+                extra = 2;
+                if (lead == 0xE0) min = 0xA0;        // Overlong
+                if (lead == 0xED) max = 0x9F;        // Surrogates
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4) {
+                extra = 3;
+                if (lead == 0xF0) min = 0x90;        // Overlong
+                if (lead == 0xF4) max = 0x8F;        // Past U+10FFFF
+            }
+            else return false;
+
+            if (end - p < extra) return false;
+            if (*p < min || *p > max) return false;
+            for (int i = 1; i < extra; i++) {
+                if ((p[i] & 0xC0) != 0x80) return false;
+            }
+            p += extra;
+        }
+        return true;
+    }
+
+    // SHA-1 is only needed for Sec-WebSocket-Accept, so a small local one saves
+    // pulling in a crypto library.
+    void Sha1(const std::string& input, unsigned char digest[20]) {
+        uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+        std::string data = input;
+        uint64_t bitLength = static_cast<uint64_t>(input.size()) * 8;
+        data.push_back(static_cast<char>(0x80));
+        while (data.size() % 64 != 56) data.push_back('\0');
+        for (int i = 7; i >= 0; i--) data.push_back(static_cast<char>((bitLength >> (i * 8)) & 0xFF));
+
+        auto rotl = [](uint32_t v, int n) { return (v << n) | (v >> (32 - n)); };
+        for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; i++) {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(&data[chunk + i * 4]);
+                w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+            }
+            for (int i = 16; i < 80; i++) w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; i++) {
+                uint32_t f, k;
+                if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+                else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+                else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+                else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+                uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+                e = d; d = c; c = rotl(b, 30); b = a; a = temp;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+
+        for (int i = 0; i < 5; i++) {
+            digest[i * 4] = static_cast<unsigned char>(h[i] >> 24);
+            digest[i * 4 + 1] = static_cast<unsigned char>(h[i] >> 16);
+            digest[i * 4 + 2] = static_cast<unsigned char>(h[i] >> 8);
+            digest[i * 4 + 3] = static_cast<unsigned char>(h[i]);
+        }
+    }
+
+    std::string Base64(const unsigned char* data, size_t length) {
+        static const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t n = uint32_t(data[i]) << 16;
+            if (i + 1 < length) n |= uint32_t(data[i + 1]) << 8;
+            if (i + 2 < length) n |= uint32_t(data[i + 2]);
+            out.push_back(table[(n >> 18) & 63]);
+            out.push_back(table[(n >> 12) & 63]);
+            out.push_back(i + 1 < length ? table[(n >> 6) & 63] : '=');
+            out.push_back(i + 2 < length ? table[n & 63] : '=');
+        }
+        return out;
+    }
+
+    std::string Trim(const std::string& s) {
+        size_t start = s.find_first_not_of(" \t");
+        if (start == std::string::npos) return "";
+        size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(start, end - start + 1);
+    }
+
+    std::string Lower(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return s;
+    }
+
+    // Splits on 'separator' and trims each piece.
+    std::vector<std::string> SplitList(const std::string& s, char separator) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (start <= s.size()) {
+            size_t end = s.find(separator, start);
+            if (end == std::string::npos) end = s.size();
+            parts.push_back(Trim(s.substr(start, end - start)));
+            start = end + 1;
+        }
+        return parts;
+    }
+}
+
+WebSocketSession::WebSocketSession(const WebSocketConfig& config) : config(config) {
+}
+
+WebSocketSession::~WebSocketSession() {
+    if (inflater) {
+        inflateEnd(inflater);
+        delete inflater;
+    }
+}
+
+bool WebSocketSession::Decode(const char* data, size_t length, std::string& text, std::string& replies) {
+    if (state == State::Closed) return false;
+
+    pending.append(data, length);
+
+    if (state == State::Handshake) {
+        size_t end = pending.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            if (pending.size() > MAX_HANDSHAKE) {
+                replies += "HTTP/1.1 431 Request Header Fields Too Large\r\nConnection: close\r\n\r\n";
+                state = State::Closed;
+                return false;
+            }
+            return true;
+        }
+        if (!HandleHandshake(replies)) {
+            state = State::Closed;
+            return false;
+        }
+        pending.erase(0, end + 4);
+    }
+
+    return DecodeFrames(text, replies);
+}
+
+bool WebSocketSession::HandleHandshake(std::string& replies) {
+    size_t end = pending.find("\r\n\r\n");
+    std::vector<std::string> lines = SplitList(pending.substr(0, end), '\n');
+
+    bool isGet = !lines.empty() && lines[0].rfind("GET ", 0) == 0;
+    std::string key, version, extensions, upgrade, connection;
+    for (size_t i = 1; i < lines.size(); i++) {
+        size_t colon = lines[i].find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = Lower(Trim(lines[i].substr(0, colon)));
+        std::string value = Trim(lines[i].substr(colon + 1));
+
+        if (name == "sec-websocket-key") key = value;
+        else if (name == "sec-websocket-version") version = value;
+        else if (name == "upgrade") upgrade = Lower(value);
+        else if (name == "connection") connection = Lower(value);
+        else if (name == "sec-websocket-extensions") {
+            // Several headers are equivalent to one comma-separated list
+            if (!extensions.empty()) extensions += ", ";
+            extensions += value;
+        }
+    }
+
+    if (!isGet || key.empty() || upgrade.find("websocket") == std::string::npos
+        || connection.find("upgrade") == std::string::npos) {
+        replies += "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n";
+        return false;
+    }
+    if (version != "13") {
+        replies += "HTTP/1.1 426 Upgrade Required\r\nSec-WebSocket-Version: 13\r\nConnection: close\r\n\r\n";
+        return false;
+    }
+
+    unsigned char digest[20];
+    Sha1(key + ACCEPT_GUID, digest);
+
+    replies += "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: " + Base64(digest, sizeof(digest)) + "\r\n";
+
+    std::string deflateResponse;
+    if (config.enableDeflate && !extensions.empty() && NegotiateDeflate(extensions, deflateResponse)) {
+        replies += "Sec-WebSocket-Extensions: " + deflateResponse + "\r\n";
+    }
+    replies += "\r\n";
+
+    state = State::Open;
+    return true;
+}
+
+bool WebSocketSession::NegotiateDeflate(const std::string& offers, std::string& response) {
+    // Take the first permessage-deflate offer whose parameters we can honour.
+    for (const std::string& offer : SplitList(offers, ',')) {
+        std::vector<std::string> params = SplitList(offer, ';');
+        if (params.empty() || Lower(params[0]) != "permessage-deflate") continue;
+
+        bool serverNoTakeover = false;
+        bool clientWindowOffered = false;
+        int serverMaxWindow = 15;
+        int clientMaxWindow = 15;
+        bool usable = true;
+
+        for (size_t i = 1; i < params.size() && usable; i++) {
+            std::string name = Lower(params[i]);
+            std::string value;
+            size_t eq = name.find('=');
+            if (eq != std::string::npos) {
+                value = Trim(params[i].substr(eq + 1));
+                value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
+                name = Trim(name.substr(0, eq));
+            }
+
+            if (name == "server_no_context_takeover") serverNoTakeover = true;
+            else if (name == "client_no_context_takeover") {}  // The client resets; inflate copes either way
+            else if (name == "server_max_window_bits") {
+                serverMaxWindow = std::atoi(value.c_str());
+                // zlib can't produce a raw 8-bit window
+                usable = serverMaxWindow >= 9 && serverMaxWindow <= 15;
+            }
+            else if (name == "client_max_window_bits") {
+                clientWindowOffered = true;
+                if (!value.empty()) clientMaxWindow = std::atoi(value.c_str());
+                usable = clientMaxWindow >= 8 && clientMaxWindow <= 15;
+            }
+            else usable = false;
+        }
+        if (!usable) continue;
+
+        if (!compressor.Init(config.compressionLevel, config.compressionMemory, true, serverMaxWindow)) {
+            return false;
+        }
+
+        // Receiving needs a 1 << windowBits inflate window. If the client lets us
+        // choose, hold it to the same size as our own window.
+        int inflateWindow = 15;
+        if (clientWindowOffered) {
+            inflateWindow = std::min(clientMaxWindow, compressor.WindowBits());
+        }
+        inflater = new z_stream();
+        if (inflateInit2(inflater, -inflateWindow) != Z_OK) {
+            delete inflater;
+            inflater = nullptr;
+            std::string discarded;
+            compressor.Finish(discarded);
+            return false;
+        }
+
+        serverNoContextTakeover = serverNoTakeover;
+        response = "permessage-deflate";
+        if (serverNoTakeover) response += "; server_no_context_takeover";
+        response += "; server_max_window_bits=" + std::to_string(compressor.WindowBits());
+        if (clientWindowOffered) response += "; client_max_window_bits=" + std::to_string(inflateWindow);
+        return true;
+    }
+    return false;
+}
+
+bool WebSocketSession::DecodeFrames(std::string& text, std::string& replies) {
+    size_t offset = 0;
+
+    while (state == State::Open) {
+        size_t available = pending.size() - offset;
+        if (available < 2) break;
+
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(pending.data() + offset);
+        bool fin = (p[0] & 0x80) != 0;
+        bool rsv1 = (p[0] & 0x40) != 0;
+        uint8_t opcode = p[0] & 0x0F;
+        bool masked = (p[1] & 0x80) != 0;
+        uint64_t payloadLength = p[1] & 0x7F;
+
+        size_t headerLength = 2;
+        if (payloadLength == 126) {
+            if (available < 4) break;
+            payloadLength = (uint64_t(p[2]) << 8) | p[3];
+            headerLength = 4;
+        }
+        else if (payloadLength == 127) {
+            if (available < 10) break;
+            payloadLength = 0;
+            for (int i = 0; i < 8; i++) payloadLength = (payloadLength << 8) | p[2 + i];
+            headerLength = 10;
+        }
+
+        // Clients must mask; RSV2/3 and RSV1 without the extension are errors.
+        if (!masked || (p[0] & 0x30) != 0 || (rsv1 && !inflater)) {
+            return Fail(CLOSE_PROTOCOL_ERROR, replies);
+        }
+        if (payloadLength > config.maxMessageSize) {
+            return Fail(CLOSE_TOO_BIG, replies);
+        }
+        if (available < headerLength + 4 + payloadLength) break;
+
+        const unsigned char* mask = p + headerLength;
+        char* payload = &pending[offset + headerLength + 4];
+        for (uint64_t i = 0; i < payloadLength; i++) {
+            payload[i] ^= mask[i & 3];
+        }
+        offset += headerLength + 4 + static_cast<size_t>(payloadLength);
+
+        if (opcode >= OP_CLOSE) {
+            // Control frames: never fragmented, at most 125 bytes, may arrive mid-message.
+            if (!fin || payloadLength > 125) return Fail(CLOSE_PROTOCOL_ERROR, replies);
+
+            if (opcode == OP_PING) {
+                AppendControl(replies, OP_PONG, payload, static_cast<size_t>(payloadLength));
+            }
+            else if (opcode == OP_CLOSE) {
+                // Echo the status code and close once it has been sent.
+                AppendControl(replies, OP_CLOSE, payload, payloadLength >= 2 ? 2 : 0);
+                state = State::Closed;
+                pending.clear();
+                return false;
+            }
+            else if (opcode != OP_PONG) {
+                return Fail(CLOSE_PROTOCOL_ERROR, replies);
+            }
+            continue;
+        }
+
+        if (opcode == OP_TEXT || opcode == OP_BINARY) {
+            if (inMessage) return Fail(CLOSE_PROTOCOL_ERROR, replies);
+            inMessage = true;
+            messageCompressed = rsv1;
+            messageBinary = opcode == OP_BINARY;
+            message.clear();
+        }
+        else if (opcode != OP_CONTINUATION || !inMessage || rsv1) {
+            return Fail(CLOSE_PROTOCOL_ERROR, replies);
+        }
+
+        if (message.size() + payloadLength > config.maxMessageSize) {
+            return Fail(CLOSE_TOO_BIG, replies);
+        }
+        message.append(payload, static_cast<size_t>(payloadLength));
+
+        if (fin) {
+            inMessage = false;
+            if (!DeliverMessage(text)) return Fail(CLOSE_INVALID_DATA, replies);
+        }
+    }
+
+    pending.erase(0, offset);
+    return state != State::Closed;
+}
+
+bool WebSocketSession::DeliverMessage(std::string& text) {
+    WireFormat format = binaryFormat.load(std::memory_order_relaxed);
+    if (messageBinary && format != WireFormat::Json) {
+        std::string payload;
+        if (messageCompressed) {
+            if (!Inflate(payload)) return false;
+        }
+        else {
+            payload.swap(message);
+        }
+        return DecodeCommand(format, payload, text);
+    }
+
+    std::string line;
+    if (!messageCompressed) {
+        line.swap(message);
+    }
+    else if (!Inflate(line)) {
+        return false;
+    }
+    // RFC 6455 8.1: a text message that isn't UTF-8 fails the connection (1007)
+    if (!messageBinary && !IsValidUtf8(line)) return false;
+
+    // One message is one command: a trailing line break is dropped and any
+    // inside the message become spaces, so it can't split into several lines.
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+    std::replace(line.begin(), line.end(), '\n', ' ');
+    std::replace(line.begin(), line.end(), '\r', ' ');
+    text += line;
+    text.push_back('\n');
+    return true;
+}
+
+bool WebSocketSession::Inflate(std::string& out) {
+    // RFC 7692: the sender stripped the final empty stored block; put it back.
+    message.append("\x00\x00\xff\xff", 4);
+    inflater->next_in = reinterpret_cast<Bytef*>(&message[0]);
+    inflater->avail_in = static_cast<uInt>(message.size());
+
+    size_t start = out.size();
+    do {
+        size_t before = out.size();
+        if (before - start >= config.maxMessageSize) return false;  // Inflation bomb
+        out.resize(before + 4096);
+        inflater->next_out = reinterpret_cast<Bytef*>(&out[before]);
+        inflater->avail_out = 4096;
+        int result = inflate(inflater, Z_SYNC_FLUSH);
+        out.resize(before + (4096 - inflater->avail_out));
+        if (result == Z_STREAM_END) {
+            inflateReset(inflater);  // The client ended its stream (BFINAL); the next message starts a new one
+        }
+        else if (result != Z_OK && result != Z_BUF_ERROR) {
+            return false;
+        }
+    } while (inflater->avail_out == 0);
+    return true;
+}
+
+bool WebSocketSession::DecodeCommand(WireFormat format, const std::string& payload, std::string& text) {
+    // A binary command is an array of strings, verb first: ["say", "hello", "there"].
+    // A single string is taken as the whole line.
+    nlohmann::json command = (format == WireFormat::Cbor)
+        ? nlohmann::json::from_cbor(payload, true, false)
+        : nlohmann::json::from_msgpack(payload, true, false);
+    if (command.is_discarded()) return false;
+
+    std::string line;
+    if (command.is_string()) {
+        line = command.get<std::string>();
+    }
+    else if (command.is_array()) {
+        for (const auto& word : command) {
+            if (!word.is_string()) return false;
+            if (!line.empty()) line.push_back(' ');
+            line += word.get<std::string>();
+        }
+    }
+    else {
+        return false;
+    }
+
+    // One message is one line; embedded line breaks must not split it.
+    std::replace(line.begin(), line.end(), '\n', ' ');
+    std::replace(line.begin(), line.end(), '\r', ' ');
+    text += line;
+    text.push_back('\n');
+    return true;
+}
+
+bool WebSocketSession::Fail(uint16_t code, std::string& replies) {
+    char status[2] = { static_cast<char>(code >> 8), static_cast<char>(code & 0xFF) };
+    AppendControl(replies, OP_CLOSE, status, sizeof(status));
+    printf("WebSocket closing with status %u\n", code);
+    state = State::Closed;
+    pending.clear();
+    return false;
+}
+
+void WebSocketSession::AppendControl(std::string& out, uint8_t opcode, const char* payload, size_t length) {
+    out.push_back(static_cast<char>(0x80 | opcode));
+    out.push_back(static_cast<char>(length));
+    out.append(payload, length);
+}
+
+size_t WebSocketSession::WriteHeader(char* out, size_t length, bool compressed, bool binary) {
+    out[0] = static_cast<char>(0x80 | (compressed ? 0x40 : 0) | (binary ? OP_BINARY : OP_TEXT));
+    if (length < 126) {
+        out[1] = static_cast<char>(length);
+        return 2;
+    }
+    if (length <= 0xFFFF) {
+        out[1] = 126;
+        out[2] = static_cast<char>(length >> 8);
+        out[3] = static_cast<char>(length & 0xFF);
+        return 4;
+    }
+    out[1] = 127;
+    for (int i = 0; i < 8; i++) {
+        out[2 + i] = static_cast<char>((static_cast<uint64_t>(length) >> ((7 - i) * 8)) & 0xFF);
+    }
+    return 10;
+}
+
+bool WebSocketSession::Deflate(const char* data, size_t length, std::string& frame) {
+    std::string payload;
+    if (!compressor.Compress(data, length, true, payload)) return false;
+
+    // A sync flush always ends in 00 00 FF FF, which the receiver re-adds.
+    if (payload.size() >= 4 && payload.compare(payload.size() - 4, 4, "\x00\x00\xff\xff", 4) == 0) {
+        payload.resize(payload.size() - 4);
+    }
+    if (serverNoContextTakeover) {
+        compressor.Reset();
+    }
+
+    char header[MAX_HEADER];
+    size_t headerLength = WriteHeader(header, payload.size(), true, IsBinaryPayload(data, length));
+    frame.append(header, headerLength);
+    frame += payload;
+    return true;
+}
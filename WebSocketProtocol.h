@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include "DeflateStream.h"
+#include "WireFormat.h"
+
+typedef struct z_stream_s z_stream;
+
+struct WebSocketConfig {
+    bool enableDeflate = true;                // Accept permessage-deflate offers
+    int compressionLevel = 6;
+    size_t compressionMemory = 48 * 1024;     // deflate state budget per connection
+    size_t maxMessageSize = 64 * 1024;        // Reassembled, inflated message cap
+    size_t minCompressSize = 64;              // Smaller messages go out uncompressed
+};
+
+/**
+ * @class WebSocketSession
+ * @brief Server side of RFC 6455 for one connection, with permessage-deflate (RFC 7692).
+ *
+ * Runs on the network thread. Decode takes raw socket bytes:
+ * - it first answers the HTTP upgrade;
+ * - then it unmasks frames, reassembles fragmented messages and inflates
+ *   compressed ones;
+ * - it answers ping and close frames itself.
+ * Each data message comes out as one '\n'-terminated line, so web input goes
+ * through the same LineFramer and flood limits as telnet. Once the client has
+ * picked MessagePack or CBOR, binary messages are decoded into that line here.
+ * Outbound, every queued segment is sent as one message. An uncompressed
+ * message is just a small header segment in front of the shared payload.
+ */
+class WebSocketSession {
+public:
+    explicit WebSocketSession(const WebSocketConfig& config = WebSocketConfig());
+    ~WebSocketSession();
+
+    WebSocketSession(const WebSocketSession&) = delete;
+    WebSocketSession& operator=(const WebSocketSession&) = delete;
+
+    // Appends decoded message text to 'text' and protocol output (the 101
+    // response, pongs, close frames) to 'replies'. Returns false once the
+    // connection should be closed after 'replies' have been sent.
+    bool Decode(const char* data, size_t length, std::string& text, std::string& replies);
+
+    // Game output may only be framed once the handshake is done, and stops after a close.
+    bool IsOpen() const { return state == State::Open; }
+
+    // Game thread, after hello: binary messages are commands in this encoding
+    // from now on. Until then they are read as text.
+    void SetBinaryFormat(WireFormat format) { binaryFormat.store(format, std::memory_order_relaxed); }
+
+    // MessagePack/CBOR envelopes open with a map header in 0x80-0xBF, a byte that
+    // can never start UTF-8 text, so segments need no separate binary flag.
+    static bool IsBinaryPayload(const char* data, size_t length) {
+        return length > 0 && (static_cast<unsigned char>(data[0]) & 0xC0) == 0x80;
+    }
+    // Frame header for a message of 'length' bytes; returns its size.
+    static size_t WriteHeader(char* out, size_t length, bool compressed, bool binary);
+    // True if this message should be compressed; Deflate then appends the whole frame to 'frame'.
+    bool ShouldCompress(size_t length) const { return compressor.IsOpen() && length >= config.minCompressSize; }
+    bool Deflate(const char* data, size_t length, std::string& frame);
+    DeflateStream& Compressor() { return compressor; }
+
+    static const size_t MAX_HEADER = 10;   // Server frames are never masked
+
+private:
+    enum class State { Handshake, Open, Closed };
+
+    bool HandleHandshake(std::string& replies);
+    bool NegotiateDeflate(const std::string& offers, std::string& response);
+    bool DecodeFrames(std::string& text, std::string& replies);
+    bool DeliverMessage(std::string& text);
+    bool Inflate(std::string& out);
+    static bool DecodeCommand(WireFormat format, const std::string& payload, std::string& text);
+    bool Fail(uint16_t code, std::string& replies);
+    static void AppendControl(std::string& out, uint8_t opcode, const char* payload, size_t length);
+
+    static const size_t MAX_HANDSHAKE = 8192;
+
+    WebSocketConfig config;
+    State state = State::Handshake;
+    std::string pending;           // Received bytes not yet parsed
+    std::string message;           // Fragments of the message being reassembled
+    bool inMessage = false;
+    bool messageCompressed = false;
+    bool messageBinary = false;
+    std::atomic<WireFormat> binaryFormat{ WireFormat::Json };
+
+    // permessage-deflate
+    DeflateStream compressor;
+    z_stream* inflater = nullptr;
+    bool serverNoContextTakeover = false;
+};
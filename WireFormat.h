@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// How a web client's structured messages are encoded on the WebSocket. Chosen
+// per connection in the hello handshake; JSON text until then.
+enum class WireFormat : uint8_t {
+    Json,      // Text frames carrying JSON envelopes
+    MsgPack,   // Binary frames, MessagePack
+    Cbor,      // Binary frames, CBOR (RFC 8949)
+    Count
+};
+
+inline WireFormat ParseWireFormat(const std::string& name) {
+    if (name == "msgpack") return WireFormat::MsgPack;
+    if (name == "cbor") return WireFormat::Cbor;
+    return WireFormat::Json;
+}
+
+inline const char* WireFormatName(WireFormat format) {
+    switch (format) {
+    case WireFormat::MsgPack: return "msgpack";
+    case WireFormat::Cbor: return "cbor";
+    default: return "json";
+    }
+}